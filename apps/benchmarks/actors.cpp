@@ -0,0 +1,174 @@
+///Benchmark of the neighbour queries in one update of MWMechanics::Actors, comparing the SpatialGrid that Actors keeps
+///with iterating the whole actor map for each actor, as Actors used to do.
+
+#include <iostream>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include <osg/Timer>
+#include <osg/Vec3f>
+
+#include "apps/openmw/mwmechanics/spatialgrid.hpp"
+
+namespace
+{
+
+    /// Stands in for the LiveCellRef an MWWorld::Ptr points to, which holds the position of the actor.
+    struct DummyRef
+    {
+        osg::Vec3f mPosition;
+        osg::Vec3f mMove;
+    };
+
+    /// Like the PtrActorMap of Actors, ordered by the reference.
+    typedef std::map<DummyRef*, int> ActorMap;
+
+    /// Deterministic pseudo random numbers, so that runs are comparable.
+    class Generator
+    {
+    public:
+        Generator()
+            : mState(12345u)
+        {
+        }
+
+        /// @return A number in [-extent/2, extent/2).
+        float next(float extent)
+        {
+            mState = mState * 1664525u + 1013904223u;
+            return (mState >> 8) / static_cast<float>(1 << 24) * extent - extent / 2;
+        }
+
+    private:
+        unsigned int mState;
+    };
+
+    const float aiProcessingDistance = 7168;
+    const float maxHeadTrackDistance = 400; // fMaxHeadTrackDistance
+
+    void move(ActorMap& actors)
+    {
+        for (ActorMap::iterator it = actors.begin(); it != actors.end(); ++it)
+            it->first->mPosition += it->first->mMove;
+    }
+
+    /// The queries of Actors::update for each actor in AI processing range of the player: the actors to engage in
+    /// combat with, and the actors to track with the head.
+    template <class Query>
+    size_t updateActors(ActorMap& actors, const DummyRef& player, Query& query)
+    {
+        size_t neighbours = 0;
+        std::vector<DummyRef*> out;
+        for (ActorMap::iterator it = actors.begin(); it != actors.end(); ++it)
+        {
+            if ((player.mPosition - it->first->mPosition).length2() > aiProcessingDistance * aiProcessingDistance)
+                continue;
+
+            out.clear();
+            query(it->first->mPosition, aiProcessingDistance, out);
+            neighbours += out.size();
+
+            out.clear();
+            query(it->first->mPosition, maxHeadTrackDistance, out);
+            neighbours += out.size();
+        }
+        return neighbours;
+    }
+
+    struct MapQuery
+    {
+        MapQuery(ActorMap& actors)
+            : mActors(actors)
+        {
+        }
+
+        void operator()(const osg::Vec3f& position, float radius, std::vector<DummyRef*>& out)
+        {
+            for (ActorMap::iterator it = mActors.begin(); it != mActors.end(); ++it)
+                if ((it->first->mPosition - position).length2() <= radius * radius)
+                    out.push_back(it->first);
+        }
+
+        ActorMap& mActors;
+    };
+
+    struct GridQuery
+    {
+        GridQuery()
+            : mGrid(4096.f)
+        {
+        }
+
+        void operator()(const osg::Vec3f& position, float radius, std::vector<DummyRef*>& out)
+        {
+            mGrid.getItemsInRange(position, radius, out);
+        }
+
+        MWMechanics::SpatialGrid<DummyRef*> mGrid;
+    };
+
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int numActors = 250;
+    unsigned int numFrames = 100;
+    if (argc > 1)
+        numActors = std::atoi(argv[1]);
+    if (argc > 2)
+        numFrames = std::atoi(argv[2]);
+
+    // Actors spread over the active grid of 3x3 exterior cells, with the player in the middle
+    Generator generator;
+    std::vector<DummyRef> refs(numActors);
+    for (std::vector<DummyRef>::iterator it = refs.begin(); it != refs.end(); ++it)
+    {
+        it->mPosition = osg::Vec3f(generator.next(3 * 8192.f), generator.next(3 * 8192.f), generator.next(1000.f));
+        it->mMove = osg::Vec3f(generator.next(10.f), generator.next(10.f), 0.f);
+    }
+    DummyRef player;
+
+    ActorMap actors;
+    for (unsigned int i=0; i<refs.size(); ++i)
+        actors[&refs[i]] = i;
+
+    std::vector<DummyRef> initial = refs;
+
+    MapQuery mapQuery(actors);
+    size_t mapNeighbours = 0;
+    osg::Timer timer;
+    for (unsigned int frame=0; frame<numFrames; ++frame)
+    {
+        move(actors);
+        mapNeighbours += updateActors(actors, player, mapQuery);
+    }
+    double mapTime = timer.time_m();
+
+    refs = initial;
+
+    GridQuery gridQuery;
+    size_t gridNeighbours = 0;
+    timer.setStartTick();
+    for (unsigned int frame=0; frame<numFrames; ++frame)
+    {
+        move(actors);
+        // Actors::update brings the grid up to date with all actors each frame
+        for (ActorMap::iterator it = actors.begin(); it != actors.end(); ++it)
+            gridQuery.mGrid.update(it->first, it->first->mPosition);
+        gridNeighbours += updateActors(actors, player, gridQuery);
+    }
+    double gridTime = timer.time_m();
+
+    if (mapNeighbours != gridNeighbours)
+    {
+        std::cerr << "Error: query results differ (actor map: " << mapNeighbours << ", grid: " << gridNeighbours << ")" << std::endl;
+        return 1;
+    }
+
+    std::cout << numActors << " actors, " << numFrames << " frames, " << mapNeighbours / numFrames << " neighbours found per frame" << std::endl;
+    std::cout << "actor map: " << mapTime / numFrames << " ms per frame" << std::endl;
+    std::cout << "grid:      " << gridTime / numFrames << " ms per frame" << std::endl;
+
+    return 0;
+}
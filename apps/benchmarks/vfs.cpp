@@ -0,0 +1,141 @@
+///Benchmark comparing lookups through the VFS::Manager hash index with lookups in the sorted file index.
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <stdexcept>
+#include <algorithm>
+#include <random>
+
+#include <osg/Timer>
+
+#include <components/vfs/manager.hpp>
+#include <components/vfs/archive.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+
+    class DummyFile : public VFS::File
+    {
+    public:
+        virtual Files::IStreamPtr open()
+        {
+            throw std::runtime_error("DummyFile can not be opened");
+        }
+    };
+
+    /// Archive with a synthetic directory layout resembling a large texture and mesh replacer setup.
+    class DummyArchive : public VFS::Archive
+    {
+    public:
+        DummyArchive(unsigned int numFiles)
+        {
+            static const char* directories[] = { "Meshes\\f\\", "Meshes\\x\\", "Meshes\\i\\In_", "Textures\\Tx_", "Textures\\tr\\", "Icons\\m\\" };
+            static const char* extensions[] = { ".nif", ".nif", ".nif", ".dds", ".dds", ".tga" };
+            const unsigned int numDirectories = sizeof(directories) / sizeof(directories[0]);
+
+            for (unsigned int i=0; i<numFiles; ++i)
+            {
+                std::ostringstream stream;
+                stream << directories[i % numDirectories] << "Resource_" << i << extensions[i % numDirectories];
+                mNames.push_back(stream.str());
+            }
+        }
+
+        virtual void listResources(std::map<std::string, VFS::File*>& out, char (*normalize_function) (char))
+        {
+            for (std::vector<std::string>::const_iterator it = mNames.begin(); it != mNames.end(); ++it)
+            {
+                std::string name = *it;
+                std::transform(name.begin(), name.end(), name.begin(), normalize_function);
+                out[name] = &mFile;
+            }
+        }
+
+        const std::vector<std::string>& getNames() const { return mNames; }
+
+    private:
+        std::vector<std::string> mNames;
+        DummyFile mFile;
+    };
+
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int numFiles = 300000;
+    unsigned int numRounds = 10;
+    if (argc > 1)
+        numFiles = std::atoi(argv[1]);
+    if (argc > 2)
+        numRounds = std::atoi(argv[2]);
+
+    DummyArchive* archive = new DummyArchive(numFiles);
+    // Query in random order, like the resource managers do
+    std::vector<std::string> names = archive->getNames();
+    std::mt19937 generator(42);
+    std::shuffle(names.begin(), names.end(), generator);
+
+    VFS::Manager manager(false);
+    manager.addArchive(archive);
+    manager.buildIndex();
+
+    std::vector<std::string> misses;
+    for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        misses.push_back(*it + ".missing");
+
+    const std::map<std::string, VFS::File*>& index = manager.getIndex();
+
+    // The old lookup path: copy and normalize the name, then search the map.
+    unsigned int found = 0;
+    osg::Timer timer;
+    for (unsigned int round=0; round<numRounds; ++round)
+    {
+        for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        {
+            std::string normalized = *it;
+            manager.normalizeFilename(normalized);
+            if (index.find(normalized) != index.end())
+                ++found;
+        }
+        for (std::vector<std::string>::const_iterator it = misses.begin(); it != misses.end(); ++it)
+        {
+            std::string normalized = *it;
+            manager.normalizeFilename(normalized);
+            if (index.find(normalized) != index.end())
+                ++found;
+        }
+    }
+    double mapTime = timer.time_m();
+
+    unsigned int hashFound = 0;
+    timer.setStartTick();
+    for (unsigned int round=0; round<numRounds; ++round)
+    {
+        for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+        {
+            if (manager.exists(it->c_str(), it->size()))
+                ++hashFound;
+        }
+        for (std::vector<std::string>::const_iterator it = misses.begin(); it != misses.end(); ++it)
+        {
+            if (manager.exists(it->c_str(), it->size()))
+                ++hashFound;
+        }
+    }
+    double hashTime = timer.time_m();
+
+    if (found != hashFound || found != names.size() * numRounds)
+    {
+        std::cerr << "Error: lookup results differ (map: " << found << ", hash: " << hashFound << ")" << std::endl;
+        return 1;
+    }
+
+    double numLookups = 2.0 * names.size() * numRounds;
+    std::cout << index.size() << " files, " << numLookups << " lookups (half of them misses)" << std::endl;
+    std::cout << "std::map:   " << mapTime << " ms, " << mapTime * 1000000.0 / numLookups << " ns per lookup" << std::endl;
+    std::cout << "hash index: " << hashTime << " ms, " << hashTime * 1000000.0 / numLookups << " ns per lookup" << std::endl;
+
+    return 0;
+}
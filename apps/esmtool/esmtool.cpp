@@ -283,8 +283,12 @@ void printRaw(ESM::ESMReader &esm)
     while(esm.hasMoreRecs())
     {
         ESM::NAME n = esm.getRecName();
-        std::cout << "Record: " << n.toString() << std::endl;
+        std::cout << "Record: " << n.toString();
         esm.getRecHeader();
+        // Subrecord offsets of compressed records are relative to the decompressed data
+        if (esm.isRecordCompressed())
+            std::cout << " (compressed)";
+        std::cout << std::endl;
         while(esm.hasMoreSubs())
         {
             size_t offs = esm.getFileOffset();
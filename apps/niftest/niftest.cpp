@@ -3,13 +3,18 @@
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <memory>
 
 #include <components/nif/niffile.hpp>
+#include <components/nif/data.hpp>
+#include <components/nifosg/controller.hpp>
 #include <components/files/constrainedfilestream.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/vfs/bsaarchive.hpp>
 #include <components/vfs/filesystemarchive.hpp>
 
+#include <osg/Timer>
+
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
@@ -17,6 +22,86 @@
 namespace bpo = boost::program_options;
 namespace bfs = boost::filesystem;
 
+/// Time the parsing of the files, to measure NIF reading throughput
+bool benchmarkParse = false;
+size_t parsedFiles = 0;
+size_t parsedBytes = 0;
+double parseTime = 0.0;
+size_t parsedRecords = 0;
+size_t arenaAllocations = 0;
+size_t arenaBlocks = 0;
+size_t arenaBytes = 0;
+size_t arenaBlockBytes = 0;
+
+/// Sample all keyframe tracks of the files, to measure the cost of keyframe interpolation
+bool benchmarkKeyframes = false;
+size_t keyframeTracks = 0;
+size_t keyframeSamples = 0;
+double keyframeTime = 0.0;
+
+template <typename Interpolator, typename MapPtr>
+void sampleTrack(const MapPtr& keys, typename Interpolator::ValueT& sink)
+{
+    if (!keys || keys->empty())
+        return;
+
+    // Sample the track like a playing animation does, in small steps from its first to its last key
+    const int steps = 100;
+    Interpolator interpolator(keys);
+    float start = keys->mTimes.front();
+    float length = keys->mTimes.back() - start;
+    for (int i=0; i<=steps; ++i)
+        sink = sink + interpolator.interpKey(start + length * i / steps);
+
+    ++keyframeTracks;
+    keyframeSamples += steps+1;
+}
+
+void sampleKeyframes(const Nif::NIFFile& nif)
+{
+    osg::Timer_t startTick = osg::Timer::instance()->tick();
+    float floatSink = 0.f;
+    osg::Vec3f vec3Sink;
+    osg::Quat quatSink;
+    for (size_t i=0; i<nif.numRecords(); ++i)
+    {
+        const Nif::NiKeyframeData* data = dynamic_cast<const Nif::NiKeyframeData*>(nif.getRecord(i));
+        if (!data)
+            continue;
+        sampleTrack<NifOsg::QuaternionInterpolator>(data->mRotations, quatSink);
+        sampleTrack<NifOsg::FloatInterpolator>(data->mXRotations, floatSink);
+        sampleTrack<NifOsg::FloatInterpolator>(data->mYRotations, floatSink);
+        sampleTrack<NifOsg::FloatInterpolator>(data->mZRotations, floatSink);
+        sampleTrack<NifOsg::Vec3Interpolator>(data->mTranslations, vec3Sink);
+        sampleTrack<NifOsg::FloatInterpolator>(data->mScales, floatSink);
+    }
+    keyframeTime += osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+
+    // Keep the samples from being optimized away
+    if (floatSink == 0.12345f && vec3Sink.x() == 0.12345f && quatSink.x() == 0.12345)
+        std::cout << std::endl;
+}
+
+/// Read a nif file, and time it or sample its keyframes if requested
+void readNIF(Files::IStreamPtr stream, const std::string& name)
+{
+    osg::Timer_t startTick = osg::Timer::instance()->tick();
+    std::unique_ptr<Nif::NIFFile> nif (new Nif::NIFFile(stream, name));
+    if (benchmarkParse)
+    {
+        parseTime += osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+        ++parsedFiles;
+        parsedBytes += nif->getSize();
+        parsedRecords += nif->numRecords();
+        arenaAllocations += nif->getArena().getNumAllocations();
+        arenaBlocks += nif->getArena().getNumBlocks();
+        arenaBytes += nif->getArena().getBytesAllocated();
+        arenaBlockBytes += nif->getArena().getBlockBytes();
+    }
+    if (benchmarkKeyframes)
+        sampleKeyframes(*nif);
+}
+
 ///See if the file has the named extension
 bool hasExtension(std::string filename, std::string  extensionToFind)
 {
@@ -61,7 +146,7 @@ void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
             if(isNIF(name))
             {
             //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(myManager.get(name),archivePath+name);
+                readNIF(myManager.get(name),archivePath+name);
             }
             else if(isBSA(name))
             {
@@ -86,9 +171,16 @@ std::vector<std::string> parseOptions (int argc, char** argv)
         "Usages:\n"
         "  niftool <nif files, BSA files, or directories>\n"
         "      Scan the file or directories for nif errors.\n\n"
+        "  niftool --keyframes <nif files, BSA files, or directories>\n"
+        "      Also sample all keyframe tracks and print the time taken.\n\n"
+        "  niftool --parse <nif files, BSA files, or directories>\n"
+        "      Also print the time taken to parse the files, and the memory allocated for their records\n"
+        "      and the arrays of the records.\n\n"
         "Allowed options");
     desc.add_options()
         ("help,h", "print help message.")
+        ("keyframes", "sample all keyframe tracks of the files and print the time taken.")
+        ("parse", "print the time taken to parse the files, and the memory allocated for their records and arrays.")
         ("input-file", bpo::value< std::vector<std::string> >(), "input file")
         ;
 
@@ -116,6 +208,8 @@ std::vector<std::string> parseOptions (int argc, char** argv)
         std::cout << desc << std::endl;
         exit(1);
     }
+    benchmarkKeyframes = variables.count("keyframes") != 0;
+    benchmarkParse = variables.count("parse") != 0;
     if (variables.count("input-file"))
     {
         return variables["input-file"].as< std::vector<std::string> >();
@@ -139,7 +233,7 @@ int main(int argc, char **argv)
             if(isNIF(name))
             {
                 //std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(Files::openConstrainedFileStream(name.c_str()),name);
+                readNIF(Files::openConstrainedFileStream(name.c_str()),name);
              }
              else if(isBSA(name))
              {
@@ -161,5 +255,14 @@ int main(int argc, char **argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
      }
+
+    if (benchmarkParse)
+        std::cout << "Parsed " << parsedFiles << " files (" << parsedBytes / 1024 << " KB) in " << parseTime << " ms, "
+                  << (parseTime > 0.0 ? parsedBytes / 1024.0 / 1024.0 / (parseTime / 1000.0) : 0.0) << " MB/s" << std::endl
+                  << "Allocated " << parsedRecords << " records and " << arenaAllocations - parsedRecords << " arrays ("
+                  << arenaBytes / 1024 << " KB) in " << arenaBlocks << " blocks (" << arenaBlockBytes / 1024 << " KB)" << std::endl;
+    if (benchmarkKeyframes)
+        std::cout << "Sampled " << keyframeTracks << " keyframe tracks " << keyframeSamples << " times in "
+                  << keyframeTime << " ms" << std::endl;
      return 0;
 }
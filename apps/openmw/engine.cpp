@@ -1,6 +1,7 @@
 #include "engine.hpp"
 
 #include <iomanip>
+#include <sstream>
 
 #include <boost/filesystem/fstream.hpp>
 
@@ -35,6 +36,7 @@
 #include "mwgui/windowmanagerimp.hpp"
 
 #include "mwscript/scriptmanagerimp.hpp"
+#include "mwscript/scriptcache.hpp"
 #include "mwscript/extensions.hpp"
 #include "mwscript/interpretercontext.hpp"
 
@@ -87,6 +89,9 @@ bool OMW::Engine::frame(float frametime)
 
         mEnvironment.setFrameDuration(frametime);
 
+        // Collect the movement that was solved while the last frame was rendered
+        mEnvironment.getWorld()->finishPhysics();
+
         // update input
         mEnvironment.getInputManager()->update(frametime, false);
 
@@ -164,6 +169,9 @@ bool OMW::Engine::frame(float frametime)
         // update GUI
         mEnvironment.getWindowManager()->onFrame(frametime);
 
+        // Solve the queued movement while this frame is rendered
+        mEnvironment.getWorld()->startPhysics();
+
         unsigned int frameNumber = mViewer->getFrameStamp()->getFrameNumber();
         osg::Stats* stats = mViewer->getViewerStats();
         stats->setAttribute(frameNumber, "script_time_begin", osg::Timer::instance()->delta_s(mStartTick, beforeScriptTick));
@@ -182,8 +190,7 @@ bool OMW::Engine::frame(float frametime)
         {
             mResourceSystem->reportStats(frameNumber, stats);
 
-            stats->setAttribute(frameNumber, "WorkQueue", mWorkQueue->getNumItems());
-            stats->setAttribute(frameNumber, "WorkThread", mWorkQueue->getNumActiveThreads());
+            mWorkQueue->reportStats(frameNumber, stats);
         }
 
     }
@@ -202,6 +209,7 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mUseSound (true)
   , mCompileAll (false)
   , mCompileAllDialogue (false)
+  , mRebuildContentCache (false)
   , mWarningsMode (1)
   , mScriptConsoleMode (false)
   , mActivationDistanceOverride(-1)
@@ -445,7 +453,7 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
 
     mVFS.reset(new VFS::Manager(mFSStrict));
 
-    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true);
+    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true, Settings::Manager::getBool("memory map archives", "General"));
 
     mResourceSystem.reset(new Resource::ResourceSystem(mVFS.get()));
     mResourceSystem->getSceneManager()->setUnRefImageDataAfterApply(false); // keep to Off for now to allow better state sharing
@@ -455,6 +463,9 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    if (Settings::Manager::getBool("cache converted meshes", "General"))
+        mResourceSystem->getSceneManager()->setTemplateCache((mCfgMgr.getCachePath() / "meshes").string(),
+            Version::getOpenmwVersionDescription(mResDir.string()), mRebuildContentCache);
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
     if (numThreads <= 0)
@@ -523,9 +534,19 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     }
 
     // Create the world
+    std::string contentCacheFile;
+    if (Settings::Manager::getBool("cache content files", "General"))
+    {
+        // Records are cached after conversion to UTF-8, so each encoding needs its own cache
+        std::ostringstream cacheName;
+        cacheName << "content-" << mEncoding << ".cache";
+        contentCacheFile = (mCfgMgr.getCachePath() / cacheName.str()).string();
+    }
+
     mEnvironment.setWorld( new MWWorld::World (mViewer, rootNode, mResourceSystem.get(), mWorkQueue.get(),
         mFileCollections, mContentFiles, mEncoder, mFallbackMap,
-        mActivationDistanceOverride, mCellName, mStartupScript, mResDir.string(), mCfgMgr.getUserDataPath().string()));
+        mActivationDistanceOverride, mCellName, mStartupScript, mResDir.string(), mCfgMgr.getUserDataPath().string(),
+        contentCacheFile, mRebuildContentCache));
     mEnvironment.getWorld()->setupPlayer();
     input->setPlayer(&mEnvironment.getWorld()->getPlayer());
 
@@ -543,8 +564,21 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
-    mEnvironment.setScriptManager (new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+    MWScript::ScriptManager* scriptManager = new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>());
+    mEnvironment.setScriptManager (scriptManager);
+    scriptManager->setProfileFile((mCfgMgr.getLogPath() / "scriptprofile.csv").string());
+
+    if (Settings::Manager::getBool("cache compiled scripts", "General"))
+    {
+        // Compiled scripts refer to global and member variables by position, which depends on all content files
+        MWScript::ScriptCache* scriptCache = new MWScript::ScriptCache(mCfgMgr.getCachePath() / "scripts.cache",
+            MWWorld::World::findContentFiles(mFileCollections, mContentFiles),
+            Version::getOpenmwVersionDescription(mResDir.string()));
+        if (!mRebuildContentCache)
+            scriptCache->read();
+        scriptManager->setCache(scriptCache);
+    }
 
     // Create game mechanics system
     MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
@@ -743,6 +777,11 @@ void OMW::Engine::setCompileAllDialogue (bool all)
     mCompileAllDialogue = all;
 }
 
+void OMW::Engine::setRebuildContentCache (bool rebuild)
+{
+    mRebuildContentCache = rebuild;
+}
+
 void OMW::Engine::setSoundUsage(bool soundUsage)
 {
     mUseSound = soundUsage;
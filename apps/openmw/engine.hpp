@@ -89,6 +89,7 @@ namespace OMW
             bool mUseSound;
             bool mCompileAll;
             bool mCompileAllDialogue;
+            bool mRebuildContentCache;
             int mWarningsMode;
             std::string mFocusName;
             std::map<std::string,std::string> mFallbackMap;
@@ -178,6 +179,9 @@ namespace OMW
             /// Compile all dialogue scripts at startup?
             void setCompileAllDialogue (bool all);
 
+            /// Ignore the cache of the records in the content files and rebuild it?
+            void setRebuildContentCache (bool rebuild);
+
             /// Font encoding
             void setEncoding(const ToUTF8::FromType& encoding);
 
@@ -96,6 +96,9 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
         ("no-sound", bpo::value<bool>()->implicit_value(true)
             ->default_value(false), "disable all sounds")
 
+        ("rebuild-cache", bpo::value<bool>()->implicit_value(true)
+            ->default_value(false), "ignore the cached records of the content files, the cached compiled scripts and the cached converted meshes, and rebuild the caches")
+
         ("script-all", bpo::value<bool>()->implicit_value(true)
             ->default_value(false), "compile all scripts (excluding dialogue scripts) at startup")
 
@@ -233,6 +236,8 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     if (!variables["skip-menu"].as<bool>() && variables["new-game"].as<bool>())
         std::cerr << "Warning: new-game used without skip-menu -> ignoring it" << std::endl;
 
+    engine.setRebuildContentCache(variables["rebuild-cache"].as<bool>());
+
     // scripts
     engine.setCompileAll(variables["script-all"].as<bool>());
     engine.setCompileAllDialogue(variables["script-all-dialogue"].as<bool>());
@@ -1,6 +1,8 @@
 #ifndef GAME_MWBASE_SCRIPTMANAGER_H
 #define GAME_MWBASE_SCRIPTMANAGER_H
 
+#include <cstddef>
+#include <ostream>
 #include <string>
 
 namespace Interpreter
@@ -50,6 +52,18 @@ namespace MWBase
             ///< Return locals for script \a name.
 
             virtual MWScript::GlobalScripts& getGlobalScripts() = 0;
+
+            virtual bool toggleProfiling() = 0;
+            ///< Start or stop recording the execution of scripts. Starting discards the previous results.
+            /// \return Is profiling enabled now?
+
+            virtual void reportProfile (std::ostream& stream, std::size_t maxEntries) = 0;
+            ///< Write a summary of the recorded scripts and opcodes, limited to the \a maxEntries most
+            /// expensive of each.
+
+            virtual std::string writeProfile() = 0;
+            ///< Write all recorded scripts and opcodes to a CSV file.
+            /// \return Path of the file
    };
 }
 
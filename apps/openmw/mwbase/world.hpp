@@ -163,6 +163,22 @@ namespace MWBase
             virtual char getGlobalVariableType (const std::string& name) const = 0;
             ///< Return ' ', if there is no global variable with this name.
 
+            virtual int getGlobalSlot (const std::string& name) const = 0;
+            ///< Return a number that refers to the global variable \a name for the rest of the session,
+            /// or -1, if there is no global variable with this name.
+
+            virtual void setGlobalInt (int slot, int value) = 0;
+            ///< Set value independently from real type.
+
+            virtual void setGlobalFloat (int slot, float value) = 0;
+            ///< Set value independently from real type.
+
+            virtual int getGlobalInt (int slot) const = 0;
+            ///< Get value independently from real type.
+
+            virtual float getGlobalFloat (int slot) const = 0;
+            ///< Get value independently from real type.
+
             virtual std::string getCellName (const MWWorld::CellStore *cell = 0) const = 0;
             ///< Return name of the cell.
             ///
@@ -359,6 +375,13 @@ namespace MWBase
 
             virtual void update (float duration, bool paused) = 0;
 
+            virtual void startPhysics() = 0;
+            ///< Start solving the movement queued by update() in the background, if physics run asynchronously.
+            /// Nothing but rendering may happen until finishPhysics() is called.
+
+            virtual void finishPhysics() = 0;
+            ///< Wait for the movement started by startPhysics() and move the actors accordingly.
+
             virtual void updateWindowManager () = 0;
 
             virtual MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount) = 0;
@@ -261,6 +261,11 @@ namespace MWGui
         draw();
     }
 
+    void LoadingScreen::reportTime (const std::string& stage, double milliseconds)
+    {
+        std::cout << stage << ": " << milliseconds << " ms" << std::endl;
+    }
+
     bool LoadingScreen::needToDrawLoadingScreen()
     {
         if ( mTimer.time_m() <= mLastRenderTime + (1.0/getTargetFrameRate()) * 1000.0)
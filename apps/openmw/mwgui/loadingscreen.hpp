@@ -40,6 +40,7 @@ namespace MWGui
         virtual void setProgressRange (size_t range);
         virtual void setProgress (size_t value);
         virtual void increaseProgress (size_t increase=1);
+        virtual void reportTime (const std::string& stage, double milliseconds);
 
         virtual void setVisible(bool visible);
 
@@ -310,8 +310,7 @@ namespace MWMechanics
         calculateRestoration(ptr, duration);
     }
 
-    void Actors::updateHeadTracking(const MWWorld::Ptr& actor, const MWWorld::Ptr& targetActor,
-                                    MWWorld::Ptr& headTrackTarget, float& sqrHeadTrackDistance)
+    float Actors::getMaxHeadTrackDistance(const MWWorld::Ptr& actor) const
     {
         static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
                 .find("fMaxHeadTrackDistance")->getFloat();
@@ -321,6 +320,13 @@ namespace MWMechanics
         const ESM::Cell* currentCell = actor.getCell()->getCell();
         if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
             maxDistance *= fInteriorHeadTrackMult;
+        return maxDistance;
+    }
+
+    void Actors::updateHeadTracking(const MWWorld::Ptr& actor, const MWWorld::Ptr& targetActor,
+                                    MWWorld::Ptr& headTrackTarget, float& sqrHeadTrackDistance)
+    {
+        float maxDistance = getMaxHeadTrackDistance(actor);
 
         const ESM::Position& actor1Pos = actor.getRefData().getPosition();
         const ESM::Position& actor2Pos = targetActor.getRefData().getPosition();
@@ -1126,7 +1132,9 @@ namespace MWMechanics
         }
     }
 
-    Actors::Actors() {
+    Actors::Actors()
+        : mActorGrid(4096.f)
+    {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
     }
 
@@ -1143,6 +1151,7 @@ namespace MWMechanics
         if (!anim)
             return;
         mActors.insert(std::make_pair(ptr, new Actor(ptr, anim)));
+        mActorGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
         if (updateImmediately)
             mActors[ptr]->getCharacterController()->update(0);
     }
@@ -1154,6 +1163,7 @@ namespace MWMechanics
         {
             delete iter->second;
             mActors.erase(iter);
+            mActorGrid.remove(ptr);
         }
     }
 
@@ -1200,9 +1210,18 @@ namespace MWMechanics
 
             actor->updatePtr(ptr);
             mActors.insert(std::make_pair(ptr, actor));
+
+            mActorGrid.remove(old);
+            mActorGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
         }
     }
 
+    void Actors::updatePosition(const MWWorld::Ptr& ptr)
+    {
+        if (mActors.find(ptr) != mActors.end())
+            mActorGrid.update(ptr, ptr.getRefData().getPosition().asVec3());
+    }
+
     void Actors::dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore)
     {
         PtrActorMap::iterator iter = mActors.begin();
@@ -1210,6 +1229,7 @@ namespace MWMechanics
         {
             if((iter->first.isInCell() && iter->first.getCell()==cellStore) && iter->first != ignore)
             {
+                mActorGrid.remove(iter->first);
                 delete iter->second;
                 mActors.erase(iter++);
             }
@@ -1223,20 +1243,16 @@ namespace MWMechanics
         MWWorld::Ptr player = getPlayer();
         int hostilesCount = 0; // need to know this to play Battle music
 
-        for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+        if (MWBase::Environment::get().getMechanicsManager()->isAIActive())
         {
-            if (!iter->first.getClass().getCreatureStats(iter->first).isDead())
+            std::vector<MWWorld::Ptr> neighbors;
+            getObjectsInRange(player.getRefData().getPosition().asVec3(), aiProcessingDistance, neighbors);
+            for(std::vector<MWWorld::Ptr>::const_iterator iter(neighbors.begin()); iter != neighbors.end(); ++iter)
             {
-                bool inProcessingRange = (player.getRefData().getPosition().asVec3() - iter->first.getRefData().getPosition().asVec3()).length2()
-                        <= sqrAiProcessingDistance;
-
-                if (MWBase::Environment::get().getMechanicsManager()->isAIActive() && inProcessingRange)
+                if (*iter != player)
                 {
-                    if (iter->first != player)
-                    {
-                        MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-                        if (stats.getAiSequence().isInCombat() && !stats.isDead()) hostilesCount++;
-                    }
+                    MWMechanics::CreatureStats& stats = iter->getClass().getCreatureStats(*iter);
+                    if (stats.getAiSequence().isInCombat() && !stats.isDead()) hostilesCount++;
                 }
             }
         }
@@ -1278,6 +1294,10 @@ namespace MWMechanics
 
             MWWorld::Ptr player = getPlayer();
 
+            // Most movement is reported through updatePosition(), but not all of it
+            for(PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+                mActorGrid.update(iter->first, iter->first.getRefData().getPosition().asVec3());
+
             /// \todo move update logic to Actor class where appropriate
 
             std::map<const MWWorld::Ptr, const std::set<MWWorld::Ptr> > cachedAllies; // will be filled as engageCombat iterates
@@ -1327,11 +1347,15 @@ namespace MWMechanics
                             if (iter->first != player)
                                 adjustCommandedActor(iter->first);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            // Combat is only engaged within the AI processing distance, so there is no need to look further
+                            std::vector<MWWorld::Ptr> neighbors;
+                            if (iter->first != player) // player is not AI-controlled
+                                getObjectsInRange(iter->first.getRefData().getPosition().asVec3(), aiProcessingDistance, neighbors);
+                            for(std::vector<MWWorld::Ptr>::const_iterator it(neighbors.begin()); it != neighbors.end(); ++it)
                             {
-                                if (it->first == iter->first || iter->first == player) // player is not AI-controlled
+                                if (*it == iter->first)
                                     continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                engageCombat(iter->first, *it, cachedAllies, *it == player);
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -1347,11 +1371,14 @@ namespace MWMechanics
                                 !stats.getAiSequence().isInCombat() &&
                                 !stats.getAiSequence().hasPackage(AiPackage::TypeIdPursue))
                             {
-                                for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                std::vector<MWWorld::Ptr> neighbors;
+                                getObjectsInRange(iter->first.getRefData().getPosition().asVec3(),
+                                                  getMaxHeadTrackDistance(iter->first), neighbors);
+                                for(std::vector<MWWorld::Ptr>::const_iterator it(neighbors.begin()); it != neighbors.end(); ++it)
                                 {
-                                    if (it->first == iter->first)
+                                    if (*it == iter->first)
                                         continue;
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
+                                    updateHeadTracking(iter->first, *it, headTrackTarget, sqrHeadTrackDistance);
                                 }
                             }
 
@@ -1475,19 +1502,20 @@ namespace MWMechanics
 
                     bool detected = false;
 
-                    for (PtrActorMap::iterator iter(mActors.begin()); iter != mActors.end(); ++iter)
+                    std::vector<MWWorld::Ptr> observers;
+                    getObjectsInRange(player.getRefData().getPosition().asVec3(), static_cast<float>(radius), observers);
+                    for (std::vector<MWWorld::Ptr>::const_iterator iter(observers.begin()); iter != observers.end(); ++iter)
                     {
-                        MWWorld::Ptr observer = iter->first;
+                        MWWorld::Ptr observer = *iter;
 
-                        if (iter->first == player)  // not the player
+                        if (observer == player)  // not the player
                             continue;
 
                         if (observer.getClass().getCreatureStats(observer).isDead())
                             continue;
 
-                        // is the player in range and can they be detected
-                        if ((observer.getRefData().getPosition().asVec3() - player.getRefData().getPosition().asVec3()).length2() <= radius*radius
-                            && MWBase::Environment::get().getWorld()->getLOS(player, observer))
+                        // can the player be detected
+                        if (MWBase::Environment::get().getWorld()->getLOS(player, observer))
                         {
                             if (MWBase::Environment::get().getMechanicsManager()->awarenessCheck(player, observer))
                             {
@@ -1729,22 +1757,12 @@ namespace MWMechanics
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
-        }
+        mActorGrid.getItemsInRange(position, radius, out);
     }
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                return true;
-        }
-
-        return false;
+        return mActorGrid.isAnyItemInRange(position, radius);
     }
 
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
@@ -1948,6 +1966,7 @@ namespace MWMechanics
             it->second = NULL;
         }
         mActors.clear();
+        mActorGrid.clear();
         mDeathCount.clear();
     }
 
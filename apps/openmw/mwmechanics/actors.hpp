@@ -9,6 +9,7 @@
 #include "../mwbase/world.hpp"
 
 #include "movement.hpp"
+#include "spatialgrid.hpp"
 
 namespace MWWorld
 {
@@ -80,6 +81,11 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updatePosition(const MWWorld::Ptr& ptr);
+            ///< Update the spatial index after \a ptr has moved
+            ///
+            /// \note Ignored, if \a ptr is not a registered actor.
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -127,6 +133,7 @@ namespace MWMechanics
             bool checkAnimationPlaying(const MWWorld::Ptr& ptr, const std::string& groupName);
             void persistAnimationStates();
 
+            /// Append the actors within \a radius of \a position to \a out, in no particular order.
             void getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out);
 
             bool isAnyObjectInRange(const osg::Vec3f& position, float radius);
@@ -168,6 +175,12 @@ namespace MWMechanics
         PtrActorMap mActors;
         float mTimerDisposeSummonsCorpses;
 
+        /// Positions of the actors in mActors, for range queries
+        SpatialGrid<MWWorld::Ptr> mActorGrid;
+
+        /// Maximum distance at which \a actor tracks other actors with its head
+        float getMaxHeadTrackDistance(const MWWorld::Ptr& actor) const;
+
     };
 }
 
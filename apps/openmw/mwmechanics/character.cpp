@@ -864,20 +864,18 @@ void split(const std::string &s, char delim, std::vector<std::string> &elems) {
     }
 }
 
-void CharacterController::handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key, const std::multimap<float, std::string> &map)
+void CharacterController::handleTextKey(const std::string &groupname, NifOsg::TextKeyMap::const_iterator key, const NifOsg::TextKeyMap &map)
 {
-    const std::string &evt = key->second;
-
-    if(evt.compare(0, 7, "sound: ") == 0)
+    if(key->mType == NifOsg::TextKey::Type_Sound)
     {
         MWBase::SoundManager *sndMgr = MWBase::Environment::get().getSoundManager();
-        sndMgr->stopSound3D(mPtr, evt.substr(7));
-        sndMgr->playSound3D(mPtr, evt.substr(7), 1.0f, 1.0f);
+        sndMgr->stopSound3D(mPtr, key->mEvent);
+        sndMgr->playSound3D(mPtr, key->mEvent, 1.0f, 1.0f);
         return;
     }
-    if(evt.compare(0, 10, "soundgen: ") == 0)
+    if(key->mType == NifOsg::TextKey::Type_SoundGen)
     {
-        std::string soundgen = evt.substr(10);
+        std::string soundgen = key->mEvent;
 
         // The event can optionally contain volume and pitch modifiers
         float volume=1.f, pitch=1.f;
@@ -904,7 +902,7 @@ void CharacterController::handleTextKey(const std::string &groupname, const std:
         if(!sound.empty())
         {
             MWBase::SoundManager *sndMgr = MWBase::Environment::get().getSoundManager();
-            if(evt.compare(10, evt.size()-10, "left") == 0 || evt.compare(10, evt.size()-10, "right") == 0 || evt.compare(10, evt.size()-10, "land") == 0)
+            if(key->mEvent == "left" || key->mEvent == "right" || key->mEvent == "land")
             {
                 // Don't make foot sounds local for the player, it makes sense to keep them
                 // positioned on the ground.
@@ -920,27 +918,30 @@ void CharacterController::handleTextKey(const std::string &groupname, const std:
         return;
     }
 
-    if(evt.compare(0, groupname.size(), groupname) != 0 ||
-       evt.compare(groupname.size(), 2, ": ") != 0)
+    if(key->mGroup != groupname)
     {
         // Not ours, skip it
         return;
     }
-    size_t off = groupname.size()+2;
-    size_t len = evt.size() - off;
 
-    if(evt.compare(off, len, "equip attach") == 0)
+    switch (key->mType)
+    {
+    case NifOsg::TextKey::Type_EquipAttach:
         mAnimation->showWeapons(true);
-    else if(evt.compare(off, len, "unequip detach") == 0)
+        break;
+    case NifOsg::TextKey::Type_UnequipDetach:
         mAnimation->showWeapons(false);
-    else if(evt.compare(off, len, "chop hit") == 0)
+        break;
+    case NifOsg::TextKey::Type_ChopHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
-    else if(evt.compare(off, len, "slash hit") == 0)
+        break;
+    case NifOsg::TextKey::Type_SlashHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
-    else if(evt.compare(off, len, "thrust hit") == 0)
+        break;
+    case NifOsg::TextKey::Type_ThrustHit:
         mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
-    else if(evt.compare(off, len, "hit") == 0)
-    {
+        break;
+    case NifOsg::TextKey::Type_Hit:
         if (groupname == "attack1" || groupname == "swimattack1")
             mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
         else if (groupname == "attack2" || groupname == "swimattack2")
@@ -949,53 +950,58 @@ void CharacterController::handleTextKey(const std::string &groupname, const std:
             mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
         else
             mPtr.getClass().hit(mPtr, mAttackStrength);
-    }
-    else if (!groupname.empty()
-             && (groupname.compare(0, groupname.size()-1, "attack") == 0 || groupname.compare(0, groupname.size()-1, "swimattack") == 0)
-             && evt.compare(off, len, "start") == 0)
-    {
-        std::multimap<float, std::string>::const_iterator hitKey = key;
-
-        // Not all animations have a hit key defined. If there is none, the hit happens with the start key.
-        bool hasHitKey = false;
-        while (hitKey != map.end())
+        break;
+    case NifOsg::TextKey::Type_Start:
+        if (!groupname.empty()
+                && (groupname.compare(0, groupname.size()-1, "attack") == 0 || groupname.compare(0, groupname.size()-1, "swimattack") == 0))
         {
-            if (hitKey->second == groupname + ": hit")
+            NifOsg::TextKeyMap::const_iterator hitKey = key;
+
+            // Not all animations have a hit key defined. If there is none, the hit happens with the start key.
+            bool hasHitKey = false;
+            for (; hitKey != map.end(); ++hitKey)
             {
-                hasHitKey = true;
-                break;
+                if (hitKey->mGroup != groupname)
+                    continue;
+                if (hitKey->mType == NifOsg::TextKey::Type_Hit)
+                {
+                    hasHitKey = true;
+                    break;
+                }
+                if (hitKey->mType == NifOsg::TextKey::Type_Stop)
+                    break;
+            }
+            if (!hasHitKey)
+            {
+                if (groupname == "attack1" || groupname == "swimattack1")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
+                else if (groupname == "attack2" || groupname == "swimattack2")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
+                else if (groupname == "attack3" || groupname == "swimattack3")
+                    mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
             }
-            if (hitKey->second == groupname + ": stop")
-                break;
-            ++hitKey;
-        }
-        if (!hasHitKey)
-        {
-            if (groupname == "attack1" || groupname == "swimattack1")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Chop);
-            else if (groupname == "attack2" || groupname == "swimattack2")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Slash);
-            else if (groupname == "attack3" || groupname == "swimattack3")
-                mPtr.getClass().hit(mPtr, mAttackStrength, ESM::Weapon::AT_Thrust);
         }
-    }
-    else if (evt.compare(off, len, "shoot attach") == 0)
+        break;
+    case NifOsg::TextKey::Type_ShootAttach:
+    case NifOsg::TextKey::Type_ShootFollowAttach:
         mAnimation->attachArrow();
-    else if (evt.compare(off, len, "shoot release") == 0)
+        break;
+    case NifOsg::TextKey::Type_ShootRelease:
         mAnimation->releaseArrow(mAttackStrength);
-    else if (evt.compare(off, len, "shoot follow attach") == 0)
-        mAnimation->attachArrow();
-
-    else if (groupname == "spellcast" && evt.substr(evt.size()-7, 7) == "release"
-             // Make sure this key is actually for the RangeType we are casting. The flame atronach has
-             // the same animation for all range types, so there are 3 "release" keys on the same time, one for each range type.
-             && evt.compare(off, len, mAttackType + " release") == 0)
-    {
-        MWBase::Environment::get().getWorld()->castSpell(mPtr);
+        break;
+    case NifOsg::TextKey::Type_Release:
+        // Make sure this key is actually for the RangeType we are casting. The flame atronach has
+        // the same animation for all range types, so there are 3 "release" keys on the same time, one for each range type.
+        if (groupname == "spellcast" && key->mEvent == mAttackType + " release")
+            MWBase::Environment::get().getWorld()->castSpell(mPtr);
+        break;
+    case NifOsg::TextKey::Type_BlockHit:
+        if (groupname == "shield")
+            mPtr.getClass().block(mPtr);
+        break;
+    default:
+        break;
     }
-
-    else if (groupname == "shield" && evt.compare(off, len, "block hit") == 0)
-        mPtr.getClass().block(mPtr);
 }
 
 void CharacterController::updatePtr(const MWWorld::Ptr &ptr)
@@ -243,8 +243,8 @@ public:
     CharacterController(const MWWorld::Ptr &ptr, MWRender::Animation *anim);
     virtual ~CharacterController();
 
-    virtual void handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map);
+    virtual void handleTextKey(const std::string &groupname, NifOsg::TextKeyMap::const_iterator key,
+                       const NifOsg::TextKeyMap& map);
 
     // Be careful when to call this, see comment in Actors
     void updateContinuousVfx();
@@ -61,6 +61,9 @@ namespace MWMechanics
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr);
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr);
+            ///< Notify that an object has been moved to a new position
+
             virtual void drop(const MWWorld::CellStore *cellStore);
             ///< Deregister all objects in the given cell.
 
@@ -0,0 +1,207 @@
+#ifndef OPENMW_MWMECHANICS_SPATIALGRID_H
+#define OPENMW_MWMECHANICS_SPATIALGRID_H
+
+#include <map>
+#include <vector>
+#include <cmath>
+
+#include <osg/Vec3f>
+
+namespace MWMechanics
+{
+    /// @brief Uniform grid over the horizontal positions of a set of items, used to find the items close to a point
+    /// without looking at all of them.
+    /// @par The grid does not observe the items. Whenever an item moves, update() has to be called with its new position.
+    /// @note T must be ordered by operator<.
+    template <class T>
+    class SpatialGrid
+    {
+    public:
+        /// @param cellSize Width of a grid cell in world units. Should be in the order of the typical query radius.
+        explicit SpatialGrid(float cellSize)
+            : mCellSize(cellSize)
+        {
+        }
+
+        /// Insert \a item at \a position, or move it there if it is in the grid already.
+        void update(const T& item, const osg::Vec3f& position)
+        {
+            CellIndex index = getCellIndex(position.x(), position.y());
+
+            typename ItemMap::iterator found = mItems.find(item);
+            if (found != mItems.end())
+            {
+                if (found->second == index)
+                {
+                    std::vector<Entry>& cell = mCells[index];
+                    for (typename std::vector<Entry>::iterator it = cell.begin(); it != cell.end(); ++it)
+                    {
+                        if (it->mItem == item)
+                        {
+                            it->mPosition = position;
+                            return;
+                        }
+                    }
+                }
+                removeFromCell(found->second, item);
+                found->second = index;
+            }
+            else
+                mItems.insert(std::make_pair(item, index));
+
+            mCells[index].push_back(Entry(item, position));
+        }
+
+        void remove(const T& item)
+        {
+            typename ItemMap::iterator found = mItems.find(item);
+            if (found == mItems.end())
+                return;
+            removeFromCell(found->second, item);
+            mItems.erase(found);
+        }
+
+        void clear()
+        {
+            mCells.clear();
+            mItems.clear();
+        }
+
+        size_t size() const
+        {
+            return mItems.size();
+        }
+
+        /// Append all items within \a radius of \a position to \a out, in no particular order.
+        void getItemsInRange(const osg::Vec3f& position, float radius, std::vector<T>& out) const
+        {
+            forEachCellInRange(position, radius, Collector(position, radius, out));
+        }
+
+        bool isAnyItemInRange(const osg::Vec3f& position, float radius) const
+        {
+            bool found = false;
+            forEachCellInRange(position, radius, Finder(position, radius, found));
+            return found;
+        }
+
+    private:
+        typedef std::pair<int, int> CellIndex;
+
+        struct Entry
+        {
+            Entry(const T& item, const osg::Vec3f& position)
+                : mItem(item)
+                , mPosition(position)
+            {
+            }
+
+            T mItem;
+            osg::Vec3f mPosition; ///< Where the item was last updated to
+        };
+
+        typedef std::map<CellIndex, std::vector<Entry> > CellMap;
+        typedef std::map<T, CellIndex> ItemMap;
+
+        struct Collector
+        {
+            Collector(const osg::Vec3f& position, float radius, std::vector<T>& out)
+                : mPosition(position)
+                , mSqrRadius(radius * radius)
+                , mOut(out)
+            {
+            }
+
+            void operator()(const std::vector<Entry>& cell) const
+            {
+                for (typename std::vector<Entry>::const_iterator it = cell.begin(); it != cell.end(); ++it)
+                {
+                    if ((it->mPosition - mPosition).length2() <= mSqrRadius)
+                        mOut.push_back(it->mItem);
+                }
+            }
+
+            osg::Vec3f mPosition;
+            float mSqrRadius;
+            std::vector<T>& mOut;
+        };
+
+        struct Finder
+        {
+            Finder(const osg::Vec3f& position, float radius, bool& found)
+                : mPosition(position)
+                , mSqrRadius(radius * radius)
+                , mFound(found)
+            {
+            }
+
+            void operator()(const std::vector<Entry>& cell) const
+            {
+                for (typename std::vector<Entry>::const_iterator it = cell.begin(); it != cell.end() && !mFound; ++it)
+                    mFound = (it->mPosition - mPosition).length2() <= mSqrRadius;
+            }
+
+            osg::Vec3f mPosition;
+            float mSqrRadius;
+            bool& mFound;
+        };
+
+        CellIndex getCellIndex(float x, float y) const
+        {
+            return CellIndex(static_cast<int>(std::floor(x / mCellSize)), static_cast<int>(std::floor(y / mCellSize)));
+        }
+
+        template <class Function>
+        void forEachCellInRange(const osg::Vec3f& position, float radius, Function function) const
+        {
+            float minX = std::floor((position.x() - radius) / mCellSize);
+            float maxX = std::floor((position.x() + radius) / mCellSize);
+            float minY = std::floor((position.y() - radius) / mCellSize);
+            float maxY = std::floor((position.y() + radius) / mCellSize);
+
+            // Large ranges cover more grid cells than there are occupied ones, so rather visit those
+            if ((maxX - minX + 1) * (maxY - minY + 1) > static_cast<float>(mCells.size()))
+            {
+                for (typename CellMap::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+                    function(it->second);
+                return;
+            }
+
+            for (int x = static_cast<int>(minX); x <= static_cast<int>(maxX); ++x)
+            {
+                for (int y = static_cast<int>(minY); y <= static_cast<int>(maxY); ++y)
+                {
+                    typename CellMap::const_iterator found = mCells.find(CellIndex(x, y));
+                    if (found != mCells.end())
+                        function(found->second);
+                }
+            }
+        }
+
+        void removeFromCell(const CellIndex& index, const T& item)
+        {
+            typename CellMap::iterator found = mCells.find(index);
+            if (found == mCells.end())
+                return;
+
+            std::vector<Entry>& cell = found->second;
+            for (typename std::vector<Entry>::iterator it = cell.begin(); it != cell.end(); ++it)
+            {
+                if (it->mItem == item)
+                {
+                    *it = cell.back();
+                    cell.pop_back();
+                    break;
+                }
+            }
+            if (cell.empty())
+                mCells.erase(found);
+        }
+
+        float mCellSize;
+        CellMap mCells;
+        ItemMap mItems;
+    };
+}
+
+#endif
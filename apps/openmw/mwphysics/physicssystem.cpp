@@ -24,6 +24,8 @@
 #include <components/esm/loadgmst.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
+#include <components/sceneutil/workqueue.hpp>
+#include <components/settings/settings.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -87,12 +89,14 @@ namespace MWPhysics
 
         ActorTracer mTracer, mUpStepper, mDownStepper;
         bool mHaveMoved;
+        bool mThreadSafe;
 
     public:
-        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj)
+        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj, bool threadSafe)
             : mColWorld(colWorld)
             , mColObj(colObj)
             , mHaveMoved(true)
+            , mThreadSafe(threadSafe)
         {}
 
         bool step(osg::Vec3f &position, const osg::Vec3f &toMove, float &remainingTime)
@@ -144,7 +148,7 @@ namespace MWPhysics
             if (mHaveMoved)
             {
                 mHaveMoved = false;
-                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld);
+                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld, mThreadSafe);
                 if(mUpStepper.mFraction < std::numeric_limits<float>::epsilon())
                     return false; // didn't even move the smallest representable amount
                                   // (TODO: shouldn't this be larger? Why bother with such a small amount?)
@@ -164,7 +168,7 @@ namespace MWPhysics
              *    ==============================================
              */
             osg::Vec3f tracerPos = mUpStepper.mEndPos;
-            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld);
+            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld, mThreadSafe);
             if(mTracer.mFraction < std::numeric_limits<float>::epsilon())
                 return false; // didn't even move the smallest representable amount
 
@@ -183,7 +187,7 @@ namespace MWPhysics
              *          +--+            +--+
              *    ==============================================
              */
-            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mThreadSafe);
             if (!canStepDown(mDownStepper))
             {
                 // Try again with increased step length
@@ -192,11 +196,11 @@ namespace MWPhysics
 
                 osg::Vec3f direction = toMove;
                 direction.normalize();
-                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld);
+                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld, mThreadSafe);
                 if (mTracer.mFraction < 0.001f)
                     return false;
 
-                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mThreadSafe);
                 if (!canStepDown(mDownStepper))
                     return false;
             }
@@ -274,9 +278,12 @@ namespace MWPhysics
             }
         }
 
+        /// @param standingOn Set to the object the actor is standing on, if any.
+        /// @param threadSafe Only read from the collision world, so that several actors can be moved at the same time.
+        /// The caller is responsible for not modifying the collision world or the actor's own collision object meanwhile.
         static osg::Vec3f move(osg::Vec3f position, const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
                                   bool isFlying, float waterlevel, float slowFall, const btCollisionWorld* collisionWorld,
-                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+                               MWWorld::Ptr& standingOn, bool threadSafe)
         {
             const ESM::Position& refpos = ptr.getRefData().getPosition();
             // Early-out for totally static creatures
@@ -344,7 +351,7 @@ namespace MWPhysics
                 velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
             }
 
-            Stepper stepper(collisionWorld, colobj);
+            Stepper stepper(collisionWorld, colobj, threadSafe);
             osg::Vec3f origVelocity = velocity;
             osg::Vec3f newPosition = position;
             /*
@@ -371,7 +378,7 @@ namespace MWPhysics
                 if((newPosition - nextpos).length2() > 0.0001)
                 {
                     // trace to where character would go if there were no obstructions
-                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld);
+                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld, threadSafe);
 
                     // check for obstructions
                     if(tracer.mFraction >= 1.0f)
@@ -443,16 +450,16 @@ namespace MWPhysics
                 osg::Vec3f from = newPosition;
                 osg::Vec3f to = newPosition - (physicActor->getOnGround() ?
                              osg::Vec3f(0,0,sStepSizeDown + 2*sGroundOffset) : osg::Vec3f(0,0,2*sGroundOffset));
-                tracer.doTrace(colobj, from, to, collisionWorld);
+                tracer.doTrace(colobj, from, to, collisionWorld, threadSafe);
                 if(tracer.mFraction < 1.0f
                         && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor)
                 {
-                    const btCollisionObject* standingOn = tracer.mHitObject;
-                    PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOn->getUserPointer());
+                    const btCollisionObject* standingOnObject = tracer.mHitObject;
+                    PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOnObject->getUserPointer());
                     if (ptrHolder)
-                        standingCollisionTracker[ptr] = ptrHolder->getPtr();
+                        standingOn = ptrHolder->getPtr();
 
-                    if (standingOn->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
+                    if (standingOnObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
                         physicActor->setWalkingOnWater(true);
                     if (!isFlying)
                         newPosition.z() = tracer.mEndPos.z() + sGroundOffset;
@@ -685,9 +692,20 @@ namespace MWPhysics
         , mWaterEnabled(false)
         , mParentNode(parentNode)
         , mPhysicsDt(1.f / 60.f)
+        , mNumSolverThreads(0)
+        , mAsync(false)
+        , mAsyncDuration(0.f)
+        , mAsyncStepQueued(false)
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
+        mNumSolverThreads = std::max(0, Settings::Manager::getInt("solver threads", "Physics"));
+        mAsync = Settings::Manager::getBool("async", "Physics");
+        // In async mode, one more thread takes over the part of the main thread
+        int numThreads = mNumSolverThreads + (mAsync ? 1 : 0);
+        if (numThreads > 0)
+            mSolverQueue = new SceneUtil::WorkQueue(numThreads);
+
         mCollisionConfiguration = new btDefaultCollisionConfiguration();
         mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
         mBroadphase = new btDbvtBroadphase();
@@ -713,6 +731,9 @@ namespace MWPhysics
 
     PhysicsSystem::~PhysicsSystem()
     {
+        if (mAsyncMovement)
+            mAsyncMovement->waitTillDone();
+
         mResourceSystem->removeResourceManager(mShapeManager.get());
 
         if (mWaterCollisionObject.get())
@@ -1372,14 +1393,156 @@ namespace MWPhysics
 
     void PhysicsSystem::clearQueuedMovement()
     {
+        if (mAsyncMovement)
+        {
+            mAsyncMovement->waitTillDone();
+            mAsyncMovement = NULL;
+        }
+
         mMovementQueue.clear();
         mStandingCollisions.clear();
     }
 
-    const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
+    struct MovementJob
     {
-        mMovementResults.clear();
+        MovementJob(const MWWorld::Ptr& ptr, const osg::Vec3f& movement)
+            : mPtr(ptr)
+            , mActor(NULL)
+            , mMovement(movement)
+            , mWaterlevel(-std::numeric_limits<float>::max())
+            , mSlowFall(1.f)
+            , mFlying(false)
+            , mWasOnGround(false)
+            , mOldHeight(0.f)
+            , mPositionChanged(false)
+        {
+        }
+
+        MWWorld::Ptr mPtr;
+        Actor* mActor;
+        osg::Vec3f mMovement;
+        float mWaterlevel;
+        float mSlowFall;
+        bool mFlying;
+        bool mWasOnGround;
+        float mOldHeight;
+
+        // Results of the movement solver
+        osg::Vec3f mPosition;
+        osg::Vec3f mLastStepStart; ///< Position before the last step. Only set by a deferred solve.
+        bool mPositionChanged;
+        MWWorld::Ptr mStandingOn;
+    };
+
+    /// Run all physics steps of this frame for the actor of \a job.
+    /// @param deferred Leave the actor's collision object where it is, to be moved by finishMovement() later on.
+    /// The collision world is then only read from, so the jobs of different actors may be solved concurrently.
+    static void solveMovement(MovementJob& job, int numSteps, float physicsDt, btCollisionWorld* collisionWorld, bool deferred)
+    {
+        Actor* physicActor = job.mActor;
+        osg::Vec3f position = job.mPosition;
+        for (int i=0; i<numSteps; ++i)
+        {
+            const osg::Vec3f previous = position;
+            position = MovementSolver::move(position, job.mPtr, physicActor, job.mMovement, physicsDt,
+                                            job.mFlying, job.mWaterlevel, job.mSlowFall, collisionWorld, job.mStandingOn, deferred);
+            if (position != previous)
+                job.mPositionChanged = true;
+            if (deferred)
+                job.mLastStepStart = previous;
+            else
+                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
+        }
+        if (!deferred && job.mPositionChanged)
+            collisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+        job.mPosition = position;
+    }
+
+    /// Solve the jobs that no other thread has claimed yet.
+    static void solveMovementJobs(std::vector<MovementJob>& jobs, OpenThreads::Atomic& nextJob, int numSteps, float physicsDt, btCollisionWorld* collisionWorld)
+    {
+        for (unsigned int i = (++nextJob) - 1; i < jobs.size(); i = (++nextJob) - 1)
+            solveMovement(jobs[i], numSteps, physicsDt, collisionWorld, true);
+    }
+
+    class SolveMovementWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        SolveMovementWorkItem(std::vector<MovementJob>& jobs, OpenThreads::Atomic& nextJob, int numSteps, float physicsDt, btCollisionWorld* collisionWorld)
+            : mJobs(jobs)
+            , mNextJob(nextJob)
+            , mNumSteps(numSteps)
+            , mPhysicsDt(physicsDt)
+            , mCollisionWorld(collisionWorld)
+        {
+        }
+
+        virtual void doWork()
+        {
+            solveMovementJobs(mJobs, mNextJob, mNumSteps, mPhysicsDt, mCollisionWorld);
+        }
+
+    private:
+        std::vector<MovementJob>& mJobs;
+        OpenThreads::Atomic& mNextJob;
+        int mNumSteps;
+        float mPhysicsDt;
+        btCollisionWorld* mCollisionWorld;
+    };
+
+    /// Solve the jobs on the calling thread, with the help of up to \a numHelpers threads of \a workQueue.
+    static void solveMovementParallel(std::vector<MovementJob>& jobs, int numSteps, float physicsDt, btCollisionWorld* collisionWorld,
+                                      SceneUtil::WorkQueue* workQueue, unsigned int numHelpers)
+    {
+        if (!numSteps || jobs.empty())
+            return;
+
+        OpenThreads::Atomic nextJob;
+        std::vector<osg::ref_ptr<SolveMovementWorkItem> > workItems;
+        unsigned int numWorkItems = std::min<size_t>(numHelpers, jobs.size() - 1);
+        for (unsigned int i = 0; i < numWorkItems; ++i)
+        {
+            workItems.push_back(new SolveMovementWorkItem(jobs, nextJob, numSteps, physicsDt, collisionWorld));
+            workQueue->addWorkItem(workItems.back(), SceneUtil::WorkQueue::Priority_High);
+        }
+
+        // Rather than waiting idly, help out with the jobs
+        solveMovementJobs(jobs, nextJob, numSteps, physicsDt, collisionWorld);
+
+        for (unsigned int i = 0; i < workItems.size(); ++i)
+            workItems[i]->waitTillDone();
+    }
+
+    /// Solves the movement of one frame while the main thread is busy rendering, see PhysicsSystem::startQueuedMovement().
+    class AsyncMovementWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        AsyncMovementWorkItem(int numSteps, float physicsDt, btCollisionWorld* collisionWorld, SceneUtil::WorkQueue* workQueue, unsigned int numHelpers)
+            : mNumSteps(numSteps)
+            , mPhysicsDt(physicsDt)
+            , mCollisionWorld(collisionWorld)
+            , mWorkQueue(workQueue)
+            , mNumHelpers(numHelpers)
+        {
+        }
+
+        virtual void doWork()
+        {
+            solveMovementParallel(mJobs, mNumSteps, mPhysicsDt, mCollisionWorld, mWorkQueue, mNumHelpers);
+        }
+
+        std::vector<MovementJob> mJobs;
+        int mNumSteps;
 
+    private:
+        float mPhysicsDt;
+        btCollisionWorld* mCollisionWorld;
+        SceneUtil::WorkQueue* mWorkQueue;
+        unsigned int mNumHelpers;
+    };
+
+    int PhysicsSystem::advanceTime(float dt)
+    {
         mTimeAccum += dt;
 
         const int maxAllowedSteps = 20;
@@ -1388,77 +1551,183 @@ namespace MWPhysics
 
         mTimeAccum -= numSteps * mPhysicsDt;
 
-        if (numSteps)
+        return numSteps;
+    }
+
+    bool PhysicsSystem::prepareMovement(MovementJob& job)
+    {
+        ActorMap::iterator foundActor = mActors.find(job.mPtr);
+        if (foundActor == mActors.end()) // actor was already removed from the scene
+            return false;
+        Actor* physicActor = foundActor->second;
+        job.mActor = physicActor;
+
+        const MWBase::World *world = MWBase::Environment::get().getWorld();
+
+        const MWWorld::CellStore *cell = job.mPtr.getCell();
+        if(cell->getCell()->hasWater())
+            job.mWaterlevel = cell->getWaterLevel();
+
+        const MWMechanics::MagicEffects& effects = job.mPtr.getClass().getCreatureStats(job.mPtr).getMagicEffects();
+
+        bool waterCollision = false;
+        if (cell->getCell()->hasWater() && effects.get(ESM::MagicEffect::WaterWalking).getMagnitude())
         {
-            // Collision events should be available on every frame
-            mStandingCollisions.clear();
+            if (!world->isUnderwater(job.mPtr.getCell(), osg::Vec3f(job.mPtr.getRefData().getPosition().asVec3())))
+                waterCollision = true;
+            else if (physicActor->getCollisionMode() && canMoveToWaterSurface(job.mPtr, job.mWaterlevel))
+            {
+                const osg::Vec3f actorPosition = physicActor->getPosition();
+                physicActor->setPosition(osg::Vec3f(actorPosition.x(), actorPosition.y(), job.mWaterlevel));
+                waterCollision = true;
+            }
         }
+        physicActor->setCanWaterWalk(waterCollision);
+
+        // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
+        job.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+
+        job.mFlying = world->isFlying(job.mPtr);
+
+        job.mWasOnGround = physicActor->getOnGround();
+        job.mPosition = physicActor->getPosition();
+        job.mOldHeight = job.mPosition.z();
+        return true;
+    }
+
+    void PhysicsSystem::finishMovement(MovementJob& job, int numSteps, bool deferred)
+    {
+        Actor* physicActor = job.mActor;
+        const osg::Vec3f& position = job.mPosition;
+
+        if (deferred)
+        {
+            // Replay the position updates of the last two steps, so that the interpolation below is the same
+            if (numSteps > 1)
+                physicActor->setPosition(job.mLastStepStart);
+            if (numSteps > 0)
+                physicActor->setPosition(position);
+            if (job.mPositionChanged)
+                mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+        }
+
+        if (!job.mStandingOn.isEmpty())
+            mStandingCollisions[job.mPtr] = job.mStandingOn;
+
+        float interpolationFactor = mTimeAccum / mPhysicsDt;
+        osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+
+        float heightDiff = position.z() - job.mOldHeight;
 
         const MWBase::World *world = MWBase::Environment::get().getWorld();
-        PtrVelocityList::iterator iter = mMovementQueue.begin();
-        for(;iter != mMovementQueue.end();++iter)
+        MWMechanics::CreatureStats& stats = job.mPtr.getClass().getCreatureStats(job.mPtr);
+        if ((job.mWasOnGround && physicActor->getOnGround()) || job.mFlying || world->isSwimming(job.mPtr) || job.mSlowFall < 1)
+            stats.land();
+        else if (heightDiff < 0)
+            stats.addToFallHeight(-heightDiff);
+
+        mMovementResults.push_back(std::make_pair(job.mPtr, interpolated));
+    }
+
+    const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
+    {
+        mMovementResults.clear();
+
+        if (mAsync)
         {
-            ActorMap::iterator foundActor = mActors.find(iter->first);
-            if (foundActor == mActors.end()) // actor was already removed from the scene
-                continue;
-            Actor* physicActor = foundActor->second;
+            // Solved later on by startQueuedMovement()
+            mAsyncDuration += dt;
+            mAsyncStepQueued = true;
+            return mMovementResults;
+        }
 
-            float waterlevel = -std::numeric_limits<float>::max();
-            const MWWorld::CellStore *cell = iter->first.getCell();
-            if(cell->getCell()->hasWater())
-                waterlevel = cell->getWaterLevel();
+        int numSteps = advanceTime(dt);
 
-            const MWMechanics::MagicEffects& effects = iter->first.getClass().getCreatureStats(iter->first).getMagicEffects();
+        if (numSteps)
+        {
+            // Collision events should be available on every frame
+            mStandingCollisions.clear();
+        }
 
-            bool waterCollision = false;
-            if (cell->getCell()->hasWater() && effects.get(ESM::MagicEffect::WaterWalking).getMagnitude())
+        if (!mSolverQueue)
+        {
+            // Each actor collides against the positions the preceding actors have just been moved to
+            for (PtrVelocityList::iterator iter = mMovementQueue.begin(); iter != mMovementQueue.end(); ++iter)
             {
-                if (!world->isUnderwater(iter->first.getCell(), osg::Vec3f(iter->first.getRefData().getPosition().asVec3())))
-                    waterCollision = true;
-                else if (physicActor->getCollisionMode() && canMoveToWaterSurface(iter->first, waterlevel))
-                {
-                    const osg::Vec3f actorPosition = physicActor->getPosition();
-                    physicActor->setPosition(osg::Vec3f(actorPosition.x(), actorPosition.y(), waterlevel));
-                    waterCollision = true;
-                }
+                MovementJob job(iter->first, iter->second);
+                if (!prepareMovement(job))
+                    continue;
+                solveMovement(job, numSteps, mPhysicsDt, mCollisionWorld, false);
+                finishMovement(job, numSteps, false);
+            }
+        }
+        else
+        {
+            // All actors collide against the positions the actors had at the start of the frame,
+            // so the result doesn't depend on which thread solved which actor
+            std::vector<MovementJob> jobs;
+            jobs.reserve(mMovementQueue.size());
+            for (PtrVelocityList::iterator iter = mMovementQueue.begin(); iter != mMovementQueue.end(); ++iter)
+            {
+                MovementJob job(iter->first, iter->second);
+                if (prepareMovement(job))
+                    jobs.push_back(job);
             }
-            physicActor->setCanWaterWalk(waterCollision);
 
-            // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-            float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            solveMovementParallel(jobs, numSteps, mPhysicsDt, mCollisionWorld, mSolverQueue.get(), mNumSolverThreads);
 
-            bool flying = world->isFlying(iter->first);
+            for (std::vector<MovementJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+                finishMovement(*it, numSteps, true);
+        }
 
-            bool wasOnGround = physicActor->getOnGround();
-            osg::Vec3f position = physicActor->getPosition();
-            float oldHeight = position.z();
-            bool positionChanged = false;
-            for (int i=0; i<numSteps; ++i)
-            {
-                position = MovementSolver::move(position, physicActor->getPtr(), physicActor, iter->second, mPhysicsDt,
-                                                flying, waterlevel, slowFall, mCollisionWorld, mStandingCollisions);
-                if (position != physicActor->getPosition())
-                    positionChanged = true;
-                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
-            }
-            if (positionChanged)
-                mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+        mMovementQueue.clear();
+
+        return mMovementResults;
+    }
+
+    void PhysicsSystem::startQueuedMovement()
+    {
+        if (!mAsyncStepQueued || mAsyncMovement)
+            return;
+
+        int numSteps = advanceTime(mAsyncDuration);
+        mAsyncDuration = 0.f;
+        mAsyncStepQueued = false;
+
+        osg::ref_ptr<AsyncMovementWorkItem> item = new AsyncMovementWorkItem(numSteps, mPhysicsDt, mCollisionWorld, mSolverQueue.get(), mNumSolverThreads);
+        item->mJobs.reserve(mMovementQueue.size());
+        for (PtrVelocityList::iterator iter = mMovementQueue.begin(); iter != mMovementQueue.end(); ++iter)
+        {
+            MovementJob job(iter->first, iter->second);
+            if (prepareMovement(job))
+                item->mJobs.push_back(job);
+        }
+        mMovementQueue.clear();
+
+        mSolverQueue->addWorkItem(item, SceneUtil::WorkQueue::Priority_High);
+        mAsyncMovement = item;
+    }
 
-            float interpolationFactor = mTimeAccum / mPhysicsDt;
-            osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+    const PtrVelocityList& PhysicsSystem::finishQueuedMovement()
+    {
+        mMovementResults.clear();
 
-            float heightDiff = position.z() - oldHeight;
+        if (!mAsyncMovement)
+            return mMovementResults;
 
-            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-            if ((wasOnGround && physicActor->getOnGround()) || flying || world->isSwimming(iter->first) || slowFall < 1)
-                stats.land();
-            else if (heightDiff < 0)
-                stats.addToFallHeight(-heightDiff);
+        mAsyncMovement->waitTillDone();
 
-            mMovementResults.push_back(std::make_pair(iter->first, interpolated));
+        if (mAsyncMovement->mNumSteps)
+        {
+            // Collision events should be available on every frame
+            mStandingCollisions.clear();
         }
 
-        mMovementQueue.clear();
+        std::vector<MovementJob>& jobs = mAsyncMovement->mJobs;
+        for (std::vector<MovementJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+            finishMovement(*it, mAsyncMovement->mNumSteps, true);
+
+        mAsyncMovement = NULL;
 
         return mMovementResults;
     }
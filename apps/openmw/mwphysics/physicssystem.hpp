@@ -32,6 +32,7 @@ namespace Resource
 namespace SceneUtil
 {
     class UnrefQueue;
+    class WorkQueue;
 }
 
 class btCollisionWorld;
@@ -48,6 +49,8 @@ namespace MWPhysics
     class HeightField;
     class Object;
     class Actor;
+    struct MovementJob;
+    class AsyncMovementWorkItem;
 
     class PhysicsSystem
     {
@@ -142,8 +145,19 @@ namespace MWPhysics
             void queueObjectMovement(const MWWorld::Ptr &ptr, const osg::Vec3f &velocity);
 
             /// Apply all queued movements, then clear the list.
+            /// @note If physics run asynchronously, only records \a dt and returns an empty list.
+            /// The movement is then solved by startQueuedMovement() and finishQueuedMovement().
             const PtrVelocityList& applyQueuedMovement(float dt);
 
+            /// Start solving the queued movements on a worker thread, if physics run asynchronously and
+            /// applyQueuedMovement() has been called since the last step was started.
+            /// @note Nothing may access the physics system until finishQueuedMovement() is called.
+            void startQueuedMovement();
+
+            /// Wait for the movements started by startQueuedMovement() and apply them, like applyQueuedMovement().
+            /// Returns an empty list if no movement is in progress.
+            const PtrVelocityList& finishQueuedMovement();
+
             /// Clear the queued movements list without applying.
             void clearQueuedMovement();
 
@@ -174,6 +188,16 @@ namespace MWPhysics
 
             void updateWater();
 
+            /// Gather the input of the movement solver for the actor of \a job. Returns false if the actor
+            /// is no longer in the scene.
+            bool prepareMovement(MovementJob& job);
+
+            /// Add \a dt to the time to be simulated, and return the number of physics steps to take for it.
+            int advanceTime(float dt);
+
+            /// Apply the result of the movement solver for the actor of \a job. Always called in queue order.
+            void finishMovement(MovementJob& job, int numSteps, bool deferred);
+
             osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
 
             btBroadphaseInterface* mBroadphase;
@@ -222,6 +246,15 @@ namespace MWPhysics
 
             float mPhysicsDt;
 
+            /// Worker threads that help solving the movement of actors, NULL to solve it on the main thread only.
+            osg::ref_ptr<SceneUtil::WorkQueue> mSolverQueue;
+            int mNumSolverThreads;
+
+            bool mAsync;
+            float mAsyncDuration; ///< Time passed since the last step started by startQueuedMovement()
+            bool mAsyncStepQueued;
+            osg::ref_ptr<AsyncMovementWorkItem> mAsyncMovement; ///< Step in progress, if any
+
             PhysicsSystem (const PhysicsSystem&);
             PhysicsSystem& operator= (const PhysicsSystem&);
     };
@@ -4,6 +4,8 @@
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <LinearMath/btTransformUtil.h>
 
 #include "collisiontype.hpp"
 #include "actor.hpp"
@@ -48,8 +50,66 @@ protected:
     const btScalar mMinSlopeDot;
 };
 
+/// Narrow phase of a convex sweep for the broadphase proxies whose bounds touch the swept volume.
+class SweepCollider : public btDbvt::ICollide
+{
+public:
+    SweepCollider(const btConvexShape* castShape, const btTransform& from, const btTransform& to, btCollisionWorld::ConvexResultCallback& callback)
+        : mCastShape(castShape), mFrom(from), mTo(to), mCallback(callback)
+    {
+    }
+
+    virtual void Process(const btDbvtNode* leaf)
+    {
+        if (mCallback.m_closestHitFraction == btScalar(0))
+            return;
+
+        const btDbvtProxy* proxy = static_cast<const btDbvtProxy*>(leaf->data);
+        if (!mCallback.needsCollision(const_cast<btDbvtProxy*>(proxy)))
+            return;
+
+        const btCollisionObject* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+        btCollisionWorld::objectQuerySingle(mCastShape, mFrom, mTo, object, object->getCollisionShape(),
+                                            object->getWorldTransform(), mCallback, btScalar(0));
+    }
 
-void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
+private:
+    const btConvexShape* mCastShape;
+    const btTransform& mFrom;
+    const btTransform& mTo;
+    btCollisionWorld::ConvexResultCallback& mCallback;
+};
+
+// Equivalent of btCollisionWorld::convexSweepTest that only reads from the collision world.
+// The btDbvt queries used here keep their traversal stack on the stack of the calling thread.
+static void threadSafeConvexSweepTest(const btCollisionWorld* world, const btConvexShape* castShape,
+                                      const btTransform& from, const btTransform& to, btCollisionWorld::ConvexResultCallback& callback)
+{
+    btVector3 linVel, angVel;
+    btTransformUtil::calculateVelocity(from, to, btScalar(1), linVel, angVel);
+    btTransform rotation;
+    rotation.setIdentity();
+    rotation.setRotation(from.getRotation());
+    btVector3 shapeMin, shapeMax;
+    castShape->calculateTemporalAabb(rotation, btVector3(0, 0, 0), angVel, btScalar(1), shapeMin, shapeMax);
+
+    btVector3 sweptMin = shapeMin + from.getOrigin();
+    btVector3 sweptMax = shapeMax + from.getOrigin();
+    sweptMin.setMin(shapeMin + to.getOrigin());
+    sweptMax.setMax(shapeMax + to.getOrigin());
+    const btDbvtVolume bounds = btDbvtVolume::FromMM(sweptMin, sweptMax);
+
+    // The PhysicsSystem always creates a btDbvtBroadphase
+    const btDbvtBroadphase* broadphase = static_cast<const btDbvtBroadphase*>(world->getBroadphase());
+    SweepCollider collider(castShape, from, to, callback);
+    for (int i = 0; i < 2; ++i)
+    {
+        if (broadphase->m_sets[i].m_root)
+            broadphase->m_sets[i].collideTV(broadphase->m_sets[i].m_root, bounds, collider);
+    }
+}
+
+void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world, bool threadSafe)
 {
     const btVector3 btstart = toBullet(start);
     const btVector3 btend = toBullet(end);
@@ -67,7 +127,10 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
 
     const btCollisionShape *shape = actor->getCollisionShape();
     assert(shape->isConvex());
-    world->convexSweepTest(static_cast<const btConvexShape*>(shape),
+    if (threadSafe)
+        threadSafeConvexSweepTest(world, static_cast<const btConvexShape*>(shape), from, to, newTraceCallback);
+    else
+        world->convexSweepTest(static_cast<const btConvexShape*>(shape),
                                                from, to, newTraceCallback);
 
     // Copy the hit data over to our trace results struct:
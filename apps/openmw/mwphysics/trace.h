@@ -20,7 +20,9 @@ namespace MWPhysics
 
         float mFraction;
 
-        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
+        /// @param threadSafe Don't use Bullet's own sweep test, whose broadphase traversal shares state between callers.
+        /// Allows several threads to trace at once, as long as none of them modifies the collision world.
+        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world, bool threadSafe = false);
         void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
     };
 }
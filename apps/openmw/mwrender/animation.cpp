@@ -114,55 +114,42 @@ namespace
         NodeMap& mMap;
     };
 
-    NifOsg::TextKeyMap::const_iterator findGroupStart(const NifOsg::TextKeyMap &keys, const std::string &groupname)
-    {
-        NifOsg::TextKeyMap::const_iterator iter(keys.begin());
-        for(;iter != keys.end();++iter)
-        {
-            if(iter->second.compare(0, groupname.size(), groupname) == 0 &&
-               iter->second.compare(groupname.size(), 2, ": ") == 0)
-                break;
-        }
-        return iter;
-    }
-
-    float calcAnimVelocity(const std::multimap<float, std::string>& keys,
+    float calcAnimVelocity(const NifOsg::TextKeyMap& keys,
                                       NifOsg::KeyframeController *nonaccumctrl, const osg::Vec3f& accum, const std::string &groupname)
     {
-        const std::string start = groupname+": start";
-        const std::string loopstart = groupname+": loop start";
-        const std::string loopstop = groupname+": loop stop";
-        const std::string stop = groupname+": stop";
         float starttime = std::numeric_limits<float>::max();
         float stoptime = 0.0f;
 
+        const NifOsg::TextKeyMap::Group* group = keys.getGroup(groupname);
+        if (!group)
+            return 0.0f;
+
         // Pick the last Loop Stop key and the last Loop Start key.
         // This is required because of broken text keys in AshVampire.nif.
         // It has *two* WalkForward: Loop Stop keys at different times, the first one is used for stopping playback
         // but the animation velocity calculation uses the second one.
         // As result the animation velocity calculation is not correct, and this incorrect velocity must be replicated,
         // because otherwise the Creature's Speed (dagoth uthol) would not be sufficient to move fast enough.
-        NifOsg::TextKeyMap::const_reverse_iterator keyiter(keys.rbegin());
-        while(keyiter != keys.rend())
+        NifOsg::TextKeyMap::Group::const_reverse_iterator keyiter(group->rbegin());
+        for(;keyiter != group->rend();++keyiter)
         {
-            if(keyiter->second == start || keyiter->second == loopstart)
+            const NifOsg::TextKey& key = keys[*keyiter];
+            if(key.mType == NifOsg::TextKey::Type_Start || key.mType == NifOsg::TextKey::Type_LoopStart)
             {
-                starttime = keyiter->first;
+                starttime = key.mTime;
                 break;
             }
-            ++keyiter;
         }
-        keyiter = keys.rbegin();
-        while(keyiter != keys.rend())
+        for(keyiter = group->rbegin();keyiter != group->rend();++keyiter)
         {
-            if (keyiter->second == stop)
-                stoptime = keyiter->first;
-            else if (keyiter->second == loopstop)
+            const NifOsg::TextKey& key = keys[*keyiter];
+            if (key.mType == NifOsg::TextKey::Type_Stop)
+                stoptime = key.mTime;
+            else if (key.mType == NifOsg::TextKey::Type_LoopStop)
             {
-                stoptime = keyiter->first;
+                stoptime = key.mTime;
                 break;
             }
-            ++keyiter;
         }
 
         if(stoptime > starttime)
@@ -427,7 +414,7 @@ namespace MWRender
 
         ControllerMap mControllerMap[Animation::sNumBlendMasks];
 
-        const std::multimap<float, std::string>& getTextKeys() const;
+        const NifOsg::TextKeyMap& getTextKeys() const;
     };
 
     class ResetAccumRootCallback : public osg::NodeCallback
@@ -541,7 +528,7 @@ namespace MWRender
         return 0;
     }
 
-    const std::multimap<float, std::string> &Animation::AnimSource::getTextKeys() const
+    const NifOsg::TextKeyMap &Animation::AnimSource::getTextKeys() const
     {
         return mKeyframes->mTextKeys;
     }
@@ -662,8 +649,7 @@ namespace MWRender
         AnimSourceList::const_iterator iter(mAnimSources.begin());
         for(;iter != mAnimSources.end();++iter)
         {
-            const NifOsg::TextKeyMap &keys = (*iter)->getTextKeys();
-            if(findGroupStart(keys, anim) != keys.end())
+            if((*iter)->getTextKeys().getGroup(anim))
                 return true;
         }
 
@@ -676,9 +662,9 @@ namespace MWRender
         {
             const NifOsg::TextKeyMap &keys = (*iter)->getTextKeys();
 
-            NifOsg::TextKeyMap::const_iterator found = findGroupStart(keys, groupname);
-            if(found != keys.end())
-                return found->first;
+            const NifOsg::TextKeyMap::Group* group = keys.getGroup(groupname);
+            if(group)
+                return keys[group->front()].mTime;
         }
         return -1.f;
     }
@@ -687,34 +673,21 @@ namespace MWRender
     {
         for(AnimSourceList::const_reverse_iterator iter(mAnimSources.rbegin()); iter != mAnimSources.rend(); ++iter)
         {
-            const NifOsg::TextKeyMap &keys = (*iter)->getTextKeys();
-
-            for(NifOsg::TextKeyMap::const_iterator iterKey(keys.begin()); iterKey != keys.end(); ++iterKey)
-            {
-                if(iterKey->second.compare(0, textKey.size(), textKey) == 0)
-                    return iterKey->first;
-            }
+            float time = (*iter)->getTextKeys().getTime(textKey);
+            if(time >= 0.f)
+                return time;
         }
 
         return -1.f;
     }
 
-    void Animation::handleTextKey(AnimState &state, const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map)
+    void Animation::handleTextKey(AnimState &state, const std::string &groupname, NifOsg::TextKeyMap::const_iterator key,
+                       const NifOsg::TextKeyMap& map)
     {
-        const std::string &evt = key->second;
-
-        size_t off = groupname.size()+2;
-        size_t len = evt.size() - off;
-
-        if(evt.compare(0, groupname.size(), groupname) == 0 &&
-           evt.compare(groupname.size(), 2, ": ") == 0)
-        {
-            if(evt.compare(off, len, "loop start") == 0)
-                state.mLoopStartTime = key->first;
-            else if(evt.compare(off, len, "loop stop") == 0)
-                state.mLoopStopTime = key->first;
-        }
+        if(key->mType == NifOsg::TextKey::Type_LoopStart && key->mGroup == groupname)
+            state.mLoopStartTime = key->mTime;
+        else if(key->mType == NifOsg::TextKey::Type_LoopStop && key->mGroup == groupname)
+            state.mLoopStopTime = key->mTime;
 
         if (mTextKeyListener)
         {
@@ -724,7 +697,7 @@ namespace MWRender
             }
             catch (std::exception& e)
             {
-                std::cerr << "Error handling text key " << evt << ": " << e.what() << std::endl;
+                std::cerr << "Error handling text key " << key->mText << ": " << e.what() << std::endl;
             }
         }
     }
@@ -777,8 +750,8 @@ namespace MWRender
 
                 if (state.mPlaying)
                 {
-                    NifOsg::TextKeyMap::const_iterator textkey(textkeys.lower_bound(state.getTime()));
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    NifOsg::TextKeyMap::const_iterator textkey(textkeys.lowerBound(state.getTime()));
+                    while(textkey != textkeys.end() && textkey->mTime <= state.getTime())
                     {
                         handleTextKey(state, groupname, textkey, textkeys);
                         ++textkey;
@@ -793,8 +766,8 @@ namespace MWRender
                     if(state.getTime() >= state.mLoopStopTime)
                         break;
 
-                    NifOsg::TextKeyMap::const_iterator textkey(textkeys.lower_bound(state.getTime()));
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    NifOsg::TextKeyMap::const_iterator textkey(textkeys.lowerBound(state.getTime()));
+                    while(textkey != textkeys.end() && textkey->mTime <= state.getTime())
                     {
                         handleTextKey(state, groupname, textkey, textkeys);
                         ++textkey;
@@ -810,74 +783,68 @@ namespace MWRender
 
     bool Animation::reset(AnimState &state, const NifOsg::TextKeyMap &keys, const std::string &groupname, const std::string &start, const std::string &stop, float startpoint, bool loopfallback)
     {
+        const NifOsg::TextKeyMap::Group* group = keys.getGroup(groupname);
+        if (!group)
+            return false;
+
         // Look for text keys in reverse. This normally wouldn't matter, but for some reason undeadwolf_2.nif has two
         // separate walkforward keys, and the last one is supposed to be used.
-        NifOsg::TextKeyMap::const_reverse_iterator groupend(keys.rbegin());
-        for(;groupend != keys.rend();++groupend)
-        {
-            if(groupend->second.compare(0, groupname.size(), groupname) == 0 &&
-               groupend->second.compare(groupname.size(), 2, ": ") == 0)
-                break;
-        }
-
-        std::string starttag = groupname+": "+start;
-        NifOsg::TextKeyMap::const_reverse_iterator startkey(groupend);
-        while(startkey != keys.rend() && startkey->second != starttag)
+        NifOsg::TextKeyMap::Group::const_reverse_iterator startkey(group->rbegin());
+        while(startkey != group->rend() && keys[*startkey].mEvent != start)
             ++startkey;
-        if(startkey == keys.rend() && start == "loop start")
+        if(startkey == group->rend() && start == "loop start")
         {
-            starttag = groupname+": start";
-            startkey = groupend;
-            while(startkey != keys.rend() && startkey->second != starttag)
+            startkey = group->rbegin();
+            while(startkey != group->rend() && keys[*startkey].mType != NifOsg::TextKey::Type_Start)
                 ++startkey;
         }
-        if(startkey == keys.rend())
+        if(startkey == group->rend())
             return false;
 
-        const std::string stoptag = groupname+": "+stop;
-        NifOsg::TextKeyMap::const_reverse_iterator stopkey(groupend);
-        while(stopkey != keys.rend()
+        NifOsg::TextKeyMap::Group::const_reverse_iterator stopkey(group->rbegin());
+        while(stopkey != group->rend()
               // We have to ignore extra garbage at the end.
               // The Scrib's idle3 animation has "Idle3: Stop." instead of "Idle3: Stop".
               // Why, just why? :(
-              && (stopkey->second.size() < stoptag.size() || stopkey->second.compare(0,stoptag.size(), stoptag) != 0))
+              && keys[*stopkey].mEvent.compare(0, stop.size(), stop) != 0)
             ++stopkey;
-        if(stopkey == keys.rend())
+        if(stopkey == group->rend())
             return false;
 
-        if(startkey->first > stopkey->first)
+        const NifOsg::TextKey& startKey = keys[*startkey];
+        const NifOsg::TextKey& stopKey = keys[*stopkey];
+
+        if(startKey.mTime > stopKey.mTime)
             return false;
 
-        state.mStartTime = startkey->first;
+        state.mStartTime = startKey.mTime;
         if (loopfallback)
         {
-            state.mLoopStartTime = startkey->first;
-            state.mLoopStopTime = stopkey->first;
+            state.mLoopStartTime = startKey.mTime;
+            state.mLoopStopTime = stopKey.mTime;
         }
         else
         {
-            state.mLoopStartTime = startkey->first;
+            state.mLoopStartTime = startKey.mTime;
             state.mLoopStopTime = std::numeric_limits<float>::max();
         }
-        state.mStopTime = stopkey->first;
+        state.mStopTime = stopKey.mTime;
 
         state.setTime(state.mStartTime + ((state.mStopTime - state.mStartTime) * startpoint));
 
         // mLoopStartTime and mLoopStopTime normally get assigned when encountering these keys while playing the animation
         // (see handleTextKey). But if startpoint is already past these keys, or start time is == stop time, we need to assign them now.
-        const std::string loopstarttag = groupname+": loop start";
-        const std::string loopstoptag = groupname+": loop stop";
-
-        NifOsg::TextKeyMap::const_reverse_iterator key(groupend);
-        for (; key != startkey && key != keys.rend(); ++key)
+        NifOsg::TextKeyMap::Group::const_reverse_iterator key(group->rbegin());
+        for (; key != startkey; ++key)
         {
-            if (key->first > state.getTime())
+            const NifOsg::TextKey& textKey = keys[*key];
+            if (textKey.mTime > state.getTime())
                 continue;
 
-            if (key->second == loopstarttag)
-                state.mLoopStartTime = key->first;
-            else if (key->second == loopstoptag)
-                state.mLoopStopTime = key->first;
+            if (textKey.mType == NifOsg::TextKey::Type_LoopStart)
+                state.mLoopStartTime = textKey.mTime;
+            else if (textKey.mType == NifOsg::TextKey::Type_LoopStop)
+                state.mLoopStopTime = textKey.mTime;
         }
 
         return true;
@@ -1038,8 +1005,7 @@ namespace MWRender
         AnimSourceList::const_reverse_iterator animsrc(mAnimSources.rbegin());
         for(;animsrc != mAnimSources.rend();++animsrc)
         {
-            const NifOsg::TextKeyMap &keys = (*animsrc)->getTextKeys();
-            if(findGroupStart(keys, groupname) != keys.end())
+            if((*animsrc)->getTextKeys().getGroup(groupname))
                 break;
         }
         if(animsrc == mAnimSources.rend())
@@ -1118,7 +1084,7 @@ namespace MWRender
             }
 
             const NifOsg::TextKeyMap &textkeys = state.mSource->getTextKeys();
-            NifOsg::TextKeyMap::const_iterator textkey(textkeys.upper_bound(state.getTime()));
+            NifOsg::TextKeyMap::const_iterator textkey(textkeys.upperBound(state.getTime()));
 
             float timepassed = duration * state.mSpeedMult;
             while(state.mPlaying)
@@ -1126,7 +1092,7 @@ namespace MWRender
                 if (!state.shouldLoop())
                 {
                     float targetTime = state.getTime() + timepassed;
-                    if(textkey == textkeys.end() || textkey->first > targetTime)
+                    if(textkey == textkeys.end() || textkey->mTime > targetTime)
                     {
                         if(mAccumCtrl && state.mTime == mAnimationTimePtr[0]->getTimePtr())
                             updatePosition(state.getTime(), targetTime, movement);
@@ -1135,14 +1101,14 @@ namespace MWRender
                     else
                     {
                         if(mAccumCtrl && state.mTime == mAnimationTimePtr[0]->getTimePtr())
-                            updatePosition(state.getTime(), textkey->first, movement);
-                        state.setTime(textkey->first);
+                            updatePosition(state.getTime(), textkey->mTime, movement);
+                        state.setTime(textkey->mTime);
                     }
 
                     state.mPlaying = (state.getTime() < state.mStopTime);
                     timepassed = targetTime - state.getTime();
 
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    while(textkey != textkeys.end() && textkey->mTime <= state.getTime())
                     {
                         handleTextKey(state, stateiter->first, textkey, textkeys);
                         ++textkey;
@@ -1154,8 +1120,8 @@ namespace MWRender
                     state.setTime(state.mLoopStartTime);
                     state.mPlaying = true;
 
-                    textkey = textkeys.lower_bound(state.getTime());
-                    while(textkey != textkeys.end() && textkey->first <= state.getTime())
+                    textkey = textkeys.lowerBound(state.getTime());
+                    while(textkey != textkeys.end() && textkey->mTime <= state.getTime())
                     {
                         handleTextKey(state, stateiter->first, textkey, textkeys);
                         ++textkey;
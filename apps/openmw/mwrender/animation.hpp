@@ -4,6 +4,7 @@
 #include "../mwworld/ptr.hpp"
 
 #include <components/sceneutil/controller.hpp>
+#include <components/nifosg/textkeymap.hpp>
 
 namespace ESM
 {
@@ -136,8 +137,8 @@ public:
     class TextKeyListener
     {
     public:
-        virtual void handleTextKey(const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                           const std::multimap<float, std::string>& map) = 0;
+        virtual void handleTextKey(const std::string &groupname, NifOsg::TextKeyMap::const_iterator key,
+                           const NifOsg::TextKeyMap& map) = 0;
     };
 
     void setTextKeyListener(TextKeyListener* listener);
@@ -294,12 +295,12 @@ protected:
      * the marker is not found, or if the markers are the same, it returns
      * false.
      */
-    bool reset(AnimState &state, const std::multimap<float, std::string> &keys,
+    bool reset(AnimState &state, const NifOsg::TextKeyMap &keys,
                const std::string &groupname, const std::string &start, const std::string &stop,
                float startpoint, bool loopfallback);
 
-    void handleTextKey(AnimState &state, const std::string &groupname, const std::multimap<float, std::string>::const_iterator &key,
-                       const std::multimap<float, std::string>& map);
+    void handleTextKey(AnimState &state, const std::string &groupname, NifOsg::TextKeyMap::const_iterator key,
+                       const NifOsg::TextKeyMap& map);
 
     /** Sets the root model of the object.
      *
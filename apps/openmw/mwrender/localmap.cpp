@@ -679,8 +679,26 @@ void LocalMap::MapSegment::loadFogOfWar(const ESM::FogTexture &esm)
         return;
     }
 
-    // TODO: deprecate tga and use raw data instead
+    if (esm.mRaw)
+    {
+        initFogOfWar();
+
+        if (data.size() != static_cast<size_t>(sFogOfWarResolution*sFogOfWarResolution))
+        {
+            std::cerr << "Error: Failed to read fog: unexpected size " << data.size() << std::endl;
+            return;
+        }
+
+        unsigned char* image = mFogOfWarImage->data();
+        for (size_t i=0; i<data.size(); ++i)
+            image[i*4+3] = static_cast<unsigned char>(data[i]);
 
+        mFogOfWarImage->dirty();
+        mHasFogState = true;
+        return;
+    }
+
+    // Saved games of format 5 and earlier store the fog as TGA
     osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("tga");
     if (!readerwriter)
     {
@@ -711,27 +729,12 @@ void LocalMap::MapSegment::saveFogOfWar(ESM::FogTexture &fog) const
     if (!mFogOfWarImage)
         return;
 
-    std::ostringstream ostream;
-
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("tga");
-    if (!readerwriter)
-    {
-        std::cerr << "Error: Unable to write fog, can't find a tga ReaderWriter" << std::endl;
-        return;
-    }
-
-    // extra flips are unfortunate, but required for compatibility with older versions
-    mFogOfWarImage->flipVertical();
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*mFogOfWarImage, ostream);
-    if (!result.success())
-    {
-        std::cerr << "Error: Unable to write fog: " << result.message() << " code " << result.status() << std::endl;
-        return;
-    }
-    mFogOfWarImage->flipVertical();
-
-    std::string data = ostream.str();
-    fog.mImageData = std::vector<char>(data.begin(), data.end());
+    // Only the alpha channel is used, the colour is always black
+    const unsigned char* image = mFogOfWarImage->data();
+    fog.mImageData.resize(sFogOfWarResolution*sFogOfWarResolution);
+    for (size_t i=0; i<fog.mImageData.size(); ++i)
+        fog.mImageData[i] = static_cast<char>(image[i*4+3]);
+    fog.mRaw = true;
 }
 
 }
@@ -794,14 +794,14 @@ bool NpcAnimation::addOrReplaceIndividualPart(ESM::PartReferenceType type, int g
                     {
                         for (NifOsg::TextKeyMap::const_iterator it = keys->mTextKeys.begin(); it != keys->mTextKeys.end(); ++it)
                         {
-                            if (Misc::StringUtils::ciEqual(it->second, "talk: start"))
-                                mHeadAnimationTime->setTalkStart(it->first);
-                            if (Misc::StringUtils::ciEqual(it->second, "talk: stop"))
-                                mHeadAnimationTime->setTalkStop(it->first);
-                            if (Misc::StringUtils::ciEqual(it->second, "blink: start"))
-                                mHeadAnimationTime->setBlinkStart(it->first);
-                            if (Misc::StringUtils::ciEqual(it->second, "blink: stop"))
-                                mHeadAnimationTime->setBlinkStop(it->first);
+                            if (it->mGroup == "talk" && it->mType == NifOsg::TextKey::Type_Start)
+                                mHeadAnimationTime->setTalkStart(it->mTime);
+                            if (it->mGroup == "talk" && it->mType == NifOsg::TextKey::Type_Stop)
+                                mHeadAnimationTime->setTalkStop(it->mTime);
+                            if (it->mGroup == "blink" && it->mType == NifOsg::TextKey::Type_Start)
+                                mHeadAnimationTime->setBlinkStart(it->mTime);
+                            if (it->mGroup == "blink" && it->mType == NifOsg::TextKey::Type_Stop)
+                                mHeadAnimationTime->setBlinkStop(it->mTime);
                         }
 
                         break;
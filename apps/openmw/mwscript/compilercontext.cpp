@@ -30,24 +30,26 @@ namespace MWScript
         return MWBase::Environment::get().getWorld()->getGlobalVariableType (name);
     }
 
-    std::pair<char, bool> CompilerContext::getMemberType (const std::string& name,
-        const std::string& id) const
+    std::string CompilerContext::getMemberScript (const std::string& id, bool& reference) const
     {
-        std::string script;
-        bool reference = false;
-
         if (const ESM::Script *scriptRecord =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Script>().search (id))
         {
-            script = scriptRecord->mId;
+            reference = false;
+            return scriptRecord->mId;
         }
-        else
-        {
-            MWWorld::ManualRef ref (MWBase::Environment::get().getWorld()->getStore(), id);
 
-            script = ref.getPtr().getClass().getScript (ref.getPtr());
-            reference = true;
-        }
+        MWWorld::ManualRef ref (MWBase::Environment::get().getWorld()->getStore(), id);
+
+        reference = true;
+        return ref.getPtr().getClass().getScript (ref.getPtr());
+    }
+
+    std::pair<char, bool> CompilerContext::getMemberType (const std::string& name,
+        const std::string& id) const
+    {
+        bool reference = false;
+        std::string script = getMemberScript (id, reference);
 
         char type = ' ';
 
@@ -58,6 +60,23 @@ namespace MWScript
         return std::make_pair (type, reference);
     }
 
+    int CompilerContext::getGlobalSlot (const std::string& name) const
+    {
+        return MWBase::Environment::get().getWorld()->getGlobalSlot (name);
+    }
+
+    int CompilerContext::getMemberIndex (const std::string& name, const std::string& id) const
+    {
+        bool reference = false;
+        std::string script = getMemberScript (id, reference);
+
+        if (script.empty())
+            return -1;
+
+        return MWBase::Environment::get().getScriptManager()->getLocals (script).getIndex (
+            Misc::StringUtils::lowerCase (name));
+    }
+
     bool CompilerContext::isId (const std::string& name) const
     {
         const MWWorld::ESMStore &store =
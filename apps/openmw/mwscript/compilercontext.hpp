@@ -20,6 +20,12 @@ namespace MWScript
 
             Type mType;
 
+            /// Return the ID of the script, whose member variables are accessed through \a id, or an
+            /// empty string if there is none.
+            ///
+            /// \param reference Set to true, if \a id is the ID of a reference.
+            std::string getMemberScript (const std::string& id, bool& reference) const;
+
         public:
 
             CompilerContext (Type type);
@@ -37,6 +43,13 @@ namespace MWScript
             /// \return first: 'l: long, 's': short, 'f': float, ' ': does not exist.
             /// second: true: script of reference
 
+            virtual int getGlobalSlot (const std::string& name) const;
+            ///< Return a number that identifies global variable \a name at runtime in place of its name.
+
+            virtual int getMemberIndex (const std::string& name, const std::string& id) const;
+            ///< Return index of member variable \a name among the variables of its type in script \a id or
+            /// in script of reference of \a id.
+
             virtual bool isId (const std::string& name) const;
             ///< Does \a name match an ID, that can be referenced?
 
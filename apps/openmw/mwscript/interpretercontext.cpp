@@ -135,6 +135,37 @@ namespace MWScript
         throw std::runtime_error (stream.str().c_str());
     }
 
+    void InterpreterContext::checkLocalVariableIndex (const Locals& locals, const std::string& scriptId,
+        int index, char type) const
+    {
+        std::size_t size = 0;
+
+        switch (type)
+        {
+            case 's': size = locals.mShorts.size(); break;
+            case 'l': size = locals.mLongs.size(); break;
+            case 'f': size = locals.mFloats.size(); break;
+        }
+
+        if (index>=0 && index<static_cast<int> (size))
+            return;
+
+        std::ostringstream stream;
+
+        stream << "Failed to access ";
+
+        switch (type)
+        {
+            case 's': stream << "short"; break;
+            case 'l': stream << "long"; break;
+            case 'f': stream << "float"; break;
+        }
+
+        stream << " member variable #" << index << " in script " << scriptId;
+
+        throw std::runtime_error (stream.str().c_str());
+    }
+
 
     InterpreterContext::InterpreterContext (
         MWScript::Locals *locals, const MWWorld::Ptr& reference, const std::string& targetId)
@@ -244,6 +275,37 @@ namespace MWScript
         MWBase::Environment::get().getWorld()->setGlobalFloat (name, value);
     }
 
+    int InterpreterContext::getGlobalShort (int slot) const
+    {
+        return MWBase::Environment::get().getWorld()->getGlobalInt (slot);
+    }
+
+    int InterpreterContext::getGlobalLong (int slot) const
+    {
+        // a global long is internally a float.
+        return MWBase::Environment::get().getWorld()->getGlobalInt (slot);
+    }
+
+    float InterpreterContext::getGlobalFloat (int slot) const
+    {
+        return MWBase::Environment::get().getWorld()->getGlobalFloat (slot);
+    }
+
+    void InterpreterContext::setGlobalShort (int slot, int value)
+    {
+        MWBase::Environment::get().getWorld()->setGlobalInt (slot, value);
+    }
+
+    void InterpreterContext::setGlobalLong (int slot, int value)
+    {
+        MWBase::Environment::get().getWorld()->setGlobalInt (slot, value);
+    }
+
+    void InterpreterContext::setGlobalFloat (int slot, float value)
+    {
+        MWBase::Environment::get().getWorld()->setGlobalFloat (slot, value);
+    }
+
     std::vector<std::string> InterpreterContext::getGlobals() const
     {
         std::vector<std::string> ids;
@@ -567,6 +629,72 @@ namespace MWScript
         locals.mFloats[findLocalVariableIndex (scriptId, name, 'f')] = value;
     }
 
+    int InterpreterContext::getMemberShort (const std::string& id, int index, bool global) const
+    {
+        std::string scriptId (id);
+
+        const Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 's');
+
+        return locals.mShorts[index];
+    }
+
+    int InterpreterContext::getMemberLong (const std::string& id, int index, bool global) const
+    {
+        std::string scriptId (id);
+
+        const Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 'l');
+
+        return locals.mLongs[index];
+    }
+
+    float InterpreterContext::getMemberFloat (const std::string& id, int index, bool global) const
+    {
+        std::string scriptId (id);
+
+        const Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 'f');
+
+        return locals.mFloats[index];
+    }
+
+    void InterpreterContext::setMemberShort (const std::string& id, int index, int value, bool global)
+    {
+        std::string scriptId (id);
+
+        Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 's');
+
+        locals.mShorts[index] = value;
+    }
+
+    void InterpreterContext::setMemberLong (const std::string& id, int index, int value, bool global)
+    {
+        std::string scriptId (id);
+
+        Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 'l');
+
+        locals.mLongs[index] = value;
+    }
+
+    void InterpreterContext::setMemberFloat (const std::string& id, int index, float value, bool global)
+    {
+        std::string scriptId (id);
+
+        Locals& locals = getMemberLocals (scriptId, global);
+
+        checkLocalVariableIndex (locals, scriptId, index, 'f');
+
+        locals.mFloats[index] = value;
+    }
+
     MWWorld::Ptr InterpreterContext::getReference(bool required)
     {
         return getReferenceImp ("", true, required);
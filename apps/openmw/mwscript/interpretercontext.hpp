@@ -47,6 +47,10 @@ namespace MWScript
             int findLocalVariableIndex (const std::string& scriptId, const std::string& name,
                 char type) const;
 
+            /// Throws an exception if \a index is not the index of a local variable of type \a type.
+            void checkLocalVariableIndex (const Locals& locals, const std::string& scriptId, int index,
+                char type) const;
+
         public:
 
             InterpreterContext (MWScript::Locals *locals, const MWWorld::Ptr& reference,
@@ -87,6 +91,18 @@ namespace MWScript
 
             virtual void setGlobalFloat (const std::string& name, float value);
 
+            virtual int getGlobalShort (int slot) const;
+
+            virtual int getGlobalLong (int slot) const;
+
+            virtual float getGlobalFloat (int slot) const;
+
+            virtual void setGlobalShort (int slot, int value);
+
+            virtual void setGlobalLong (int slot, int value);
+
+            virtual void setGlobalFloat (int slot, float value);
+
             virtual std::vector<std::string> getGlobals () const;
 
             virtual char getGlobalType (const std::string& name) const;
@@ -149,6 +165,18 @@ namespace MWScript
 
             virtual void setMemberFloat (const std::string& id, const std::string& name, float value, bool global);
 
+            virtual int getMemberShort (const std::string& id, int index, bool global) const;
+
+            virtual int getMemberLong (const std::string& id, int index, bool global) const;
+
+            virtual float getMemberFloat (const std::string& id, int index, bool global) const;
+
+            virtual void setMemberShort (const std::string& id, int index, int value, bool global);
+
+            virtual void setMemberLong (const std::string& id, int index, int value, bool global);
+
+            virtual void setMemberFloat (const std::string& id, int index, float value, bool global);
+
             MWWorld::Ptr getReference(bool required=true);
             ///< Reference, that the script is running from (can be empty)
 
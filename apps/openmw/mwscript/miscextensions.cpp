@@ -268,6 +268,36 @@ namespace MWScript
                 }
         };
 
+        class OpToggleScriptProfiler : public Interpreter::Opcode0
+        {
+            public:
+
+                virtual void execute (Interpreter::Runtime& runtime)
+                {
+                    bool enabled =
+                        MWBase::Environment::get().getScriptManager()->toggleProfiling();
+
+                    runtime.getContext().report (enabled ?
+                        "Script Profiler -> On" : "Script Profiler -> Off");
+                }
+        };
+
+        class OpReportScriptProfile : public Interpreter::Opcode0
+        {
+            public:
+
+                virtual void execute (Interpreter::Runtime& runtime)
+                {
+                    MWBase::ScriptManager *scriptManager = MWBase::Environment::get().getScriptManager();
+
+                    std::stringstream str;
+                    scriptManager->reportProfile (str, 10);
+                    str << std::endl << "Written to " << scriptManager->writeProfile();
+
+                    runtime.getContext().report (str.str());
+                }
+        };
+
         class OpTogglePathgrid : public Interpreter::Opcode0
         {
         public:
@@ -1395,6 +1425,8 @@ namespace MWScript
             interpreter.installSegment3 (Compiler::Misc::opcodeShowSceneGraph, new OpShowSceneGraph<ImplicitRef>);
             interpreter.installSegment3 (Compiler::Misc::opcodeShowSceneGraphExplicit, new OpShowSceneGraph<ExplicitRef>);
             interpreter.installSegment5 (Compiler::Misc::opcodeToggleBorders, new OpToggleBorders);
+            interpreter.installSegment5 (Compiler::Misc::opcodeToggleScriptProfiler, new OpToggleScriptProfiler);
+            interpreter.installSegment5 (Compiler::Misc::opcodeReportScriptProfile, new OpReportScriptProfile);
         }
     }
 }
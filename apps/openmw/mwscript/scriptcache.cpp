@@ -0,0 +1,221 @@
+#include "scriptcache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    /// Increment when the layout of the cache or the bytecode format changes.
+    const int sCacheVersion = 1;
+
+    const char* sKeyRecord = "CKEY";
+    const char* sScriptRecord = "SCPT";
+
+    const char sLocalTypes[] = { 's', 'l', 'f' };
+    const char* sLocalSubRecords[] = { "LOCS", "LOCL", "LOCF" };
+}
+
+namespace MWScript
+{
+    ScriptCache::ScriptCache (const boost::filesystem::path& cacheFile,
+        const std::vector<boost::filesystem::path>& contentFiles, const std::string& engineVersion)
+    : mCacheFile (cacheFile), mChanged (false)
+    {
+        std::ostringstream key;
+        key << sCacheVersion << "\n" << engineVersion << "\n";
+        for (std::vector<boost::filesystem::path>::const_iterator iter (contentFiles.begin());
+            iter!=contentFiles.end(); ++iter)
+        {
+            key << iter->string() << "|" << boost::filesystem::file_size (*iter)
+                << "|" << boost::filesystem::last_write_time (*iter) << "\n";
+        }
+        mKey = key.str();
+    }
+
+    void ScriptCache::read()
+    {
+        mEntries.clear();
+        mChanged = false;
+
+        if (!boost::filesystem::exists (mCacheFile))
+            return;
+
+        try
+        {
+            ESM::ESMReader reader;
+            reader.open (mCacheFile.string());
+
+            if (!reader.hasMoreRecs() || reader.getRecName()!=sKeyRecord)
+                reader.fail ("Missing cache key");
+
+            reader.getRecHeader();
+
+            if (reader.getHNString ("DATA")!=mKey)
+            {
+                // Written for other content files. Not an error, the cache is rebuilt on the next write.
+                mChanged = true;
+                return;
+            }
+
+            while (reader.hasMoreRecs())
+            {
+                if (reader.getRecName()!=sScriptRecord)
+                    reader.fail ("Unexpected record");
+
+                reader.getRecHeader();
+
+                std::string name = reader.getHNString ("NAME");
+
+                Entry entry;
+                reader.getHNT (entry.mSourceHash, "HASH");
+
+                reader.getSubNameIs ("CODE");
+                reader.getSubHeader();
+                std::size_t size = reader.getSubSize();
+                if (size % sizeof (Interpreter::Type_Code))
+                    reader.fail ("Invalid code size");
+                entry.mCode.resize (size / sizeof (Interpreter::Type_Code));
+                if (!entry.mCode.empty())
+                    reader.getExact (&entry.mCode[0], static_cast<int> (size));
+
+                for (int i=0; i<3; ++i)
+                    while (reader.isNextSub (sLocalSubRecords[i]))
+                        entry.mLocals.declare (sLocalTypes[i], reader.getHString());
+
+                if (reader.hasMoreSubs())
+                    reader.fail ("Unexpected subrecord");
+
+                mEntries.insert (std::make_pair (Misc::StringUtils::lowerCase (name), entry));
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr
+                << "Warning: failed to read " << mCacheFile.string() << " (" << e.what()
+                << "). The cache has been removed and will be rebuilt." << std::endl;
+
+            mEntries.clear();
+            mChanged = true;
+
+            boost::system::error_code ec;
+            boost::filesystem::remove (mCacheFile, ec);
+        }
+    }
+
+    void ScriptCache::write()
+    {
+        if (!mChanged)
+            return;
+
+        // Write to a temporary file first, so that a crash can not leave a truncated cache behind
+        boost::filesystem::path tempFile = mCacheFile;
+        tempFile += ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories (mCacheFile.parent_path());
+
+            boost::filesystem::ofstream stream (tempFile, std::ios::binary);
+            if (!stream.is_open())
+                throw std::runtime_error ("can not open file for writing");
+
+            ESM::ESMWriter writer;
+            writer.setFormat (0);
+            writer.setAuthor ("");
+            writer.setDescription ("OpenMW compiled script cache");
+            writer.save (stream);
+
+            writer.startRecord (sKeyRecord);
+            writer.writeHNString ("DATA", mKey);
+            writer.endRecord (sKeyRecord);
+
+            for (std::map<std::string, Entry>::const_iterator iter (mEntries.begin());
+                iter!=mEntries.end(); ++iter)
+            {
+                const Entry& entry = iter->second;
+
+                writer.startRecord (sScriptRecord);
+                writer.writeHNString ("NAME", iter->first);
+                writer.writeHNT ("HASH", entry.mSourceHash);
+
+                writer.startSubRecord ("CODE");
+                if (!entry.mCode.empty())
+                    writer.write (reinterpret_cast<const char *> (&entry.mCode[0]),
+                        entry.mCode.size() * sizeof (Interpreter::Type_Code));
+                writer.endRecord ("CODE");
+
+                for (int i=0; i<3; ++i)
+                {
+                    const std::vector<std::string>& names = entry.mLocals.get (sLocalTypes[i]);
+                    for (std::vector<std::string>::const_iterator name (names.begin()); name!=names.end(); ++name)
+                        writer.writeHNString (sLocalSubRecords[i], *name);
+                }
+
+                writer.endRecord (sScriptRecord);
+            }
+
+            writer.close();
+
+            stream.close();
+            if (stream.fail())
+                throw std::runtime_error ("write error");
+
+            boost::filesystem::rename (tempFile, mCacheFile);
+
+            mChanged = false;
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Warning: failed to write " << mCacheFile.string() << ": " << e.what() << std::endl;
+
+            boost::system::error_code ec;
+            boost::filesystem::remove (tempFile, ec);
+        }
+    }
+
+    bool ScriptCache::get (const std::string& name, const std::string& source,
+        std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const
+    {
+        std::map<std::string, Entry>::const_iterator iter = mEntries.find (Misc::StringUtils::lowerCase (name));
+
+        if (iter==mEntries.end() || iter->second.mSourceHash!=hash (source))
+            return false;
+
+        code = iter->second.mCode;
+        locals = iter->second.mLocals;
+        return true;
+    }
+
+    void ScriptCache::add (const std::string& name, const std::string& source,
+        const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals)
+    {
+        Entry& entry = mEntries[Misc::StringUtils::lowerCase (name)];
+        entry.mSourceHash = hash (source);
+        entry.mCode = code;
+        entry.mLocals = locals;
+        mChanged = true;
+    }
+
+    uint64_t ScriptCache::hash (const std::string& source)
+    {
+        // FNV-1a
+        uint64_t value = 14695981039346656037ull;
+
+        for (std::string::const_iterator iter (source.begin()); iter!=source.end(); ++iter)
+        {
+            value ^= static_cast<unsigned char> (*iter);
+            value *= 1099511628211ull;
+        }
+
+        return value;
+    }
+}
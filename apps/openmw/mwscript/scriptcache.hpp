@@ -0,0 +1,64 @@
+#ifndef GAME_SCRIPT_SCRIPTCACHE_H
+#define GAME_SCRIPT_SCRIPTCACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <components/compiler/locals.hpp>
+
+#include <components/interpreter/types.hpp>
+
+namespace MWScript
+{
+    /// @brief Compiled scripts of previous runs, to skip compiling them again.
+    /// @par The compiled code refers to global variables by slot and to member variables by index, which depend
+    /// on all content files. The cache is therefore only used with the content files and the engine version
+    /// it was written for. In addition, each script is only taken from the cache if its source is unchanged.
+    class ScriptCache
+    {
+        public:
+
+            ScriptCache (const boost::filesystem::path& cacheFile,
+                const std::vector<boost::filesystem::path>& contentFiles, const std::string& engineVersion);
+
+            /// Load the cache file, if it was written for the current content files. Errors are logged, but
+            /// not fatal. A cache file that can not be read is removed.
+            void read();
+
+            /// Write the cache file, if scripts were added since it was read. Errors are logged, but not fatal.
+            void write();
+
+            /// \return Was \a name found with the same \a source?
+            bool get (const std::string& name, const std::string& source,
+                std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals) const;
+
+            void add (const std::string& name, const std::string& source,
+                const std::vector<Interpreter::Type_Code>& code, const Compiler::Locals& locals);
+
+        private:
+
+            struct Entry
+            {
+                uint64_t mSourceHash;
+                std::vector<Interpreter::Type_Code> mCode;
+                Compiler::Locals mLocals;
+            };
+
+            static uint64_t hash (const std::string& source);
+
+            boost::filesystem::path mCacheFile;
+
+            /// Identifies the cache format, the engine and the content files the cache was written for.
+            std::string mKey;
+
+            std::map<std::string, Entry> mEntries; // lower case script ID
+            bool mChanged;
+    };
+}
+
+#endif
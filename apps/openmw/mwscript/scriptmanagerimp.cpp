@@ -4,8 +4,16 @@
 #include <iostream>
 #include <sstream>
 #include <exception>
+#include <stdexcept>
 #include <algorithm>
 
+#include <boost/filesystem/fstream.hpp>
+
+#include <OpenThreads/ScopedLock>
+#include <OpenThreads/Thread>
+
+#include <osg/Timer>
+
 #include <components/esm/loadscpt.hpp>
 
 #include <components/misc/stringops.hpp>
@@ -15,9 +23,86 @@
 #include <components/compiler/exception.hpp>
 #include <components/compiler/quickfileparser.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include "../mwworld/esmstore.hpp"
 
 #include "extensions.hpp"
+#include "scriptcache.hpp"
+
+namespace
+{
+    bool compileScript (const ESM::Script& script, Compiler::FileParser& parser,
+        Compiler::StreamErrorHandler& errorHandler, const Compiler::Context& context, std::ostream& log,
+        std::vector<Interpreter::Type_Code>& code, Compiler::Locals& locals)
+    {
+        parser.reset();
+        errorHandler.reset();
+        errorHandler.setContext (script.mId);
+
+        bool success = true;
+        try
+        {
+            std::istringstream input (script.mScriptText);
+
+            Compiler::Scanner scanner (errorHandler, input, context.getExtensions());
+
+            scanner.scan (parser);
+
+            if (!errorHandler.isGood())
+                success = false;
+        }
+        catch (const Compiler::SourceException&)
+        {
+            // error has already been reported via error handler
+            success = false;
+        }
+        catch (const std::exception& error)
+        {
+            log << "Error: An exception has been thrown: " << error.what() << std::endl;
+            success = false;
+        }
+
+        if (!success)
+        {
+            log
+                << "Warning: compiling failed: " << script.mId << std::endl;
+            return false;
+        }
+
+        parser.getCode (code);
+        locals = parser.getLocals();
+        return true;
+    }
+
+    /// Compiles one script on a worker thread. Messages are collected, so that they can be printed in order.
+    class CompileScriptItem : public SceneUtil::WorkItem
+    {
+        public:
+
+            CompileScriptItem (const ESM::Script& script, Compiler::Context& context, int warningsMode)
+            : mScript (script), mContext (context), mWarningsMode (warningsMode), mSuccess (false)
+            {}
+
+            virtual void doWork()
+            {
+                Compiler::StreamErrorHandler errorHandler (mLog);
+                errorHandler.setWarningsMode (mWarningsMode);
+                Compiler::FileParser parser (errorHandler, mContext);
+
+                mSuccess = compileScript (mScript, parser, errorHandler, mContext, mLog, mCode, mLocals);
+            }
+
+            const ESM::Script& mScript;
+            Compiler::Context& mContext;
+            int mWarningsMode;
+
+            bool mSuccess;
+            std::vector<Interpreter::Type_Code> mCode;
+            Compiler::Locals mLocals;
+            std::ostringstream mLog;
+    };
+}
 
 namespace MWScript
 {
@@ -26,7 +111,7 @@ namespace MWScript
         const std::vector<std::string>& scriptBlacklist)
     : mErrorHandler (std::cerr), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mWarningsMode (warningsMode), mGlobalScripts (store)
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -37,52 +122,51 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
-    bool ScriptManager::compile (const std::string& name)
+    ScriptManager::~ScriptManager()
     {
-        mParser.reset();
-        mErrorHandler.reset();
+        if (mCache)
+            mCache->write();
+    }
 
-        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
-        {
-            mErrorHandler.setContext(name);
+    void ScriptManager::setCache (ScriptCache *cache)
+    {
+        mCache.reset (cache);
+    }
 
-            bool Success = true;
-            try
-            {
-                std::istringstream input (script->mScriptText);
+    void ScriptManager::setProfileFile (const std::string& file)
+    {
+        mProfileFile = file;
+    }
 
-                Compiler::Scanner scanner (mErrorHandler, input, mCompilerContext.getExtensions());
+    bool ScriptManager::getCached (const ESM::Script& script, CompiledScript& compiled) const
+    {
+        return mCache && mCache->get (script.mId, script.mScriptText, compiled.first, compiled.second);
+    }
 
-                scanner.scan (mParser);
+    void ScriptManager::addToCache (const ESM::Script& script, const CompiledScript& compiled)
+    {
+        if (mCache)
+            mCache->add (script.mId, script.mScriptText, compiled.first, compiled.second);
+    }
 
-                if (!mErrorHandler.isGood())
-                    Success = false;
-            }
-            catch (const Compiler::SourceException&)
-            {
-                // error has already been reported via error handler
-                Success = false;
-            }
-            catch (const std::exception& error)
-            {
-                std::cerr << "Error: An exception has been thrown: " << error.what() << std::endl;
-                Success = false;
-            }
+    bool ScriptManager::compile (const std::string& name)
+    {
+        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
+        {
+            CompiledScript compiled;
 
-            if (!Success)
+            if (!getCached (*script, compiled))
             {
-                std::cerr
-                    << "Warning: compiling failed: " << name << std::endl;
+                if (!compileScript (*script, mParser, mErrorHandler, mCompilerContext, std::cerr,
+                    compiled.first, compiled.second))
+                    return false;
+
+                addToCache (*script, compiled);
             }
 
-            if (Success)
-            {
-                std::vector<Interpreter::Type_Code> code;
-                mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+            mScripts.insert (std::make_pair (name, compiled));
 
-                return true;
-            }
+            return true;
         }
 
         return false;
@@ -117,7 +201,18 @@ namespace MWScript
                     mOpcodesInstalled = true;
                 }
 
-                mInterpreter.run (&iter->second.first[0], iter->second.first.size(), interpreterContext);
+                if (mProfiler.isEnabled())
+                {
+                    osg::Timer_t start = osg::Timer::instance()->tick();
+
+                    int executed = mInterpreter.run (&iter->second.first[0], iter->second.first.size(),
+                        interpreterContext);
+
+                    mProfiler.record (name, osg::Timer::instance()->delta_s (start, osg::Timer::instance()->tick()),
+                        executed);
+                }
+                else
+                    mInterpreter.run (&iter->second.first[0], iter->second.first.size(), interpreterContext);
             }
             catch (const std::exception& e)
             {
@@ -135,6 +230,8 @@ namespace MWScript
 
         const MWWorld::Store<ESM::Script>& scripts = mStore.get<ESM::Script>();
 
+        std::vector<osg::ref_ptr<CompileScriptItem> > items;
+
         for (MWWorld::Store<ESM::Script>::iterator iter = scripts.begin();
             iter != scripts.end(); ++iter)
             if (!std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(),
@@ -142,10 +239,52 @@ namespace MWScript
             {
                 ++count;
 
-                if (compile (iter->mId))
+                CompiledScript compiled;
+
+                if (getCached (*iter, compiled))
+                {
+                    mScripts.insert (std::make_pair (iter->mId, compiled));
                     ++success;
+                }
+                else
+                    items.push_back (new CompileScriptItem (*iter, mCompilerContext, mWarningsMode));
             }
 
+        if (!items.empty())
+        {
+            // The workers only read the store, the globals and the local variables of other scripts
+            // (see getLocals), so mScripts must not change until all of them are done.
+            osg::ref_ptr<SceneUtil::WorkQueue> workQueue =
+                new SceneUtil::WorkQueue (std::max (1, OpenThreads::GetNumberOfProcessors()));
+
+            for (std::vector<osg::ref_ptr<CompileScriptItem> >::iterator iter (items.begin());
+                iter!=items.end(); ++iter)
+                workQueue->addWorkItem (*iter, SceneUtil::WorkQueue::Priority_High);
+
+            for (std::vector<osg::ref_ptr<CompileScriptItem> >::iterator iter (items.begin());
+                iter!=items.end(); ++iter)
+                (*iter)->waitTillDone();
+
+            for (std::vector<osg::ref_ptr<CompileScriptItem> >::iterator iter (items.begin());
+                iter!=items.end(); ++iter)
+            {
+                CompileScriptItem& item = **iter;
+
+                std::cerr << item.mLog.str();
+
+                if (item.mSuccess)
+                {
+                    CompiledScript compiled (item.mCode, item.mLocals);
+                    mScripts.insert (std::make_pair (item.mScript.mId, compiled));
+                    addToCache (item.mScript, compiled);
+                    ++success;
+                }
+            }
+        }
+
+        if (mCache)
+            mCache->write();
+
         return std::make_pair (count, success);
     }
 
@@ -153,6 +292,8 @@ namespace MWScript
     {
         std::string name2 = Misc::StringUtils::lowerCase (name);
 
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock (mLocalsMutex);
+
         {
             ScriptCollection::iterator iter = mScripts.find (name2);
 
@@ -191,4 +332,39 @@ namespace MWScript
     {
         return mGlobalScripts;
     }
+
+    bool ScriptManager::toggleProfiling()
+    {
+        bool enabled = !mProfiler.isEnabled();
+
+        mProfiler.setEnabled (enabled);
+        mInterpreter.setCountOpcodes (enabled);
+
+        if (enabled)
+            mInterpreter.clearOpcodeCounts();
+
+        return enabled;
+    }
+
+    void ScriptManager::reportProfile (std::ostream& stream, std::size_t maxEntries)
+    {
+        mProfiler.report (stream, mInterpreter.getOpcodeCounts(), mCompilerContext.getExtensions(), maxEntries);
+    }
+
+    std::string ScriptManager::writeProfile()
+    {
+        if (mProfileFile.empty())
+            throw std::runtime_error ("no file to write the script profile to");
+
+        boost::filesystem::ofstream stream (mProfileFile);
+
+        mProfiler.writeCsv (stream, mInterpreter.getOpcodeCounts(), mCompilerContext.getExtensions());
+
+        stream.close();
+
+        if (stream.fail())
+            throw std::runtime_error ("failed to write " + mProfileFile);
+
+        return mProfileFile;
+    }
 }
@@ -2,8 +2,11 @@
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
 #include <map>
+#include <memory>
 #include <string>
 
+#include <OpenThreads/Mutex>
+
 #include <components/compiler/streamerrorhandler.hpp>
 #include <components/compiler/fileparser.hpp>
 
@@ -13,6 +16,12 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "globalscripts.hpp"
+#include "scriptprofiler.hpp"
+
+namespace ESM
+{
+    struct Script;
+}
 
 namespace MWWorld
 {
@@ -32,6 +41,8 @@ namespace Interpreter
 
 namespace MWScript
 {
+    class ScriptCache;
+
     class ScriptManager : public MWBase::ScriptManager
     {
             Compiler::StreamErrorHandler mErrorHandler;
@@ -40,6 +51,7 @@ namespace MWScript
             Compiler::FileParser mParser;
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
+            int mWarningsMode;
 
             typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
             typedef std::map<std::string, CompiledScript> ScriptCollection;
@@ -48,6 +60,17 @@ namespace MWScript
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
             std::vector<std::string> mScriptBlacklist;
+            std::unique_ptr<ScriptCache> mCache;
+            ScriptProfiler mProfiler;
+            std::string mProfileFile;
+
+            /// Guards mOtherLocals and mErrorHandler in getLocals, which is also used by the compiler
+            /// contexts of compileAll's worker threads.
+            OpenThreads::Mutex mLocalsMutex;
+
+            bool getCached (const ESM::Script& script, CompiledScript& compiled) const;
+
+            void addToCache (const ESM::Script& script, const CompiledScript& compiled);
 
         public:
 
@@ -55,6 +78,16 @@ namespace MWScript
                 Compiler::Context& compilerContext, int warningsMode,
                 const std::vector<std::string>& scriptBlacklist);
 
+            virtual ~ScriptManager();
+            ///< Writes the cache, if scripts were added to it.
+
+            void setCache (ScriptCache *cache);
+            ///< Take compiled scripts from \a cache instead of compiling them again, and add newly compiled
+            /// scripts to it. Takes ownership of \a cache.
+
+            void setProfileFile (const std::string& file);
+            ///< Set the file that writeProfile writes to.
+
             virtual void run (const std::string& name, Interpreter::Context& interpreterContext);
             ///< Run the script with the given name (compile first, if not compiled yet)
 
@@ -63,13 +96,25 @@ namespace MWScript
             /// \return Success?
 
             virtual std::pair<int, int> compileAll();
-            ///< Compile all scripts
+            ///< Compile all scripts. Scripts that are not cached are compiled on worker threads.
             /// \return count, success
 
             virtual const Compiler::Locals& getLocals (const std::string& name);
             ///< Return locals for script \a name.
 
             virtual GlobalScripts& getGlobalScripts();
+
+            virtual bool toggleProfiling();
+            ///< Start or stop recording the execution of scripts. Starting discards the previous results.
+            /// \return Is profiling enabled now?
+
+            virtual void reportProfile (std::ostream& stream, std::size_t maxEntries);
+            ///< Write a summary of the recorded scripts and opcodes, limited to the \a maxEntries most
+            /// expensive of each.
+
+            virtual std::string writeProfile();
+            ///< Write all recorded scripts and opcodes to a CSV file.
+            /// \return Path of the file
     };
 }
 
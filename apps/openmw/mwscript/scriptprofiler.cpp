@@ -0,0 +1,145 @@
+#include "scriptprofiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+#include <components/compiler/extensions.hpp>
+
+namespace
+{
+    typedef std::pair<std::string, MWScript::ScriptProfiler::ScriptStats> ScriptEntry;
+    typedef std::pair<std::pair<int, int>, unsigned long> OpcodeEntry;
+
+    bool compareTime (const ScriptEntry& left, const ScriptEntry& right)
+    {
+        return left.second.mTime>right.second.mTime;
+    }
+
+    bool compareCount (const OpcodeEntry& left, const OpcodeEntry& right)
+    {
+        return left.second>right.second;
+    }
+
+    std::string getOpcodeName (const Compiler::Extensions *extensions, int segment, int opcode)
+    {
+        // Only the extension opcodes of segment 3 and 5 are registered with keywords
+        if (!extensions || (segment!=3 && segment!=5))
+            return "";
+
+        return extensions->getKeyword (segment, opcode);
+    }
+}
+
+namespace MWScript
+{
+    ScriptProfiler::ScriptProfiler() : mEnabled (false), mStartTick (0), mStopTick (0) {}
+
+    void ScriptProfiler::setEnabled (bool enabled)
+    {
+        if (enabled==mEnabled)
+            return;
+
+        mEnabled = enabled;
+
+        if (enabled)
+        {
+            mScripts.clear();
+            mStartTick = osg::Timer::instance()->tick();
+        }
+        else
+            mStopTick = osg::Timer::instance()->tick();
+    }
+
+    bool ScriptProfiler::isEnabled() const
+    {
+        return mEnabled;
+    }
+
+    void ScriptProfiler::record (const std::string& name, double time, int instructions)
+    {
+        ScriptStats& stats = mScripts[name];
+        ++stats.mCalls;
+        stats.mInstructions += instructions;
+        stats.mTime += time;
+    }
+
+    const ScriptProfiler::ScriptStatsMap& ScriptProfiler::getScripts() const
+    {
+        return mScripts;
+    }
+
+    double ScriptProfiler::getDuration() const
+    {
+        return osg::Timer::instance()->delta_s (mStartTick,
+            mEnabled ? osg::Timer::instance()->tick() : mStopTick);
+    }
+
+    void ScriptProfiler::report (std::ostream& stream, const Interpreter::Interpreter::OpcodeCounts& opcodes,
+        const Compiler::Extensions *extensions, std::size_t maxEntries) const
+    {
+        std::vector<ScriptEntry> scripts (mScripts.begin(), mScripts.end());
+        std::sort (scripts.begin(), scripts.end(), compareTime);
+
+        double total = 0;
+        for (std::vector<ScriptEntry>::const_iterator iter (scripts.begin()); iter!=scripts.end(); ++iter)
+            total += iter->second.mTime;
+
+        stream
+            << std::fixed << std::setprecision (3)
+            << mScripts.size() << " scripts, " << total * 1000 << " ms in " << getDuration() << " s";
+
+        for (std::size_t i=0; i<scripts.size() && i<maxEntries; ++i)
+        {
+            const ScriptStats& stats = scripts[i].second;
+
+            stream
+                << std::endl << " " << scripts[i].first << ": " << stats.mTime * 1000 << " ms, "
+                << stats.mCalls << " runs, " << stats.mInstructions << " instructions";
+        }
+
+        std::vector<OpcodeEntry> counts (opcodes.begin(), opcodes.end());
+        std::sort (counts.begin(), counts.end(), compareCount);
+
+        if (!counts.empty())
+            stream << std::endl << "Opcodes:";
+
+        for (std::size_t i=0; i<counts.size() && i<maxEntries; ++i)
+        {
+            int segment = counts[i].first.first;
+            int opcode = counts[i].first.second;
+
+            stream << std::endl << " " << segment << "/" << opcode;
+
+            std::string name = getOpcodeName (extensions, segment, opcode);
+            if (!name.empty())
+                stream << " (" << name << ")";
+
+            stream << ": " << counts[i].second;
+        }
+    }
+
+    void ScriptProfiler::writeCsv (std::ostream& stream, const Interpreter::Interpreter::OpcodeCounts& opcodes,
+        const Compiler::Extensions *extensions) const
+    {
+        stream << "script,runs,instructions,time (ms)" << std::endl;
+
+        for (ScriptStatsMap::const_iterator iter (mScripts.begin()); iter!=mScripts.end(); ++iter)
+            stream
+                << iter->first << "," << iter->second.mCalls << "," << iter->second.mInstructions << ","
+                << iter->second.mTime * 1000 << std::endl;
+
+        stream << std::endl << "segment,opcode,keyword,executions" << std::endl;
+
+        for (Interpreter::Interpreter::OpcodeCounts::const_iterator iter (opcodes.begin());
+            iter!=opcodes.end(); ++iter)
+        {
+            int segment = iter->first.first;
+            int opcode = iter->first.second;
+
+            stream
+                << segment << "," << opcode << "," << getOpcodeName (extensions, segment, opcode) << ","
+                << iter->second << std::endl;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef GAME_SCRIPT_SCRIPTPROFILER_H
+#define GAME_SCRIPT_SCRIPTPROFILER_H
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include <osg/Timer>
+
+#include <components/interpreter/interpreter.hpp>
+
+namespace Compiler
+{
+    class Extensions;
+}
+
+namespace MWScript
+{
+    /// \brief Execution statistics of scripts, collected while profiling is enabled
+    class ScriptProfiler
+    {
+        public:
+
+            struct ScriptStats
+            {
+                unsigned long mCalls;
+                unsigned long mInstructions;
+                double mTime; ///< seconds
+
+                ScriptStats() : mCalls (0), mInstructions (0), mTime (0) {}
+            };
+
+            typedef std::map<std::string, ScriptStats> ScriptStatsMap;
+
+            ScriptProfiler();
+
+            void setEnabled (bool enabled);
+            ///< Enabling the profiler discards the results of the previous run.
+
+            bool isEnabled() const;
+
+            void record (const std::string& name, double time, int instructions);
+            ///< Account one run of script \a name.
+
+            const ScriptStatsMap& getScripts() const;
+
+            /// Write a summary of the scripts with the highest total time and the most executed opcodes.
+            void report (std::ostream& stream, const Interpreter::Interpreter::OpcodeCounts& opcodes,
+                const Compiler::Extensions *extensions, std::size_t maxEntries) const;
+
+            /// Write the statistics of all scripts and opcodes as comma-separated values.
+            void writeCsv (std::ostream& stream, const Interpreter::Interpreter::OpcodeCounts& opcodes,
+                const Compiler::Extensions *extensions) const;
+
+        private:
+
+            bool mEnabled;
+            osg::Timer_t mStartTick;
+            osg::Timer_t mStopTick;
+            ScriptStatsMap mScripts;
+
+            double getDuration() const;
+            ///< Time the profiler has been enabled for, in seconds.
+    };
+}
+
+#endif
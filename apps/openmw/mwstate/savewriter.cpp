@@ -0,0 +1,65 @@
+#include "savewriter.hpp"
+
+#include <stdexcept>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/esm/esmwriter.hpp>
+
+MWState::SaveWriter::SaveWriter (const boost::filesystem::path& path, int compression)
+: mPath (path), mCompression (compression), mFailed (false)
+{}
+
+std::iostream& MWState::SaveWriter::getStream()
+{
+    return mStream;
+}
+
+void MWState::SaveWriter::doWork()
+{
+    boost::filesystem::path tempPath = mPath;
+    tempPath += ".tmp";
+
+    try
+    {
+        boost::filesystem::ofstream filestream (tempPath, std::ios::binary);
+
+        if (mCompression > 0)
+            ESM::ESMWriter::compressRecords (mStream, mCompression, filestream);
+        else
+            filestream << mStream.rdbuf();
+
+        filestream.close();
+
+        if (filestream.fail())
+            throw std::runtime_error("Write operation failed (file stream)");
+
+        boost::filesystem::rename (tempPath, mPath);
+    }
+    catch (const std::exception& e)
+    {
+        mFailed = true;
+        mError = e.what();
+
+        boost::system::error_code ec;
+        boost::filesystem::remove (tempPath, ec);
+    }
+
+    mStream.str (std::string());
+}
+
+const boost::filesystem::path& MWState::SaveWriter::getPath() const
+{
+    return mPath;
+}
+
+bool MWState::SaveWriter::hasFailed() const
+{
+    return mFailed;
+}
+
+const std::string& MWState::SaveWriter::getError() const
+{
+    return mError;
+}
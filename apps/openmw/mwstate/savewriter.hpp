@@ -0,0 +1,50 @@
+#ifndef GAME_STATE_SAVEWRITER_H
+#define GAME_STATE_SAVEWRITER_H
+
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
+namespace MWState
+{
+    /// \brief Compresses a serialised saved game and writes it to its file on a worker thread
+    ///
+    /// The records are serialised into getStream() without compression, on the main thread, as that reads the
+    /// live game state. Compressing them is left to the worker thread.
+    ///
+    /// The data is written to a temporary file first, which then replaces the saved game file, so that a failed
+    /// write leaves an existing save intact.
+    class SaveWriter : public SceneUtil::WorkItem
+    {
+        public:
+
+            SaveWriter (const boost::filesystem::path& path, int compression);
+            ///< \param compression zlib compression level of the records, see ESM::ESMWriter::setCompression().
+
+            /// Stream to serialise the saved game into, before adding the item to a work queue.
+            std::iostream& getStream();
+
+            virtual void doWork();
+
+            const boost::filesystem::path& getPath() const;
+
+            /// Only valid once the item is done.
+            bool hasFailed() const;
+
+            /// Only valid once the item is done.
+            const std::string& getError() const;
+
+        private:
+
+            boost::filesystem::path mPath;
+            int mCompression;
+            std::stringstream mStream;
+            bool mFailed;
+            std::string mError;
+    };
+}
+
+#endif
@@ -9,11 +9,12 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <osg/Image>
 
 #include <osgDB/Registry>
 
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -38,6 +39,7 @@
 #include "../mwscript/globalscripts.hpp"
 
 #include "quicksavemanager.hpp"
+#include "savewriter.hpp"
 
 void MWState::StateManager::cleanup (bool force)
 {
@@ -87,10 +89,22 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
 
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, game), mTimePlayed (0)
+, mWorkQueue (new SceneUtil::WorkQueue (1)), mSaveCharacter (NULL)
 {
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    if (mSaveWriter)
+    {
+        mSaveWriter->waitTillDone();
+
+        if (mSaveWriter->hasFailed())
+            std::cerr << "Failed to save game: " << mSaveWriter->getError() << std::endl;
+    }
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -175,6 +189,9 @@ void MWState::StateManager::endGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // Slots must not change while a saved game is being written
+    finishSave (true);
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -225,8 +242,10 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getMechanicsManager()->persistAnimationStates();
 
         // Write to a memory stream first. If there is an exception during the save process, we don't want to trash the
-        // existing save file we are overwriting.
-        std::stringstream stream;
+        // existing save file we are overwriting. The records are compressed later, together with writing the file.
+        osg::ref_ptr<SaveWriter> saveWriter = new SaveWriter (slot->mPath,
+            std::max (0, std::min (9, Settings::Manager::getInt ("compression level", "Saves"))));
+        std::iostream& stream = saveWriter->getStream();
 
         ESM::ESMWriter writer;
 
@@ -285,33 +304,65 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
+        // All good, write to file. The game state is not needed for that anymore, so let the game continue
+        // while the records are compressed and the file is written.
+        mSaveWriter = saveWriter;
+        mSaveCharacter = character;
+        mWorkQueue->addWorkItem (mSaveWriter, SceneUtil::WorkQueue::Priority_High);
+    }
+    catch (const std::exception& e)
+    {
+        reportSaveError (e.what(), character, slot);
+    }
+}
 
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+void MWState::StateManager::finishSave (bool wait)
+{
+    if (!mSaveWriter)
+        return;
 
-        Settings::Manager::setString ("character", "Saves",
-            slot->mPath.parent_path().filename().string());
+    if (!mSaveWriter->isDone())
+    {
+        if (!wait)
+            return;
+
+        mSaveWriter->waitTillDone();
     }
-    catch (const std::exception& e)
+
+    osg::ref_ptr<SaveWriter> writer = mSaveWriter;
+    mSaveWriter = NULL;
+
+    if (!writer->hasFailed())
     {
-        std::stringstream error;
-        error << "Failed to save game: " << e.what();
+        Settings::Manager::setString ("character", "Saves",
+            writer->getPath().parent_path().filename().string());
+        return;
+    }
 
-        std::cerr << error.str() << std::endl;
+    const Slot *slot = NULL;
+    for (Character::SlotIterator it = mSaveCharacter->begin(); it != mSaveCharacter->end(); ++it)
+        if (it->mPath == writer->getPath())
+            slot = &*it;
 
-        std::vector<std::string> buttons;
-        buttons.push_back("#{sOk}");
-        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+    reportSaveError (writer->getError(), mSaveCharacter, slot);
+}
 
-        // If no file was written, clean up the slot
-        if (character && slot && !boost::filesystem::exists(slot->mPath))
-        {
-            character->deleteSlot(slot);
-            character->cleanup();
-        }
+void MWState::StateManager::reportSaveError (const std::string& error, Character *character, const Slot *slot)
+{
+    std::stringstream message;
+    message << "Failed to save game: " << error;
+
+    std::cerr << message.str() << std::endl;
+
+    std::vector<std::string> buttons;
+    buttons.push_back("#{sOk}");
+    MWBase::Environment::get().getWindowManager()->interactiveMessageBox(message.str(), buttons);
+
+    // If no file was written, clean up the slot
+    if (character && slot && !boost::filesystem::exists(slot->mPath))
+    {
+        character->deleteSlot(slot);
+        character->cleanup();
     }
 }
 
@@ -369,6 +420,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishSave (true);
+
     try
     {
         cleanup();
@@ -567,6 +620,8 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    finishSave (true);
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -589,6 +644,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    finishSave (false);
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -7,10 +7,19 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <osg/ref_ptr>
+
 #include "charactermanager.hpp"
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWState
 {
+    class SaveWriter;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -18,11 +27,21 @@ namespace MWState
             State mState;
             CharacterManager mCharacterManager;
             double mTimePlayed;
+            osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+            osg::ref_ptr<SaveWriter> mSaveWriter;
+            Character *mSaveCharacter;
 
         private:
 
             void cleanup (bool force = false);
 
+            void finishSave (bool wait);
+            ///< Report the result of the saved game that is being written, if any.
+            ///
+            /// \param wait Wait for the saved game to be written, otherwise only check for it.
+
+            void reportSaveError (const std::string& error, Character *character, const Slot *slot);
+
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
             void writeScreenshot (std::vector<char>& imageData) const;
@@ -33,6 +52,8 @@ namespace MWState
 
             StateManager (const boost::filesystem::path& saves, const std::string& game);
 
+            virtual ~StateManager();
+
             virtual void requestQuit();
 
             virtual bool hasQuitRequest() const;
@@ -54,6 +75,8 @@ namespace MWState
             virtual void saveGame (const std::string& description, const Slot *slot = 0);
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
+            /// The game state is serialised right away, the file is written in the background.
+            ///
             /// \note Slot must belong to the current character.
 
             ///Saves a file, using supplied filename, overwritting if needed
@@ -20,7 +20,7 @@ namespace MWWorld
         mCellRef.mRefNum.unset();
     }
 
-    std::string CellRef::getRefId() const
+    const std::string& CellRef::getRefId() const
     {
         return mCellRef.mRefID;
     }
@@ -32,7 +32,7 @@ namespace MWWorld
         bool hasContentFile() const;
 
         // Id of object being referenced
-        std::string getRefId() const;
+        const std::string& getRefId() const;
 
         // For doors - true if this door teleports to somewhere else, false
         // if it should open through animation.
@@ -0,0 +1,239 @@
+#include "cellrefindex.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/loadcell.hpp>
+
+#include <components/misc/stringops.hpp>
+
+#include <components/sceneutil/workqueue.hpp>
+
+#include <components/to_utf8/to_utf8.hpp>
+
+namespace MWWorld
+{
+    /// Reads the references of one cell with its own copies of the readers, so that the readers of the main
+    /// thread can keep being used while the work item runs.
+    class ReadCellRefsItem : public SceneUtil::WorkItem
+    {
+        public:
+
+            ReadCellRefsItem (const ESM::Cell& cell, const std::vector<ESM::ESMReader>& readers,
+                ToUTF8::Utf8Encoder* encoder)
+            : mCell (cell), mReaders (readers.size()), mRead (false)
+            {
+                // The encoder keeps a conversion buffer, so each item needs its own
+                if (encoder)
+                    mEncoder.reset (new ToUTF8::Utf8Encoder (*encoder));
+
+                for (size_t i = 0; i < cell.mContextList.size(); ++i)
+                {
+                    int index = cell.mContextList[i].index;
+                    mReaders[index] = readers[index];
+                    mReaders[index].setEncoder (mEncoder.get());
+                }
+            }
+
+            virtual void doWork()
+            {
+                if (!claim())
+                    return;
+
+                try
+                {
+                    for (size_t i = 0; i < mCell.mContextList.size(); ++i)
+                        mReaders[mCell.mContextList[i].index].reopen();
+                }
+                catch (std::exception&)
+                {
+                    // Leave it to CellRefIndex::getRefs to read the references and report the error
+                    return;
+                }
+
+                CellRefIndex::scanRefs (mCell, mReaders, mRefs);
+                mRead = true;
+            }
+
+            /// Take the item over, either from the worker thread when it starts, or from the main thread
+            /// before it starts.
+            /// \return False if the other side took it first.
+            bool claim()
+            {
+                return mClaimed.exchange (1)==0;
+            }
+
+            /// Only valid once the item is done. False if the item was cancelled before it ran.
+            bool isRead() const
+            {
+                return mRead;
+            }
+
+            CellRefIndex::RefList& getRefs()
+            {
+                return mRefs;
+            }
+
+        private:
+
+            const ESM::Cell& mCell;
+            std::unique_ptr<ToUTF8::Utf8Encoder> mEncoder;
+            std::vector<ESM::ESMReader> mReaders;
+            CellRefIndex::RefList mRefs;
+            OpenThreads::Atomic mClaimed;
+            bool mRead;
+    };
+
+    CellRefIndex::CellRefIndex (std::vector<ESM::ESMReader>& readers, ToUTF8::Utf8Encoder* encoder)
+        : mReaders (readers), mEncoder (encoder)
+    {}
+
+    CellRefIndex::~CellRefIndex()
+    {
+        clear();
+    }
+
+    const CellRefIndex::RefList& CellRefIndex::getRefs (const ESM::Cell& cell)
+    {
+        std::map<const ESM::Cell *, RefList>::iterator iter = mRefs.find (&cell);
+
+        if (iter!=mRefs.end())
+            return iter->second;
+
+        if (const RefList* refs = takePending (cell, true))
+            return *refs;
+
+        iter = mRefs.insert (std::make_pair (&cell, RefList())).first;
+        scanRefs (cell, mReaders, iter->second);
+
+        return iter->second;
+    }
+
+    bool CellRefIndex::prefetch (const ESM::Cell& cell, SceneUtil::WorkQueue* workQueue)
+    {
+        if (cell.mContextList.empty() || mRefs.find (&cell)!=mRefs.end())
+            return true;
+
+        if (mPending.find (&cell)!=mPending.end())
+            return takePending (cell, false)!=NULL;
+
+        osg::ref_ptr<ReadCellRefsItem> item (new ReadCellRefsItem (cell, mReaders, mEncoder));
+        workQueue->addWorkItem (item, SceneUtil::WorkQueue::Priority_Preload);
+        mPending.insert (std::make_pair (&cell, item));
+
+        return false;
+    }
+
+    void CellRefIndex::clear()
+    {
+        for (std::map<const ESM::Cell *, osg::ref_ptr<ReadCellRefsItem> >::iterator iter (mPending.begin());
+            iter!=mPending.end(); ++iter)
+            iter->second->cancel();
+
+        // The items refer to the cells, which may be gone after clearing. Items that have not started yet
+        // will not touch them anymore, so only wait for the running ones.
+        for (std::map<const ESM::Cell *, osg::ref_ptr<ReadCellRefsItem> >::iterator iter (mPending.begin());
+            iter!=mPending.end(); ++iter)
+            if (!iter->second->claim())
+                iter->second->waitTillDone();
+
+        mPending.clear();
+        mRefs.clear();
+    }
+
+    const CellRefIndex::RefList* CellRefIndex::takePending (const ESM::Cell& cell, bool wait)
+    {
+        std::map<const ESM::Cell *, osg::ref_ptr<ReadCellRefsItem> >::iterator iter = mPending.find (&cell);
+
+        if (iter==mPending.end())
+            return NULL;
+
+        if (!iter->second->isDone())
+        {
+            if (!wait)
+                return NULL;
+
+            // The item may be queued behind other preloading work, so rather than waiting for a worker thread
+            // to get to it, read the references right away. Only wait if it is already running.
+            if (iter->second->claim())
+            {
+                iter->second->cancel();
+                mPending.erase (iter);
+                return NULL;
+            }
+
+            iter->second->waitTillDone();
+        }
+
+        osg::ref_ptr<ReadCellRefsItem> item = iter->second;
+        mPending.erase (iter);
+
+        if (!item->isRead())
+            return NULL;
+
+        RefList& refs = mRefs[&cell];
+        refs.swap (item->getRefs());
+        return &refs;
+    }
+
+    bool CellRefIndex::readRef (const ESM::Cell& cell, const Ref& ref, ESM::CellRef& cellRef)
+    {
+        try
+        {
+            ESM::ESMReader& reader = mReaders[cell.mContextList.at (ref.mContext).index];
+            cell.restore (reader, ref.mContext);
+            reader.seekSubRecord (ref.mFilePos, ref.mLeftRec);
+
+            bool deleted;
+            cellRef.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+            return ESM::Cell::getNextRef (reader, cellRef, deleted);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "An error occurred reading a reference for cell " << cell.getDescription() << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void CellRefIndex::scanRefs (const ESM::Cell& cell, std::vector<ESM::ESMReader>& readers, RefList& refs)
+    {
+        // Read references from all plugins that do something with this cell.
+        for (size_t i = 0; i < cell.mContextList.size(); i++)
+        {
+            try
+            {
+                // Reopen the ESM reader and seek to the right position.
+                int index = cell.mContextList.at(i).index;
+                cell.restore (readers[index], i);
+
+                ESM::CellRef ref;
+                ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+
+                Ref entry;
+                entry.mContext = i;
+
+                // Get each reference in turn, remembering where it starts
+                readers[index].getSubRecordPosition (entry.mFilePos, entry.mLeftRec);
+                while (ESM::Cell::getNextRef (readers[index], ref, entry.mDeleted))
+                {
+                    // Don't list reference if it was moved to a different cell.
+                    ESM::MovedCellRefTracker::const_iterator iter =
+                        std::find(cell.mMovedRefs.begin(), cell.mMovedRefs.end(), ref.mRefNum);
+                    if (iter == cell.mMovedRefs.end())
+                    {
+                        entry.mLowerId = Misc::StringUtils::lowerCase (ref.mRefID);
+                        refs.push_back (entry);
+                    }
+
+                    readers[index].getSubRecordPosition (entry.mFilePos, entry.mLeftRec);
+                }
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << "An error occurred reading references for cell " << cell.getDescription() << ": " << e.what() << std::endl;
+            }
+        }
+    }
+}
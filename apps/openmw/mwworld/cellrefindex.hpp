@@ -0,0 +1,105 @@
+#ifndef GAME_MWWORLD_CELLREFINDEX_H
+#define GAME_MWWORLD_CELLREFINDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <osg/ref_ptr>
+
+#include <stdint.h>
+
+#include <components/esm/cellref.hpp>
+
+namespace ESM
+{
+    class ESMReader;
+    struct Cell;
+}
+
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace MWWorld
+{
+    class ReadCellRefsItem;
+
+    /// \brief References of the cells, as read from the content files
+    ///
+    /// The references of a cell are scanned when the cell is first listed or loaded. For each reference, only its
+    /// lowercase ID and the position of its record in the content file are kept for the rest of the session, so
+    /// that listing the cell again (e.g. after loading a savegame) is a table lookup, and loading it reads the
+    /// references directly without parsing the rest of the cell. The scan can also run ahead of time on a worker
+    /// thread, see prefetch().
+    ///
+    /// \note Only the parsing runs on the worker thread. Creating the live references from the parsed ones
+    /// (CellStore::load()) stays on the main thread, as it registers them in the RefIdIndex, lowercases the
+    /// IDs of references moved into the cell in the shared ESM::Cell, and may be triggered by Cells::getPtr()
+    /// at any time. Moving it to the work queue would need CellStore::load() to fill a detached CellStore that
+    /// the main thread splices in and indexes.
+    class CellRefIndex
+    {
+        public:
+
+            struct Ref
+            {
+                std::string mLowerId;
+                size_t mFilePos;
+                uint32_t mLeftRec;
+                int mContext; ///< Index in ESM::Cell::mContextList
+                bool mDeleted;
+            };
+
+            typedef std::vector<Ref> RefList;
+
+            CellRefIndex (std::vector<ESM::ESMReader>& readers, ToUTF8::Utf8Encoder* encoder);
+
+            ~CellRefIndex();
+
+            const RefList& getRefs (const ESM::Cell& cell);
+            ///< Return the references of \a cell from all content files, in load order. References that have
+            /// been moved to another cell are excluded, references moved into \a cell (ESM::Cell::mLeasedRefs)
+            /// are not included.
+            ///
+            /// If the references are being read by prefetch(), waits for them. If prefetch() has not started
+            /// reading them yet, reads them right away instead.
+
+            bool prefetch (const ESM::Cell& cell, SceneUtil::WorkQueue* workQueue);
+            ///< Start reading the references of \a cell on \a workQueue, unless they are already available
+            /// or being read.
+            /// \return Can getRefs() return the references of \a cell without reading content files?
+
+            void clear();
+
+            bool readRef (const ESM::Cell& cell, const Ref& ref, ESM::CellRef& cellRef);
+            ///< Read the full reference \a ref of \a cell, as returned by getRefs(), from its content file.
+            /// \return Could the reference be read? Errors are reported on std::cerr.
+
+            static void scanRefs (const ESM::Cell& cell, std::vector<ESM::ESMReader>& readers, RefList& refs);
+            ///< Find the references of \a cell with \a readers.
+
+        private:
+
+            std::vector<ESM::ESMReader>& mReaders;
+            ToUTF8::Utf8Encoder* mEncoder;
+
+            std::map<const ESM::Cell *, RefList> mRefs;
+
+            std::map<const ESM::Cell *, osg::ref_ptr<ReadCellRefsItem> > mPending;
+
+            /// Move the references of a finished ReadCellRefsItem into mRefs.
+            const RefList* takePending (const ESM::Cell& cell, bool wait);
+
+            CellRefIndex (const CellRefIndex&);
+            CellRefIndex& operator= (const CellRefIndex&);
+    };
+}
+
+#endif
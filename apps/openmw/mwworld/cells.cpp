@@ -7,7 +7,6 @@
 #include <components/esm/defs.hpp>
 #include <components/esm/cellstate.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
-#include <components/settings/settings.hpp>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -17,6 +16,24 @@
 #include "containerstore.hpp"
 #include "cellstore.hpp"
 
+namespace
+{
+    /// Is \a left checked before \a right by Cells::getPtr(), when both have a reference with the same ID?
+    /// Exteriors come first, in reverse order. This is a workaround for an ambiguous chargen_plank reference in the
+    /// vanilla game: there is one at -22,16 and one at -2,-9, the latter should be used.
+    bool isSearchedFirst (const MWWorld::CellStore& left, const MWWorld::CellStore& right)
+    {
+        if (left.isExterior()!=right.isExterior())
+            return left.isExterior();
+
+        if (left.isExterior())
+            return std::make_pair (right.getCell()->getGridX(), right.getCell()->getGridY())
+                < std::make_pair (left.getCell()->getGridX(), left.getCell()->getGridY());
+
+        return Misc::StringUtils::ciLess (left.getCell()->mName, right.getCell()->mName);
+    }
+}
+
 MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
 {
     if (cell->mData.mFlags & ESM::Cell::Interior)
@@ -26,7 +43,7 @@ MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
 
         if (result==mInteriors.end())
         {
-            result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mReader))).first;
+            result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mRefIndex, mRefIdIndex))).first;
         }
 
         return &result->second;
@@ -39,7 +56,7 @@ MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
         if (result==mExteriors.end())
         {
             result = mExteriors.insert (std::make_pair (
-                std::make_pair (cell->getGridX(), cell->getGridY()), CellStore (cell, mStore, mReader))).first;
+                std::make_pair (cell->getGridX(), cell->getGridY()), CellStore (cell, mStore, mRefIndex, mRefIdIndex))).first;
 
         }
 
@@ -51,23 +68,7 @@ void MWWorld::Cells::clear()
 {
     mInteriors.clear();
     mExteriors.clear();
-    std::fill(mIdCache.begin(), mIdCache.end(), std::make_pair("", (MWWorld::CellStore*)0));
-    mIdCacheIndex = 0;
-}
-
-MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore& cellStore)
-{
-    Ptr ptr = getPtr (name, cellStore);
-
-    if (!ptr.isEmpty() && ptr.isInCell())
-    {
-        mIdCache[mIdCacheIndex].first = name;
-        mIdCache[mIdCacheIndex].second = &cellStore;
-        if (++mIdCacheIndex>=mIdCache.size())
-            mIdCacheIndex = 0;
-    }
-
-    return ptr;
+    mRefIdIndex.clear();
 }
 
 void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
@@ -87,12 +88,16 @@ void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
     writer.endRecord (ESM::REC_CSTA);
 }
 
-MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader)
-: mStore (store), mReader (reader),
-  mIdCache (Settings::Manager::getInt("pointers cache size", "Cells"), std::pair<std::string, CellStore *> ("", (CellStore*)0)),
-  mIdCacheIndex (0)
+MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader,
+    ToUTF8::Utf8Encoder* encoder)
+: mStore (store), mRefIndex (reader, encoder)
 {}
 
+MWWorld::CellRefIndex& MWWorld::Cells::getRefIndex()
+{
+    return mRefIndex;
+}
+
 MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
 {
     std::map<std::pair<int, int>, CellStore>::iterator result =
@@ -121,7 +126,7 @@ MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
         }
 
         result = mExteriors.insert (std::make_pair (
-            std::make_pair (x, y), CellStore (cell, mStore, mReader))).first;
+            std::make_pair (x, y), CellStore (cell, mStore, mRefIndex, mRefIdIndex))).first;
     }
 
     if (result->second.getState()!=CellStore::State_Loaded)
@@ -141,7 +146,7 @@ MWWorld::CellStore *MWWorld::Cells::getInterior (const std::string& name)
     {
         const ESM::Cell *cell = mStore.get<ESM::Cell>().find(lowerName);
 
-        result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mReader))).first;
+        result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mRefIndex, mRefIdIndex))).first;
     }
 
     if (result->second.getState()!=CellStore::State_Loaded)
@@ -187,36 +192,27 @@ MWWorld::Ptr MWWorld::Cells::getPtr (const std::string& name, CellStore& cell,
     return Ptr();
 }
 
+MWWorld::Ptr MWWorld::Cells::getPtr (const std::string& name, const std::set<CellStore*>& cells)
+{
+    Ptr ptr = mRefIdIndex.search (name, cells);
+
+    // Get the reference through its cell, so that changes made through the Ptr are saved
+    return ptr.isEmpty() ? ptr : ptr.getCell()->search (name);
+}
+
 MWWorld::Ptr MWWorld::Cells::getPtr (const std::string& name)
 {
-    // First check the cache
-    for (std::vector<std::pair<std::string, CellStore *> >::iterator iter (mIdCache.begin());
-        iter!=mIdCache.end(); ++iter)
-        if (iter->first==name && iter->second)
-        {
-            Ptr ptr = getPtr (name, *iter->second);
-            if (!ptr.isEmpty())
-                return ptr;
-        }
+    // First check the loaded cells
+    std::vector<Ptr> found;
+    mRefIdIndex.search (name, found);
 
-    // Then check cells that are already listed
-    // Search in reverse, this is a workaround for an ambiguous chargen_plank reference in the vanilla game.
-    // there is one at -22,16 and one at -2,-9, the latter should be used.
-    for (std::map<std::pair<int, int>, CellStore>::reverse_iterator iter = mExteriors.rbegin();
-        iter!=mExteriors.rend(); ++iter)
-    {
-        Ptr ptr = getPtrAndCache (name, iter->second);
-        if (!ptr.isEmpty())
-            return ptr;
-    }
+    Ptr ptr;
+    for (std::vector<Ptr>::const_iterator iter (found.begin()); iter!=found.end(); ++iter)
+        if (ptr.isEmpty() || isSearchedFirst (*iter->getCell(), *ptr.getCell()))
+            ptr = *iter;
 
-    for (std::map<std::string, CellStore>::iterator iter = mInteriors.begin();
-        iter!=mInteriors.end(); ++iter)
-    {
-        Ptr ptr = getPtrAndCache (name, iter->second);
-        if (!ptr.isEmpty())
-            return ptr;
-    }
+    if (!ptr.isEmpty())
+        return ptr.getCell()->search (name);
 
     // Now try the other cells
     const MWWorld::Store<ESM::Cell> &cells = mStore.get<ESM::Cell>();
@@ -226,7 +222,10 @@ MWWorld::Ptr MWWorld::Cells::getPtr (const std::string& name)
     {
         CellStore *cellStore = getCellStore (&(*iter));
 
-        Ptr ptr = getPtrAndCache (name, *cellStore);
+        if (cellStore->getState()==CellStore::State_Loaded)
+            continue;
+
+        Ptr ptr = getPtr (name, *cellStore);
 
         if (!ptr.isEmpty())
             return ptr;
@@ -236,7 +235,10 @@ MWWorld::Ptr MWWorld::Cells::getPtr (const std::string& name)
     {
         CellStore *cellStore = getCellStore (&(*iter));
 
-        Ptr ptr = getPtrAndCache (name, *cellStore);
+        if (cellStore->getState()==CellStore::State_Loaded)
+            continue;
+
+        Ptr ptr = getPtr (name, *cellStore);
 
         if (!ptr.isEmpty())
             return ptr;
@@ -253,7 +255,7 @@ void MWWorld::Cells::getExteriorPtrs(const std::string &name, std::vector<MWWorl
     {
         CellStore *cellStore = getCellStore (&(*iter));
 
-        Ptr ptr = getPtrAndCache (name, *cellStore);
+        Ptr ptr = getPtr (name, *cellStore);
 
         if (!ptr.isEmpty())
             out.push_back(ptr);
@@ -267,7 +269,7 @@ void MWWorld::Cells::getInteriorPtrs(const std::string &name, std::vector<MWWorl
     {
         CellStore *cellStore = getCellStore (&(*iter));
 
-        Ptr ptr = getPtrAndCache (name, *cellStore);
+        Ptr ptr = getPtr (name, *cellStore);
 
         if (!ptr.isEmpty())
             out.push_back(ptr);
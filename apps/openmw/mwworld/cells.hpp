@@ -3,9 +3,12 @@
 
 #include <map>
 #include <list>
+#include <set>
 #include <string>
 
 #include "ptr.hpp"
+#include "cellrefindex.hpp"
+#include "refidindex.hpp"
 
 namespace ESM
 {
@@ -15,6 +18,11 @@ namespace ESM
     struct Cell;
 }
 
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
 namespace Loading
 {
     class Listener;
@@ -28,26 +36,28 @@ namespace MWWorld
     class Cells
     {
             const MWWorld::ESMStore& mStore;
-            std::vector<ESM::ESMReader>& mReader;
+            // Kept by clear(), the references in the content files do not change between games
+            CellRefIndex mRefIndex;
+            // The references of all loaded cells, updated by the cells themselves
+            RefIdIndex mRefIdIndex;
             mutable std::map<std::string, CellStore> mInteriors;
             mutable std::map<std::pair<int, int>, CellStore> mExteriors;
-            std::vector<std::pair<std::string, CellStore *> > mIdCache;
-            std::size_t mIdCacheIndex;
 
             Cells (const Cells&);
             Cells& operator= (const Cells&);
 
             CellStore *getCellStore (const ESM::Cell *cell);
 
-            Ptr getPtrAndCache (const std::string& name, CellStore& cellStore);
-
             void writeCell (ESM::ESMWriter& writer, CellStore& cell) const;
 
         public:
 
             void clear();
 
-            Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader);
+            Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader,
+                ToUTF8::Utf8Encoder* encoder);
+
+            CellRefIndex& getRefIndex();
 
             CellStore *getExterior (int x, int y);
 
@@ -59,6 +69,11 @@ namespace MWWorld
             ///< \param searchInContainers Only affect loaded cells.
             /// @note name must be lower case
 
+            /// Search the loaded cells in \a cells, in this order. Does not check references in containers.
+            /// @note name must be lower case
+            Ptr getPtr (const std::string& name, const std::set<CellStore*>& cells);
+
+            /// Search the loaded cells first, then load the other cells that list \a name.
             /// @note name must be lower case
             Ptr getPtr (const std::string& name);
 
@@ -24,6 +24,7 @@
 #include "esmstore.hpp"
 #include "class.hpp"
 #include "containerstore.hpp"
+#include "cellrefindex.hpp"
 
 namespace
 {
@@ -233,6 +234,7 @@ namespace MWWorld
             mMovedHere.insert(std::make_pair(object.getBase(), from));
         }
         updateMergedRefs();
+        mRefIdIndex.move(object.getBase(), from, this);
     }
 
     MWWorld::Ptr CellStore::moveTo(const Ptr &object, CellStore *cellToMoveTo)
@@ -328,8 +330,8 @@ namespace MWWorld
         visitor.merge();
     }
 
-    CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList)
-        : mStore(esmStore), mReader(readerList), mCell (cell), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0)
+    CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, CellRefIndex& refIndex, RefIdIndex& refIdIndex)
+        : mStore(esmStore), mRefIndex(refIndex), mRefIdIndex(refIdIndex), mCell (cell), mState (State_Unloaded), mHasState (false), mLastRespawn(0,0)
     {
         mWaterLevel = cell->mWater;
     }
@@ -365,36 +367,26 @@ namespace MWWorld
         return searchConst (id).isEmpty();
     }
 
-    template <typename PtrType>
-    struct SearchVisitor
-    {
-        PtrType mFound;
-        std::string mIdToFind;
-        bool operator()(const PtrType& ptr)
-        {
-            if (ptr.getCellRef().getRefId() == mIdToFind)
-            {
-                mFound = ptr;
-                return false;
-            }
-            return true;
-        }
-    };
-
     Ptr CellStore::search (const std::string& id)
     {
-        SearchVisitor<MWWorld::Ptr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEach(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded)
+            return Ptr();
+
+        // Returning a non-const Ptr allows the caller to change the state of the cell, like forEach() does
+        if (!mMergedRefs.empty())
+            mHasState = true;
+
+        LiveCellRefBase* ref = mRefIdIndex.search(id, this);
+        return ref ? Ptr(ref, this) : Ptr();
     }
 
     ConstPtr CellStore::searchConst (const std::string& id) const
     {
-        SearchVisitor<MWWorld::ConstPtr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEachConst(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded)
+            return ConstPtr();
+
+        const LiveCellRefBase* ref = mRefIdIndex.search(id, this);
+        return ref ? ConstPtr(ref, this) : ConstPtr();
     }
 
     Ptr CellStore::searchViaActorId (int id)
@@ -460,45 +452,19 @@ namespace MWWorld
 
     void CellStore::listRefs()
     {
-        std::vector<ESM::ESMReader>& esm = mReader;
-
         assert (mCell);
 
         if (mCell->mContextList.empty())
             return; // this is a dynamically generated cell -> skipping.
 
-        // Load references from all plugins that do something with this cell.
-        for (size_t i = 0; i < mCell->mContextList.size(); i++)
-        {
-            try
-            {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
-
-                ESM::CellRef ref;
+        const CellRefIndex::RefList& refs = mRefIndex.getRefs (*mCell);
 
-                // Get each reference in turn
-                bool deleted = false;
-                while (mCell->getNextRef (esm[index], ref, deleted))
-                {
-                    if (deleted)
-                        continue;
-
-                    // Don't list reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
+        mIds.reserve (refs.size() + mCell->mLeasedRefs.size());
 
-                    mIds.push_back (Misc::StringUtils::lowerCase (ref.mRefID));
-                }
-            }
-            catch (std::exception& e)
-            {
-                std::cerr << "An error occurred listing references for cell " << getCell()->getDescription() << ": " << e.what() << std::endl;
-            }
+        for (CellRefIndex::RefList::const_iterator iter = refs.begin(); iter != refs.end(); ++iter)
+        {
+            if (!iter->mDeleted)
+                mIds.push_back (iter->mLowerId);
         }
 
         // List moved references, from separately tracked list.
@@ -516,8 +482,6 @@ namespace MWWorld
 
     void CellStore::loadRefs()
     {
-        std::vector<ESM::ESMReader>& esm = mReader;
-
         assert (mCell);
 
         if (mCell->mContextList.empty())
@@ -525,36 +489,14 @@ namespace MWWorld
 
         std::map<ESM::RefNum, std::string> refNumToID; // used to detect refID modifications
 
-        // Load references from all plugins that do something with this cell.
-        for (size_t i = 0; i < mCell->mContextList.size(); i++)
-        {
-            try
-            {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
+        const CellRefIndex::RefList& refs = mRefIndex.getRefs (*mCell);
 
-                ESM::CellRef ref;
-                ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
+        for (CellRefIndex::RefList::const_iterator iter = refs.begin(); iter != refs.end(); ++iter)
+        {
+            ESM::CellRef ref;
 
-                // Get each reference in turn
-                bool deleted = false;
-                while(mCell->getNextRef(esm[index], ref, deleted))
-                {
-                    // Don't load reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
-
-                    loadRef (ref, deleted, refNumToID);
-                }
-            }
-            catch (std::exception& e)
-            {
-                std::cerr << "An error occurred loading references for cell " << getCell()->getDescription() << ": " << e.what() << std::endl;
-            }
+            if (mRefIndex.readRef (*mCell, *iter, ref))
+                loadRef (ref, iter->mDeleted, refNumToID);
         }
 
         // Load moved references, from separately tracked list.
@@ -567,6 +509,9 @@ namespace MWWorld
         }
 
         updateMergedRefs();
+
+        for (std::vector<LiveCellRefBase*>::const_iterator it = mMergedRefs.begin(); it != mMergedRefs.end(); ++it)
+            mRefIdIndex.insert(*it, this);
     }
 
     bool CellStore::isExterior() const
@@ -744,6 +689,10 @@ namespace MWWorld
     {
         mHasState = true;
 
+        // The saved state may change the IDs of existing references and add new ones, index them again afterwards
+        for (std::vector<LiveCellRefBase*>::const_iterator it = mMergedRefs.begin(); it != mMergedRefs.end(); ++it)
+            mRefIdIndex.erase(*it, this);
+
         while (reader.isNextSub ("OBJE"))
         {
             unsigned int unused;
@@ -878,6 +827,9 @@ namespace MWWorld
         // This update is only needed for old saves that used the old copy&delete way of moving objects
         updateMergedRefs();
 
+        for (std::vector<LiveCellRefBase*>::const_iterator it = mMergedRefs.begin(); it != mMergedRefs.end(); ++it)
+            mRefIdIndex.insert(*it, this);
+
         while (reader.isNextSub("MVRF"))
         {
             reader.cacheSubName();
@@ -10,6 +10,7 @@
 
 #include "livecellref.hpp"
 #include "cellreflist.hpp"
+#include "refidindex.hpp"
 
 #include <components/esm/loadacti.hpp>
 #include <components/esm/loadalch.hpp>
@@ -46,6 +47,7 @@ namespace ESM
 namespace MWWorld
 {
     class ESMStore;
+    class CellRefIndex;
 
     /// \brief Mutable state of a cell
     class CellStore
@@ -60,7 +62,8 @@ namespace MWWorld
         private:
 
             const MWWorld::ESMStore& mStore;
-            std::vector<ESM::ESMReader>& mReader;
+            CellRefIndex& mRefIndex;
+            RefIdIndex& mRefIdIndex;
 
             // Even though fog actually belongs to the player and not cells,
             // it makes sense to store it here since we need it once for each cell.
@@ -193,13 +196,16 @@ namespace MWWorld
                 CellRefList<T>& list = get<T>();
                 LiveCellRefBase* ret = &list.insert(*ref);
                 updateMergedRefs();
+                mRefIdIndex.insert(ret, this);
                 return ret;
             }
 
-            /// @param readerList The readers to use for loading of the cell on-demand.
+            /// @param refIndex The references to use for loading of the cell on-demand.
+            /// @param refIdIndex Index to add the references of this cell to once it is loaded.
             CellStore (const ESM::Cell *cell_,
                        const MWWorld::ESMStore& store,
-                       std::vector<ESM::ESMReader>& readerList);
+                       CellRefIndex& refIndex,
+                       RefIdIndex& refIdIndex);
 
             const ESM::Cell *getCell() const;
 
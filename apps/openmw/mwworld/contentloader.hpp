@@ -28,6 +28,12 @@ struct ContentLoader
       mListener.setLabel(MyGUI::TextIterator::toTagsString(filepath.string()));
     }
 
+    /// Called after the last content file was passed to load(). Loaders that load files asynchronously
+    /// must have completed all of them when this returns.
+    virtual void finish()
+    {
+    }
+
     protected:
         Loading::Listener& mListener;
 };
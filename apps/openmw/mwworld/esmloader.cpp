@@ -1,18 +1,109 @@
 #include "esmloader.hpp"
 #include "esmstore.hpp"
 
+#include <iostream>
+#include <algorithm>
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+
+#include <OpenThreads/Thread>
+
+#include <osg/Timer>
+
 #include <components/esm/esmreader.hpp>
+#include <components/files/mappedfile.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 namespace MWWorld
 {
 
+/// Reads the stageable records of a content file on a worker thread.
+class StageContentFileItem : public SceneUtil::WorkItem
+{
+public:
+    StageContentFileItem(const ESMStore& store, std::shared_ptr<const Files::MappedFile> file,
+                         const std::string& filename, int index, ToUTF8::Utf8Encoder* encoder)
+        : mStore(store)
+        , mFile(file)
+        , mFilename(filename)
+        , mIndex(index)
+        , mFailed(false)
+        , mDuration(0.0)
+    {
+        // The encoder keeps an internal buffer, so every worker needs its own
+        if (encoder)
+            mEncoder.reset(new ToUTF8::Utf8Encoder(*encoder));
+    }
+
+    virtual void doWork()
+    {
+        osg::Timer timer;
+        try
+        {
+            ESM::ESMReader esm;
+            esm.setEncoder(mEncoder.get());
+            esm.setIndex(mIndex);
+            esm.open(Files::IStreamPtr(new Files::MappedFileStream(mFile, 0, mFile->getSize())), mFilename);
+            mStore.stage(esm, mStaged);
+        }
+        catch (std::exception& e)
+        {
+            mError = e.what();
+            mFailed = true;
+        }
+        mDuration = timer.time_m();
+    }
+
+    const StagedContentFile& getStaged() const { return mStaged; }
+
+    /// Free the staged records as soon as they have been merged.
+    void releaseStaged() { StagedContentFile().mEntries.swap(mStaged.mEntries); }
+
+    bool hasFailed() const { return mFailed; }
+    const std::string& getError() const { return mError; }
+
+    /// Time spent staging, in milliseconds.
+    double getDuration() const { return mDuration; }
+
+    const std::string& getFilename() const { return mFilename; }
+
+private:
+    const ESMStore& mStore;
+    std::shared_ptr<const Files::MappedFile> mFile;
+    std::string mFilename;
+    int mIndex;
+    std::unique_ptr<ToUTF8::Utf8Encoder> mEncoder;
+
+    StagedContentFile mStaged;
+    bool mFailed;
+    std::string mError;
+    double mDuration;
+};
+
 EsmLoader::EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
-  ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener)
+  ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener, bool parallel)
   : ContentLoader(listener)
   , mEsm(readers)
   , mStore(store)
   , mEncoder(encoder)
+  , mSkipCachedRecords(false)
+  , mStageTime(0.0)
+  , mMergeTime(0.0)
+  , mWaitTime(0.0)
 {
+    if (parallel)
+        mWorkQueue = new SceneUtil::WorkQueue(std::max(1, OpenThreads::GetNumberOfProcessors()));
+}
+
+EsmLoader::~EsmLoader()
+{
+    // Make sure no worker is still using the store when an exception left files unmerged
+    for (std::deque<PendingFile>::iterator it = mPending.begin(); it != mPending.end(); ++it)
+    {
+        it->mItem->cancel();
+        it->mItem->waitTillDone();
+    }
 }
 
 void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
@@ -23,9 +114,115 @@ void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
   lEsm.setEncoder(mEncoder);
   lEsm.setIndex(index);
   lEsm.setGlobalReaderList(&mEsm);
-  lEsm.open(filepath.string());
+
+  // Staging reads the file twice and the main reader has to seek to the records that were not staged,
+  // while skipping cached records seeks over most of the file; both are cheap on a mapped file
+  std::shared_ptr<const Files::MappedFile> file;
+  if (mWorkQueue || mSkipCachedRecords)
+  {
+      try
+      {
+          file.reset(new Files::MappedFile(filepath.string()));
+      }
+      catch (std::exception& e)
+      {
+          std::cerr << "Warning: " << e.what() << ", reading " << filepath.string() << " as a stream" << std::endl;
+      }
+  }
+
+  if (file)
+      lEsm.open(Files::IStreamPtr(new Files::MappedFileStream(file, 0, file->getSize())), filepath.string());
+  else
+      lEsm.open(filepath.string());
+
   mEsm[index] = lEsm;
-  mStore.load(mEsm[index], &mListener);
+
+  if (!mWorkQueue)
+  {
+      osg::Timer timer;
+      if (mSkipCachedRecords)
+          mStore.loadUncached(mEsm[index], &mListener);
+      else
+          mStore.load(mEsm[index], &mListener);
+      mMergeTime += timer.time_m();
+      mListener.reportTime("Loaded " + filepath.filename().string(), timer.time_m());
+      return;
+  }
+
+  osg::ref_ptr<StageContentFileItem> item;
+  if (file)
+      item = new StageContentFileItem(mStore, file, filepath.string(), index, mEncoder);
+
+  PendingFile pending;
+  pending.mItem = item;
+  pending.mIndex = index;
+  mPending.push_back(pending);
+  if (item)
+      mWorkQueue->addWorkItem(item, SceneUtil::WorkQueue::Priority_High);
+
+  mergePending(false);
+}
+
+void EsmLoader::finish()
+{
+    mergePending(true);
+
+    if (mWorkQueue)
+    {
+        mListener.reportTime("Staged all content files on worker threads", mStageTime);
+        mListener.reportTime("Merged all content files", mMergeTime);
+        mListener.reportTime("Waited for staging", mWaitTime);
+    }
+    else
+        mListener.reportTime("Loaded all content files", mMergeTime);
+}
+
+void EsmLoader::setSkipCachedRecords(bool skip)
+{
+    mSkipCachedRecords = skip;
+}
+
+void EsmLoader::mergePending(bool wait)
+{
+    while (!mPending.empty())
+    {
+        PendingFile& pending = mPending.front();
+        StageContentFileItem* item = pending.mItem.get();
+        if (item && !wait && !item->isDone())
+            return;
+
+        ESM::ESMReader& esm = mEsm[pending.mIndex];
+        std::string filename = boost::filesystem::path(esm.getName()).filename().string();
+        mListener.setLabel(MyGUI::TextIterator::toTagsString(filename));
+
+        osg::Timer timer;
+        if (!item)
+            mStore.load(esm, &mListener);
+        else
+        {
+            item->waitTillDone();
+            double waited = timer.time_m();
+            mWaitTime += waited;
+            mStageTime += item->getDuration();
+            mListener.reportTime("Staged " + filename, item->getDuration());
+            mListener.reportTime("Waited for " + filename, waited);
+
+            timer.setStartTick();
+            if (item->hasFailed())
+            {
+                // Let the regular loader report the error in load order, if it runs into it too
+                std::cerr << "Warning: failed to stage " << item->getFilename() << ": " << item->getError() << std::endl;
+                mStore.load(esm, &mListener);
+            }
+            else
+                mStore.load(esm, item->getStaged(), &mListener);
+            item->releaseStaged();
+        }
+        mMergeTime += timer.time_m();
+        mListener.reportTime("Merged " + filename, timer.time_m());
+
+        mPending.pop_front();
+    }
 }
 
 } /* namespace MWWorld */
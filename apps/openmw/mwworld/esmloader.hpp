@@ -2,6 +2,9 @@
 #define ESMLOADER_HPP
 
 #include <vector>
+#include <deque>
+
+#include <osg/ref_ptr>
 
 #include "contentloader.hpp"
 
@@ -15,22 +18,58 @@ namespace ESM
     class ESMReader;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWWorld
 {
 
 class ESMStore;
+class StageContentFileItem;
 
+/// @brief Loads ESM/ESP content files into the ESMStore.
+/// @par In parallel mode, the records of each content file are read on worker threads (see ESMStore::stage) as soon
+/// as the file is passed to load(), and are applied to the store in load order on the calling thread.
+/// finish() must be called after the last file to apply the files that are still pending.
 struct EsmLoader : public ContentLoader
 {
     EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
-      ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener);
+      ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener, bool parallel=false);
+    ~EsmLoader();
 
     void load(const boost::filesystem::path& filepath, int& index);
 
+    void finish();
+
+    /// Skip the records that are restored from a StoreCache instead, see ESMStore::loadUncached().
+    /// @note Not supported in parallel mode.
+    void setSkipCachedRecords(bool skip);
+
     private:
+      /// Apply the pending files in load order.
+      /// @param wait Wait for all pending files to be staged, rather than stopping at the first one that is not.
+      void mergePending(bool wait);
+
+      struct PendingFile
+      {
+          osg::ref_ptr<StageContentFileItem> mItem;
+          int mIndex;
+      };
+
       std::vector<ESM::ESMReader>& mEsm;
       MWWorld::ESMStore& mStore;
       ToUTF8::Utf8Encoder* mEncoder;
+      bool mSkipCachedRecords;
+
+      osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+      std::deque<PendingFile> mPending;
+
+      /// Total time of each stage over all files so far, in milliseconds, reported by finish().
+      double mStageTime;
+      double mMergeTime;
+      double mWaitTime;
 };
 
 } /* namespace MWWorld */
@@ -28,6 +28,73 @@ static bool isCacheableRecord(int id)
 }
 
 void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
+{
+    loadRecords(esm, NULL, false, listener);
+}
+
+void ESMStore::load(ESM::ESMReader &esm, const StagedContentFile& staged, Loading::Listener* listener)
+{
+    loadRecords(esm, &staged, false, listener);
+}
+
+void ESMStore::loadUncached(ESM::ESMReader &esm, Loading::Listener* listener)
+{
+    loadRecords(esm, NULL, true, listener);
+}
+
+void ESMStore::writeCache(ESM::ESMWriter &writer) const
+{
+    // Records that can be staged do not depend on any other record, so their stores can be written one by one
+    for (std::map<int, StoreBase *>::const_iterator it = mStores.begin(); it != mStores.end(); ++it)
+    {
+        if (it->second->canStage())
+            it->second->writeStatic(writer);
+    }
+}
+
+void ESMStore::readCache(ESM::ESMReader &esm, Loading::Listener* listener)
+{
+    listener->setProgressRange(1000);
+
+    while(esm.hasMoreRecs())
+    {
+        ESM::NAME n = esm.getRecName();
+        esm.getRecHeader();
+
+        std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
+        if (it == mStores.end() || !it->second->canStage())
+            esm.fail("Unexpected record in cache: " + n.toString());
+
+        it->second->load(esm);
+
+        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+    }
+}
+
+void ESMStore::stage(ESM::ESMReader &esm, StagedContentFile &staged) const
+{
+    while(esm.hasMoreRecs())
+    {
+        ESM::NAME n = esm.getRecName();
+        esm.getRecHeader();
+
+        StagedContentFile::Entry entry;
+        entry.mType = n.intval;
+
+        std::map<int, StoreBase *>::const_iterator it = mStores.find(n.intval);
+        if (it != mStores.end() && it->second->canStage())
+            entry.mRecord.reset(it->second->stage(esm));
+        else
+        {
+            entry.mContext = esm.getContext();
+            esm.skipRecord();
+        }
+
+        staged.mEntries.push_back(entry);
+    }
+}
+
+void ESMStore::loadRecords(ESM::ESMReader &esm, const StagedContentFile* staged, bool skipCached, Loading::Listener* listener)
 {
     listener->setProgressRange(1000);
 
@@ -68,15 +135,45 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
     }
 
     // Loop through all records
-    while(esm.hasMoreRecs())
+    size_t numStaged = staged ? staged->mEntries.size() : 0;
+    for (size_t i = 0; staged ? i < numStaged : esm.hasMoreRecs(); ++i)
     {
-        ESM::NAME n = esm.getRecName();
-        esm.getRecHeader();
+        ESM::NAME n;
+        if (staged)
+        {
+            const StagedContentFile::Entry& entry = staged->mEntries[i];
+            if (entry.mRecord)
+            {
+                StoreBase* store = mStores[entry.mType];
+                RecordId id = store->merge(*entry.mRecord);
+                if (id.mIsDeleted)
+                    store->eraseStatic(id.mId);
+                else
+                    dialogue = 0;
+
+                listener->setProgress(i * 1000 / numStaged);
+                continue;
+            }
+
+            // Continue reading at the position where the staging reader left this record
+            esm.restoreContext(entry.mContext);
+            n = entry.mContext.recName;
+        }
+        else
+        {
+            n = esm.getRecName();
+            esm.getRecHeader();
+        }
 
         // Look up the record type.
         std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
 
-        if (it == mStores.end()) {
+        if (skipCached && it != mStores.end() && it->second->canStage())
+        {
+            esm.skipRecord();
+            dialogue = 0;
+        }
+        else if (it == mStores.end()) {
             if (n.intval == ESM::REC_INFO) {
                 if (dialogue)
                 {
@@ -107,16 +204,17 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
             if (id.mIsDeleted)
             {
                 it->second->eraseStatic(id.mId);
-                continue;
             }
-
-            if (n.intval==ESM::REC_DIAL) {
+            else if (n.intval==ESM::REC_DIAL) {
                 dialogue = const_cast<ESM::Dialogue*>(mDialogs.find(id.mId));
             } else {
                 dialogue = 0;
             }
         }
-        listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
+        if (staged)
+            listener->setProgress(i * 1000 / numStaged);
+        else
+            listener->setProgress(static_cast<size_t>(esm.getFileOffset() / (float)esm.getFileSize() * 1000));
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <memory>
 
 #include <components/esm/records.hpp>
 #include "store.hpp"
@@ -14,6 +15,29 @@ namespace Loading
 
 namespace MWWorld
 {
+    /// Records of a content file read ahead of time by ESMStore::stage(), in the order they appear in the file.
+    struct StagedContentFile
+    {
+        struct Entry
+        {
+            Entry()
+                : mType(0)
+                , mContext()
+            {
+            }
+
+            int mType;
+
+            /// The record, or empty if it can not be read independently of the previously loaded records.
+            std::shared_ptr<StagedRecord> mRecord;
+
+            /// Position of the record in the content file, to read it in load order if it was not staged.
+            ESM::ESM_Context mContext;
+        };
+
+        std::vector<Entry> mEntries;
+    };
+
     class ESMStore
     {
         Store<ESM::Activator>       mActivators;
@@ -77,6 +101,8 @@ namespace MWWorld
         /// Validate entries in store after setup
         void validate();
 
+        void loadRecords(ESM::ESMReader &esm, const StagedContentFile* staged, bool skipCached, Loading::Listener* listener);
+
     public:
         /// \todo replace with SharedIterator<StoreBase>
         typedef std::map<int, StoreBase *>::const_iterator iterator;
@@ -163,6 +189,27 @@ namespace MWWorld
 
         void load(ESM::ESMReader &esm, Loading::Listener* listener);
 
+        /// Read all records of a content file that do not depend on the records loaded before them,
+        /// without modifying the store.
+        /// @note May be called from a worker thread while the main thread loads other content files,
+        /// as long as the given reader is not shared with anyone else.
+        void stage(ESM::ESMReader &esm, StagedContentFile& staged) const;
+
+        /// Load a content file that was staged by stage(), with the same result as load(). The records that
+        /// could not be staged are read from the given reader. Must be called in load order.
+        void load(ESM::ESMReader &esm, const StagedContentFile& staged, Loading::Listener* listener);
+
+        /// Load a content file, except for the records that are restored by readCache() instead.
+        void loadUncached(ESM::ESMReader &esm, Loading::Listener* listener);
+
+        /// Write the records loaded from content files that can be restored by readCache().
+        /// @note Must be called before any dynamic records are added.
+        void writeCache(ESM::ESMWriter &writer) const;
+
+        /// Read the remaining records of \a esm, written by writeCache(), after the content files
+        /// were loaded with loadUncached().
+        void readCache(ESM::ESMReader &esm, Loading::Listener* listener);
+
         template <class T>
         const Store<T> &get() const {
             throw std::runtime_error("Storage for this type not exist");
@@ -42,6 +42,20 @@ namespace MWWorld
         {
             mVariables.insert (std::make_pair (Misc::StringUtils::lowerCase (iter->mId), *iter));
         }
+
+        for (Collection::const_iterator iter (mVariables.begin()); iter!=mVariables.end(); ++iter)
+            mSlotIndices.insert (std::make_pair (iter->first, static_cast<int> (mSlotIndices.size())));
+
+        mSlots.assign (mSlotIndices.size(), 0);
+
+        for (std::map<std::string, int>::const_iterator iter (mSlotIndices.begin()); iter!=mSlotIndices.end();
+            ++iter)
+        {
+            Collection::iterator variable = mVariables.find (iter->first);
+
+            if (variable!=mVariables.end())
+                mSlots[iter->second] = &variable->second.mValue;
+        }
     }
 
     const ESM::Variant& Globals::operator[] (const std::string& name) const
@@ -54,6 +68,32 @@ namespace MWWorld
         return find (Misc::StringUtils::lowerCase (name))->second.mValue;
     }
 
+    int Globals::getSlot (const std::string& name) const
+    {
+        std::map<std::string, int>::const_iterator iter = mSlotIndices.find (Misc::StringUtils::lowerCase (name));
+
+        if (iter==mSlotIndices.end() || !mSlots[iter->second])
+            return -1;
+
+        return iter->second;
+    }
+
+    const ESM::Variant& Globals::getValue (int slot) const
+    {
+        if (slot<0 || slot>=static_cast<int> (mSlots.size()) || !mSlots[slot])
+            throw std::runtime_error ("unknown global variable slot");
+
+        return *mSlots[slot];
+    }
+
+    ESM::Variant& Globals::getValue (int slot)
+    {
+        if (slot<0 || slot>=static_cast<int> (mSlots.size()) || !mSlots[slot])
+            throw std::runtime_error ("unknown global variable slot");
+
+        return *mSlots[slot];
+    }
+
     char Globals::getType (const std::string& name) const
     {
         Collection::const_iterator iter = mVariables.find (Misc::StringUtils::lowerCase (name));
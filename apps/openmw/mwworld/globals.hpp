@@ -33,6 +33,11 @@ namespace MWWorld
 
             Collection mVariables; // type, value
 
+            // Slots are handed out to the compiled scripts, so they must remain valid when the variables are
+            // replaced by fill().
+            std::map<std::string, int> mSlotIndices;
+            std::vector<ESM::Variant *> mSlots; // 0 for variables that do not exist anymore
+
             Collection::const_iterator find (const std::string& name) const;
 
             Collection::iterator find (const std::string& name);
@@ -43,6 +48,15 @@ namespace MWWorld
 
             ESM::Variant& operator[] (const std::string& name);
 
+            int getSlot (const std::string& name) const;
+            ///< Return a number that refers to the variable \a name from now on, also across fill().
+            ///
+            /// \return -1, if there is no global variable with this name.
+
+            const ESM::Variant& getValue (int slot) const;
+
+            ESM::Variant& getValue (int slot);
+
             char getType (const std::string& name) const;
             ///< If there is no global variable with this name, ' ' is returned.
 
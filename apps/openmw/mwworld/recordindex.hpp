@@ -0,0 +1,162 @@
+#ifndef OPENMW_MWWORLD_RECORDINDEX_H
+#define OPENMW_MWWORLD_RECORDINDEX_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <components/misc/stringops.hpp>
+
+namespace MWWorld
+{
+    /// @brief Case-insensitive hash table from record ids to records, stored in a single flat array.
+    /// @par Lookups hash and compare the id as lower case on the fly, so unlike a std::map keyed by lower case ids
+    /// they need no temporary copy of the id.
+    /// @note Does not own the records or keys. The key passed to insert() must remain valid as long as
+    /// the entry is in the index.
+    template <class T>
+    class RecordIndex
+    {
+    public:
+        RecordIndex()
+            : mSize(0)
+        {
+        }
+
+        /// Hash \a id, ignoring case. The result is to be passed to find().
+        static size_t hash(const char* id, size_t length)
+        {
+            // FNV-1a
+            size_t hash = static_cast<size_t>(2166136261u);
+            for (size_t i = 0; i < length; ++i)
+            {
+                hash ^= static_cast<unsigned char>(Misc::StringUtils::toLower(id[i]));
+                hash *= static_cast<size_t>(16777619u);
+            }
+            return hash;
+        }
+
+        /// @param id Id of any case.
+        /// @param hash Result of hash() for \a id.
+        T* find(const char* id, size_t length, size_t hash) const
+        {
+            if (mSlots.empty())
+                return NULL;
+
+            size_t mask = mSlots.size() - 1;
+            for (size_t slot = hash & mask; mSlots[slot].mKey; slot = (slot + 1) & mask)
+            {
+                const Slot& entry = mSlots[slot];
+                if (entry.mHash == hash && equal(id, length, *entry.mKey))
+                    return entry.mRecord;
+            }
+            return NULL;
+        }
+
+        /// @param key Lower case id of the record, not yet in the index.
+        void insert(const std::string* key, T* record)
+        {
+            if ((mSize + 1) * 4 > mSlots.size() * 3)
+                rehash(std::max<size_t>(16, mSlots.size() * 2));
+
+            Slot entry;
+            entry.mHash = hash(key->c_str(), key->size());
+            entry.mKey = key;
+            entry.mRecord = record;
+            place(entry);
+            ++mSize;
+        }
+
+        /// @param key Lower case id of the record.
+        void erase(const std::string& key)
+        {
+            if (mSlots.empty())
+                return;
+
+            size_t mask = mSlots.size() - 1;
+            size_t hash = RecordIndex::hash(key.c_str(), key.size());
+            size_t slot = hash & mask;
+            for (; mSlots[slot].mKey; slot = (slot + 1) & mask)
+            {
+                if (mSlots[slot].mHash == hash && *mSlots[slot].mKey == key)
+                    break;
+            }
+            if (!mSlots[slot].mKey)
+                return;
+
+            // Move the following entries of the probe sequence back, so that no tombstones are needed
+            size_t next = slot;
+            while (true)
+            {
+                next = (next + 1) & mask;
+                if (!mSlots[next].mKey)
+                    break;
+
+                size_t ideal = mSlots[next].mHash & mask;
+                bool movable = (next > slot) ? (ideal <= slot || ideal > next) : (ideal <= slot && ideal > next);
+                if (movable)
+                {
+                    mSlots[slot] = mSlots[next];
+                    slot = next;
+                }
+            }
+            mSlots[slot] = Slot();
+            --mSize;
+        }
+
+        void clear()
+        {
+            mSlots.clear();
+            mSize = 0;
+        }
+
+        size_t size() const { return mSize; }
+
+    private:
+        struct Slot
+        {
+            Slot() : mHash(0), mKey(NULL), mRecord(NULL) {}
+
+            size_t mHash;
+            const std::string* mKey; ///< NULL for empty slots
+            T* mRecord;
+        };
+
+        static bool equal(const char* id, size_t length, const std::string& key)
+        {
+            if (key.size() != length)
+                return false;
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (Misc::StringUtils::toLower(id[i]) != key[i])
+                    return false;
+            }
+            return true;
+        }
+
+        void place(const Slot& entry)
+        {
+            size_t mask = mSlots.size() - 1;
+            size_t slot = entry.mHash & mask;
+            while (mSlots[slot].mKey)
+                slot = (slot + 1) & mask;
+            mSlots[slot] = entry;
+        }
+
+        void rehash(size_t size)
+        {
+            std::vector<Slot> slots(size);
+            mSlots.swap(slots);
+            for (typename std::vector<Slot>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+            {
+                if (it->mKey)
+                    place(*it);
+            }
+        }
+
+        std::vector<Slot> mSlots; ///< Size is zero or a power of two
+        size_t mSize;
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include "refidindex.hpp"
+
+#include "cellstore.hpp"
+
+namespace MWWorld
+{
+    void RefIdIndex::insert (LiveCellRefBase* ref, CellStore* cell)
+    {
+        mIndex.insert (std::make_pair (std::make_pair (ref->mRef.getRefId(), cell), ref));
+    }
+
+    void RefIdIndex::erase (LiveCellRefBase* ref, CellStore* cell)
+    {
+        std::pair<Index::iterator, Index::iterator> range =
+            mIndex.equal_range (std::make_pair (ref->mRef.getRefId(), cell));
+
+        for (Index::iterator iter = range.first; iter!=range.second; ++iter)
+            if (iter->second==ref)
+            {
+                mIndex.erase (iter);
+                return;
+            }
+    }
+
+    void RefIdIndex::move (LiveCellRefBase* ref, CellStore* from, CellStore* to)
+    {
+        erase (ref, from);
+        insert (ref, to);
+    }
+
+    void RefIdIndex::clear()
+    {
+        mIndex.clear();
+    }
+
+    LiveCellRefBase* RefIdIndex::search (const std::string& id, const CellStore* cell) const
+    {
+        std::pair<Index::const_iterator, Index::const_iterator> range =
+            mIndex.equal_range (std::make_pair (id, const_cast<CellStore*> (cell)));
+
+        for (Index::const_iterator iter = range.first; iter!=range.second; ++iter)
+            if (CellStore::isAccessible (iter->second->mData, iter->second->mRef))
+                return iter->second;
+
+        return NULL;
+    }
+
+    Ptr RefIdIndex::search (const std::string& id, const std::set<CellStore*>& cells) const
+    {
+        // The index is ordered by cell within each ID, the same order as cells
+        for (Index::const_iterator iter = mIndex.lower_bound (std::make_pair (id, static_cast<CellStore*> (NULL)));
+            iter!=mIndex.end() && iter->first.first==id; ++iter)
+        {
+            if (cells.find (iter->first.second)!=cells.end()
+                && CellStore::isAccessible (iter->second->mData, iter->second->mRef))
+                return Ptr (iter->second, iter->first.second);
+        }
+
+        return Ptr();
+    }
+
+    void RefIdIndex::search (const std::string& id, std::vector<Ptr>& out) const
+    {
+        for (Index::const_iterator iter = mIndex.lower_bound (std::make_pair (id, static_cast<CellStore*> (NULL)));
+            iter!=mIndex.end() && iter->first.first==id; ++iter)
+        {
+            if (CellStore::isAccessible (iter->second->mData, iter->second->mRef))
+                out.push_back (Ptr (iter->second, iter->first.second));
+        }
+    }
+}
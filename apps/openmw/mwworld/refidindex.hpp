@@ -0,0 +1,62 @@
+#ifndef GAME_MWWORLD_REFIDINDEX_H
+#define GAME_MWWORLD_REFIDINDEX_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ptr.hpp"
+
+namespace MWWorld
+{
+    class CellStore;
+    struct LiveCellRefBase;
+
+    /// \brief Live references of all loaded cells by ref ID
+    ///
+    /// Kept up to date by the CellStores when references are loaded, inserted, moved to another cell or read from a
+    /// saved game, so that a reference can be found by its ID without visiting the cells.
+    ///
+    /// References deleted by setCount(0) stay in the index, because they are not removed from their cell and may be
+    /// restored. Like CellStore::forEach(), the searches skip references that are not accessible.
+    class RefIdIndex
+    {
+        public:
+
+            void insert (LiveCellRefBase* ref, CellStore* cell);
+            ///< Add \a ref, which is now in \a cell.
+
+            void erase (LiveCellRefBase* ref, CellStore* cell);
+            ///< Remove \a ref, which is currently in \a cell.
+
+            void move (LiveCellRefBase* ref, CellStore* from, CellStore* to);
+            ///< \a ref has been moved from \a from to \a to.
+
+            void clear();
+
+            LiveCellRefBase* search (const std::string& id, const CellStore* cell) const;
+            ///< Return the first accessible reference with the ID \a id in \a cell.
+            /// @note id must be lower case
+
+            Ptr search (const std::string& id, const std::set<CellStore*>& cells) const;
+            ///< Return the first accessible reference with the ID \a id in any of \a cells. The cells are checked in
+            /// the order of \a cells.
+            /// @note id must be lower case
+            /// @note Does not trigger CellStore hasState flag, get Ptrs that may be changed through CellStore::search().
+
+            void search (const std::string& id, std::vector<Ptr>& out) const;
+            ///< Append all accessible references with the ID \a id in loaded cells to \a out.
+            /// @note id must be lower case
+            /// @note Does not trigger CellStore hasState flag, get Ptrs that may be changed through CellStore::search().
+
+        private:
+
+            // References in the same cell with the same ID are kept in the order they were added
+            typedef std::multimap<std::pair<std::string, CellStore*>, LiveCellRefBase*> Index;
+
+            Index mIndex;
+    };
+}
+
+#endif
@@ -8,6 +8,13 @@
 #include <components/settings/settings.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/scenemanager.hpp>
+#include <components/resource/imagemanager.hpp>
+#include <components/resource/keyframemanager.hpp>
+#include <components/resource/niffilemanager.hpp>
+#include <components/resource/bulletshapemanager.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <osg/Timer>
 
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
@@ -27,6 +34,7 @@
 #include "cellvisitors.hpp"
 #include "cellstore.hpp"
 #include "cellpreloader.hpp"
+#include "cellrefindex.hpp"
 
 namespace
 {
@@ -363,6 +371,8 @@ namespace MWWorld
         std::string loadingExteriorText = "#{sLoadingMessage3}";
         loadingListener->setLabel(loadingExteriorText);
 
+        osg::Timer_t startTick = osg::Timer::instance()->tick();
+
         CellStoreCollection::iterator active = mActiveCells.begin();
         while (active!=mActiveCells.end())
         {
@@ -379,8 +389,13 @@ namespace MWWorld
             unloadCell (active++);
         }
 
+        osg::Timer_t unloadedTick = osg::Timer::instance()->tick();
+
+        int cellsToLoad = 0;
         int refsToLoad = 0;
         // get the number of refs to load
+        // getExterior() populates the cell stores on the main thread, only their references were read ahead of time
+        // (see CellRefIndex::prefetch), so the "cell stores" time below is the part a background population would remove
         for (int x=X-mHalfGridSize; x<=X+mHalfGridSize; ++x)
         {
             for (int y=Y-mHalfGridSize; y<=Y+mHalfGridSize; ++y)
@@ -399,10 +414,15 @@ namespace MWWorld
                 }
 
                 if (iter==mActiveCells.end())
+                {
                     refsToLoad += MWBase::Environment::get().getWorld()->getExterior(x, y)->count();
+                    ++cellsToLoad;
+                }
             }
         }
 
+        osg::Timer_t listedTick = osg::Timer::instance()->tick();
+
         loadingListener->setProgressRange(refsToLoad);
 
         // Load cells
@@ -432,6 +452,14 @@ namespace MWWorld
             }
         }
 
+        osg::Timer_t loadedTick = osg::Timer::instance()->tick();
+
+        std::cout << "Changed cell grid to " << X << ", " << Y << ": loaded " << cellsToLoad << " cells with "
+            << refsToLoad << " references in " << osg::Timer::instance()->delta_m(startTick, loadedTick) << " ms (unloading "
+            << osg::Timer::instance()->delta_m(startTick, unloadedTick) << " ms, cell stores "
+            << osg::Timer::instance()->delta_m(unloadedTick, listedTick) << " ms, inserting "
+            << osg::Timer::instance()->delta_m(listedTick, loadedTick) << " ms)" << std::endl;
+
         CellStore* current = MWBase::Environment::get().getWorld()->getExterior(X,Y);
         MWBase::Environment::get().getWindowManager()->changeCell(current);
 
@@ -476,8 +504,8 @@ namespace MWWorld
         mLastPlayerPos = pos.asVec3();
     }
 
-    Scene::Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics)
-    : mCurrentCell (0), mCellChanged (false), mPhysics(physics), mRendering(rendering)
+    Scene::Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics, CellRefIndex& refIndex)
+    : mCurrentCell (0), mCellChanged (false), mPhysics(physics), mRendering(rendering), mRefIndex(refIndex)
     , mPreloadTimer(0.f)
     , mHalfGridSize(Settings::Manager::getInt("exterior cell load distance", "Cells"))
     , mCellLoadingThreshold(1024.f)
@@ -494,7 +522,15 @@ namespace MWWorld
         mPreloader->setUnrefQueue(rendering.getUnrefQueue());
         mPhysics->setUnrefQueue(rendering.getUnrefQueue());
 
-        rendering.getResourceSystem()->setExpiryDelay(Settings::Manager::getFloat("cache expiry delay", "Cells"));
+        Resource::ResourceSystem* resourceSystem = rendering.getResourceSystem();
+        resourceSystem->setExpiryDelay(Settings::Manager::getFloat("cache expiry delay", "Cells"));
+
+        const size_t megabyte = 1024*1024;
+        resourceSystem->getSceneManager()->setCacheBudget(std::max(0, Settings::Manager::getInt("model cache budget", "Cells")) * megabyte);
+        resourceSystem->getImageManager()->setCacheBudget(std::max(0, Settings::Manager::getInt("texture cache budget", "Cells")) * megabyte);
+        resourceSystem->getKeyframeManager()->setCacheBudget(std::max(0, Settings::Manager::getInt("animation cache budget", "Cells")) * megabyte);
+        resourceSystem->getNifFileManager()->setCacheBudget(std::max(0, Settings::Manager::getInt("nif cache budget", "Cells")) * megabyte);
+        physics->getShapeManager()->setCacheBudget(std::max(0, Settings::Manager::getInt("collision shape cache budget", "Cells")) * megabyte);
 
         mPreloader->setExpiryDelay(Settings::Manager::getFloat("preload cell expiry delay", "Cells"));
         mPreloader->setMinCacheSize(Settings::Manager::getInt("preload cell cache min", "Cells"));
@@ -690,7 +726,7 @@ namespace MWWorld
             mesh_ = Misc::ResourceHelpers::correctActorModelPath(mesh_, mRendering.getResourceSystem()->getVFS());
 
         if (!mRendering.getResourceSystem()->getSceneManager()->checkLoaded(mesh_, mRendering.getReferenceTime()))
-            mRendering.getWorkQueue()->addWorkItem(new PreloadMeshItem(mesh_, mRendering.getResourceSystem()->getSceneManager()));
+            mRendering.getWorkQueue()->addWorkItem(new PreloadMeshItem(mesh_, mRendering.getResourceSystem()->getSceneManager()), SceneUtil::WorkQueue::Priority_Preload);
     }
 
     void Scene::preloadCells(float dt)
@@ -749,13 +785,17 @@ namespace MWWorld
                 try
                 {
                     if (!door.getCellRef().getDestCell().empty())
-                        preloadCell(MWBase::Environment::get().getWorld()->getInterior(door.getCellRef().getDestCell()));
+                    {
+                        if (prefetchInterior(door.getCellRef().getDestCell()))
+                            preloadCell(MWBase::Environment::get().getWorld()->getInterior(door.getCellRef().getDestCell()));
+                    }
                     else
                     {
                         osg::Vec3f pos = door.getCellRef().getDoorDest().asVec3();
                         int x,y;
                         MWBase::Environment::get().getWorld()->positionToIndex (pos.x(), pos.y(), x, y);
-                        preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
+                        if (prefetchExterior(x, y))
+                            preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
                         exteriorPositions.push_back(pos);
                     }
                 }
@@ -795,7 +835,7 @@ namespace MWWorld
                 dist = std::min(dist,std::max(std::abs(thisCellCenterX - predictedPos.x()), std::abs(thisCellCenterY - predictedPos.y())));
                 float loadDist = 8192/2 + 8192 - mCellLoadingThreshold + mPreloadDistance;
 
-                if (dist < loadDist)
+                if (dist < loadDist && prefetchExterior(cellX+dx, cellY+dy))
                     preloadCell(MWBase::Environment::get().getWorld()->getExterior(cellX+dx, cellY+dy));
             }
         }
@@ -812,7 +852,8 @@ namespace MWWorld
             {
                 for (int dy = -mHalfGridSize; dy <= mHalfGridSize; ++dy)
                 {
-                    mPreloader->preload(MWBase::Environment::get().getWorld()->getExterior(x+dx, y+dy), mRendering.getReferenceTime());
+                    if (prefetchExterior(x+dx, y+dy))
+                        mPreloader->preload(MWBase::Environment::get().getWorld()->getExterior(x+dx, y+dy), mRendering.getReferenceTime());
                     if (++numpreloaded >= mPreloader->getMaxCacheSize())
                         break;
                 }
@@ -822,6 +863,24 @@ namespace MWWorld
             mPreloader->preload(cell, mRendering.getReferenceTime());
     }
 
+    bool Scene::prefetchExterior(int x, int y)
+    {
+        const ESM::Cell* cell = MWBase::Environment::get().getWorld()->getStore().get<ESM::Cell>().search(x, y);
+        if (!cell)
+            return true; // generated on the fly, nothing to read
+
+        return mRefIndex.prefetch(*cell, mRendering.getWorkQueue());
+    }
+
+    bool Scene::prefetchInterior(const std::string& name)
+    {
+        const ESM::Cell* cell = MWBase::Environment::get().getWorld()->getStore().get<ESM::Cell>().search(name);
+        if (!cell)
+            return true; // let getInterior() report the missing cell
+
+        return mRefIndex.prefetch(*cell, mRendering.getWorkQueue());
+    }
+
     void Scene::preloadTerrain(const osg::Vec3f &pos)
     {
         std::vector<osg::Vec3f> vec;
@@ -874,13 +933,17 @@ namespace MWWorld
         for (std::vector<ESM::Transport::Dest>::const_iterator it = listVisitor.mList.begin(); it != listVisitor.mList.end(); ++it)
         {
             if (!it->mCellName.empty())
-                preloadCell(MWBase::Environment::get().getWorld()->getInterior(it->mCellName));
+            {
+                if (prefetchInterior(it->mCellName))
+                    preloadCell(MWBase::Environment::get().getWorld()->getInterior(it->mCellName));
+            }
             else
             {
                 osg::Vec3f pos = it->mPos.asVec3();
                 int x,y;
                 MWBase::Environment::get().getWorld()->positionToIndex( pos.x(), pos.y(), x, y);
-                preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
+                if (prefetchExterior(x, y))
+                    preloadCell(MWBase::Environment::get().getWorld()->getExterior(x,y), true);
                 exteriorPositions.push_back(pos);
             }
         }
@@ -43,6 +43,7 @@ namespace MWWorld
     class Player;
     class CellStore;
     class CellPreloader;
+    class CellRefIndex;
 
     class Scene
     {
@@ -58,6 +59,7 @@ namespace MWWorld
             MWPhysics::PhysicsSystem *mPhysics;
             MWRender::RenderingManager& mRendering;
             std::unique_ptr<CellPreloader> mPreloader;
+            CellRefIndex& mRefIndex;
             float mPreloadTimer;
             int mHalfGridSize;
             float mCellLoadingThreshold;
@@ -83,9 +85,14 @@ namespace MWWorld
             void preloadExteriorGrid(const osg::Vec3f& playerPos, const osg::Vec3f& predictedPos);
             void preloadFastTravelDestinations(const osg::Vec3f& playerPos, const osg::Vec3f& predictedPos, std::vector<osg::Vec3f>& exteriorPositions);
 
+            /// Start reading the references of the cell in the background.
+            /// @return Are the references available, i.e. can the cell be preloaded without reading content files?
+            bool prefetchExterior(int x, int y);
+            bool prefetchInterior(const std::string& name);
+
         public:
 
-            Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics);
+            Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics, CellRefIndex& refIndex);
 
             ~Scene();
 
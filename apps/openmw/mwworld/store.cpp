@@ -45,6 +45,23 @@ namespace
             return x->mX < y.first;
         }
     };
+
+    /// Flags to write in the record header, for records that read them with ESM::ESMReader::getRecordFlags()
+    template<typename T>
+    uint32_t getRecordFlags(const T& record)
+    {
+        return 0;
+    }
+
+    uint32_t getRecordFlags(const ESM::NPC& record)
+    {
+        return record.mPersistent ? 0x0400 : 0;
+    }
+
+    uint32_t getRecordFlags(const ESM::Creature& record)
+    {
+        return record.mPersistent ? 0x0400 : 0;
+    }
 }
 
 namespace MWWorld
@@ -122,6 +139,8 @@ namespace MWWorld
     Store<T>::Store(const Store<T>& orig)
         : mStatic(orig.mStatic)
     {
+        for (typename Static::iterator it = mStatic.begin(); it != mStatic.end(); ++it)
+            mStaticIndex.insert(&it->first, &it->second);
     }
 
     template<typename T>
@@ -131,25 +150,24 @@ namespace MWWorld
         assert(mShared.size() >= mStatic.size());
         mShared.erase(mShared.begin() + mStatic.size(), mShared.end());
         mDynamic.clear();
+        mDynamicIndex.clear();
     }
 
     template<typename T>
     const T *Store<T>::search(const std::string &id) const
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename Dynamic::const_iterator dit = mDynamic.find(idLower);
-        if (dit != mDynamic.end()) {
-            return &dit->second;
-        }
-
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(idLower);
+        return search(id.c_str(), id.size());
+    }
+    template<typename T>
+    const T *Store<T>::search(const char *id, size_t length) const
+    {
+        size_t hash = RecordIndex<T>::hash(id, length);
 
-        if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
-            return &(it->second);
-        }
+        const T *ptr = mDynamicIndex.find(id, length, hash);
+        if (ptr == 0)
+            ptr = mStaticIndex.find(id, length, hash);
 
-        return 0;
+        return ptr;
     }
     template<typename T>
     bool Store<T>::isDynamic(const std::string &id) const
@@ -198,15 +216,57 @@ namespace MWWorld
         record.load(esm, isDeleted);
         Misc::StringUtils::lowerCaseInPlace(record.mId);
 
+        return insertLoaded(record, isDeleted);
+    }
+    template<typename T>
+    RecordId Store<T>::insertLoaded(const T &record, bool isDeleted)
+    {
         std::pair<typename Static::iterator, bool> inserted = mStatic.insert(std::make_pair(record.mId, record));
         if (inserted.second)
+        {
             mShared.push_back(&inserted.first->second);
+            mStaticIndex.insert(&inserted.first->first, &inserted.first->second);
+        }
         else
             inserted.first->second = record;
 
         return RecordId(record.mId, isDeleted);
     }
     template<typename T>
+    bool Store<T>::canStage() const
+    {
+        return true;
+    }
+    template<typename T>
+    StagedRecord *Store<T>::stage(ESM::ESMReader &esm) const
+    {
+        Staged* staged = new Staged;
+        staged->mIsDeleted = false;
+
+        staged->mRecord.load(esm, staged->mIsDeleted);
+        Misc::StringUtils::lowerCaseInPlace(staged->mRecord.mId);
+
+        return staged;
+    }
+    template<typename T>
+    RecordId Store<T>::merge(const StagedRecord &record)
+    {
+        const Staged& staged = static_cast<const Staged&>(record);
+        return insertLoaded(staged.mRecord, staged.mIsDeleted);
+    }
+    template<typename T>
+    void Store<T>::writeStatic(ESM::ESMWriter &writer) const
+    {
+        // The static records come first in mShared, in load order
+        for (size_t i = 0; i < mStatic.size(); ++i)
+        {
+            const T& record = *mShared[i];
+            writer.startRecord(T::sRecordId, getRecordFlags(record));
+            record.save(writer);
+            writer.endRecord(T::sRecordId);
+        }
+    }
+    template<typename T>
     void Store<T>::setUp()
     {
     }
@@ -251,6 +311,7 @@ namespace MWWorld
         T *ptr = &result.first->second;
         if (result.second) {
             mShared.push_back(ptr);
+            mDynamicIndex.insert(&result.first->first, ptr);
         } else {
             *ptr = item;
         }
@@ -265,6 +326,7 @@ namespace MWWorld
         T *ptr = &result.first->second;
         if (result.second) {
             mShared.push_back(ptr);
+            mStaticIndex.insert(&result.first->first, ptr);
         } else {
             *ptr = item;
         }
@@ -289,6 +351,7 @@ namespace MWWorld
                 }
                 ++sharedIter;
             }
+            mStaticIndex.erase(it->first);
             mStatic.erase(it);
         }
 
@@ -303,6 +366,7 @@ namespace MWWorld
         if (it == mDynamic.end()) {
             return false;
         }
+        mDynamicIndex.erase(it->first);
         mDynamic.erase(it);
 
         // have to reinit the whole shared part
@@ -1074,11 +1138,19 @@ namespace MWWorld
                 if (ret.first != mStatic.end())
                 {
                     mShared.push_back(&ret.first->second);
+                    mStaticIndex.insert(&ret.first->first, &ret.first->second);
                 }
             }
         }
     }
 
+    template <>
+    bool Store<ESM::Dialogue>::canStage() const
+    {
+        // Dialogues may be merged with a previously loaded record, and INFO records depend on the preceding DIAL record
+        return false;
+    }
+
     template <>
     inline RecordId Store<ESM::Dialogue>::load(ESM::ESMReader &esm) {
         // The original letter case of a dialogue ID is saved, because it's printed
@@ -1092,7 +1164,8 @@ namespace MWWorld
         if (found == mStatic.end())
         {
             dialogue.loadData(esm, isDeleted);
-            mStatic.insert(std::make_pair(idLower, dialogue));
+            Static::iterator inserted = mStatic.insert(std::make_pair(idLower, dialogue)).first;
+            mStaticIndex.insert(&inserted->first, &inserted->second);
         }
         else
         {
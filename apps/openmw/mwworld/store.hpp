@@ -6,6 +6,7 @@
 #include <map>
 
 #include "recordcmp.hpp"
+#include "recordindex.hpp"
 
 namespace ESM
 {
@@ -27,6 +28,13 @@ namespace MWWorld
         RecordId(const std::string &id = "", bool isDeleted = false);
     };
 
+    /// A record read ahead of time (e.g. by a worker thread), waiting to be merged into its store.
+    /// @see ESMStore::stage
+    struct StagedRecord
+    {
+        virtual ~StagedRecord() {}
+    };
+
     class StoreBase
     {
     public:
@@ -41,6 +49,20 @@ namespace MWWorld
         virtual int getDynamicSize() const { return 0; }
         virtual RecordId load(ESM::ESMReader &esm) = 0;
 
+        /// Can records of this store be read by stage() independently of the records loaded before them?
+        virtual bool canStage() const { return false; }
+
+        /// Read a record without accessing the store, so that it can be done ahead of time on another thread.
+        /// Only valid if canStage() returns true.
+        virtual StagedRecord* stage(ESM::ESMReader &esm) const { return NULL; }
+
+        /// Merge a record read by stage() into the store, with the same effect load() would have had.
+        virtual RecordId merge(const StagedRecord& record) { return RecordId(); }
+
+        /// Write the records loaded from content files in their current order, so that loading them again
+        /// restores the same state. Only supported if canStage() returns true.
+        virtual void writeStatic(ESM::ESMWriter& writer) const {}
+
         virtual bool eraseStatic(const std::string &id) {return false;}
         virtual void clearDynamic() {}
 
@@ -147,8 +169,20 @@ namespace MWWorld
         typedef std::map<std::string, T> Dynamic;
         typedef std::map<std::string, T> Static;
 
+        // The maps own the records and keep them at stable addresses, lookups by id go through these
+        RecordIndex<T> mStaticIndex;
+        RecordIndex<T> mDynamicIndex;
+
         friend class ESMStore;
 
+        struct Staged : public StagedRecord
+        {
+            T mRecord;
+            bool mIsDeleted;
+        };
+
+        RecordId insertLoaded(const T& record, bool isDeleted);
+
     public:
         Store();
         Store(const Store<T> &orig);
@@ -161,6 +195,9 @@ namespace MWWorld
 
         const T *search(const std::string &id) const;
 
+        /// @note Does not allocate, \a id does not need to be null-terminated.
+        const T *search(const char* id, size_t length) const;
+
         /**
          * Does the record with this ID come from the dynamic store?
          */
@@ -194,6 +231,11 @@ namespace MWWorld
         RecordId load(ESM::ESMReader &esm);
         void write(ESM::ESMWriter& writer, Loading::Listener& progress) const;
         RecordId read(ESM::ESMReader& reader);
+
+        bool canStage() const;
+        StagedRecord* stage(ESM::ESMReader &esm) const;
+        RecordId merge(const StagedRecord& record);
+        void writeStatic(ESM::ESMWriter& writer) const;
     };
 
     template <>
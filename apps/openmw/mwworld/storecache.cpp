@@ -0,0 +1,142 @@
+#include "storecache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <memory>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <osg/Timer>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/files/mappedfile.hpp>
+#include <components/loadinglistener/loadinglistener.hpp>
+
+#include "esmstore.hpp"
+
+namespace
+{
+    /// Increment when the layout of any cached record changes.
+    const int sCacheVersion = 1;
+
+    const char* sKeyRecord = "CKEY";
+
+    std::string readKey(ESM::ESMReader& reader)
+    {
+        if (!reader.hasMoreRecs() || reader.getRecName() != sKeyRecord)
+            return std::string();
+        reader.getRecHeader();
+        return reader.getHNString("DATA");
+    }
+}
+
+namespace MWWorld
+{
+
+    StoreCache::StoreCache(const boost::filesystem::path& cacheFile, const std::vector<boost::filesystem::path>& contentFiles,
+                           const std::string& engineVersion)
+        : mCacheFile(cacheFile)
+    {
+        std::ostringstream key;
+        key << sCacheVersion << "\n" << engineVersion << "\n";
+        for (std::vector<boost::filesystem::path>::const_iterator it = contentFiles.begin(); it != contentFiles.end(); ++it)
+        {
+            key << it->string() << "|" << boost::filesystem::file_size(*it)
+                << "|" << boost::filesystem::last_write_time(*it) << "\n";
+        }
+        mKey = key.str();
+    }
+
+    bool StoreCache::isValid() const
+    {
+        if (!boost::filesystem::exists(mCacheFile))
+            return false;
+
+        try
+        {
+            ESM::ESMReader reader;
+            reader.open(mCacheFile.string());
+            return readKey(reader) == mKey;
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Warning: can not read " << mCacheFile.string() << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void StoreCache::read(ESMStore& store, Loading::Listener& listener) const
+    {
+        osg::Timer timer;
+        try
+        {
+            std::shared_ptr<const Files::MappedFile> file(new Files::MappedFile(mCacheFile.string()));
+
+            // Strings are cached as UTF-8, so the reader needs no encoder
+            ESM::ESMReader reader;
+            reader.open(Files::IStreamPtr(new Files::MappedFileStream(file, 0, file->getSize())), mCacheFile.string());
+            if (readKey(reader) != mKey)
+                reader.fail("The cache is out of date");
+
+            store.readCache(reader, &listener);
+        }
+        catch (std::exception& e)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(mCacheFile, ec);
+
+            std::stringstream error;
+            error << "Failed to read " << mCacheFile.string() << " (" << e.what() << "). The cache has been removed "
+                  << "and will be rebuilt on the next start.";
+            throw std::runtime_error(error.str());
+        }
+
+        listener.reportTime("Restored cached records from " + mCacheFile.string(), timer.time_m());
+    }
+
+    void StoreCache::write(const ESMStore& store) const
+    {
+        // Write to a temporary file first, so that a crash can not leave a truncated cache behind
+        boost::filesystem::path tempFile = mCacheFile;
+        tempFile += ".tmp";
+
+        try
+        {
+            boost::filesystem::create_directories(mCacheFile.parent_path());
+
+            boost::filesystem::ofstream stream(tempFile, std::ios::binary);
+            if (!stream.is_open())
+                throw std::runtime_error("can not open file for writing");
+
+            ESM::ESMWriter writer;
+            writer.setFormat(0);
+            writer.setAuthor("");
+            writer.setDescription("OpenMW content file cache");
+            writer.save(stream);
+
+            writer.startRecord(sKeyRecord);
+            writer.writeHNString("DATA", mKey);
+            writer.endRecord(sKeyRecord);
+
+            store.writeCache(writer);
+
+            writer.close();
+
+            stream.close();
+            if (stream.fail())
+                throw std::runtime_error("write error");
+
+            boost::filesystem::rename(tempFile, mCacheFile);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Warning: failed to write " << mCacheFile.string() << ": " << e.what() << std::endl;
+
+            boost::system::error_code ec;
+            boost::filesystem::remove(tempFile, ec);
+        }
+    }
+
+}
@@ -0,0 +1,47 @@
+#ifndef OPENMW_MWWORLD_STORECACHE_H
+#define OPENMW_MWWORLD_STORECACHE_H
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+namespace Loading
+{
+    class Listener;
+}
+
+namespace MWWorld
+{
+    class ESMStore;
+
+    /// @brief Snapshot of the records loaded from the content files, to skip parsing most of them on the next start.
+    /// @par The snapshot is only used when it was written by the same engine version, for content files with the same
+    /// paths, sizes and modification times, otherwise it is rebuilt.
+    /// @see ESMStore::writeCache, ESMStore::readCache
+    class StoreCache
+    {
+    public:
+        StoreCache(const boost::filesystem::path& cacheFile, const std::vector<boost::filesystem::path>& contentFiles,
+                   const std::string& engineVersion);
+
+        /// Does the cache file exist, and was it written for the current content files?
+        bool isValid() const;
+
+        /// Restore the cached records, after the content files were loaded with ESMStore::loadUncached().
+        /// @note Throws an exception if the cache can not be read. The cache file is removed in that case,
+        /// so that it is rebuilt on the next start.
+        void read(ESMStore& store, Loading::Listener& listener) const;
+
+        /// Write the cache for the records loaded from the content files. Errors are logged, but not fatal.
+        void write(const ESMStore& store) const;
+
+    private:
+        boost::filesystem::path mCacheFile;
+
+        /// Identifies the cache format, the engine version and the content files it was written for.
+        std::string mKey;
+    };
+}
+
+#endif
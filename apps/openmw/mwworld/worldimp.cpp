@@ -10,8 +10,12 @@
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/rng.hpp>
 
+#include <components/settings/settings.hpp>
+
 #include <components/files/collections.hpp>
 
+#include <components/version/version.hpp>
+
 #include <components/resource/resourcesystem.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
@@ -56,6 +60,7 @@
 
 #include "contentloader.hpp"
 #include "esmloader.hpp"
+#include "storecache.hpp"
 
 namespace
 {
@@ -101,6 +106,12 @@ namespace MWWorld
             }
         }
 
+        void finish()
+        {
+            for (LoadersContainer::iterator it = mLoaders.begin(); it != mLoaders.end(); ++it)
+                it->second->finish();
+        }
+
         private:
           typedef std::map<std::string, ContentLoader*> LoadersContainer;
           LoadersContainer mLoaders;
@@ -147,9 +158,10 @@ namespace MWWorld
         const std::vector<std::string>& contentFiles,
         ToUTF8::Utf8Encoder* encoder, const std::map<std::string,std::string>& fallbackMap,
         int activationDistanceOverride, const std::string& startCell, const std::string& startupScript,
-            const std::string& resourcePath, const std::string& userDataPath)
+            const std::string& resourcePath, const std::string& userDataPath,
+            const std::string& contentCacheFile, bool rebuildContentCache)
     : mResourceSystem(resourceSystem), mFallback(fallbackMap), mLocalScripts (mStore),
-      mSky (true), mCells (mStore, mEsm),
+      mSky (true), mCells (mStore, mEsm, encoder),
       mGodMode(false), mScriptsEnabled(true), mContentFiles (contentFiles), mUserDataPath(userDataPath),
       mActivationDistanceOverride (activationDistanceOverride), mStartupScript(startupScript),
       mStartCell (startCell), mDistanceToFacedObject(-1), mTeleportEnabled(true),
@@ -165,8 +177,17 @@ namespace MWWorld
         Loading::Listener* listener = MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         listener->loadingOn();
 
+        std::vector<boost::filesystem::path> contentPaths = findContentFiles(fileCollections, contentFiles);
+
+        std::unique_ptr<StoreCache> storeCache;
+        if (!contentCacheFile.empty())
+            storeCache.reset(new StoreCache(contentCacheFile, contentPaths, Version::getOpenmwVersionDescription(resourcePath)));
+        bool useStoreCache = storeCache && !rebuildContentCache && storeCache->isValid();
+
         GameContentLoader gameContentLoader(*listener);
-        EsmLoader esmLoader(mStore, mEsm, encoder, *listener);
+        EsmLoader esmLoader(mStore, mEsm, encoder, *listener,
+                            !useStoreCache && Settings::Manager::getBool("parallel content loading", "General"));
+        esmLoader.setSkipCachedRecords(useStoreCache);
 
         gameContentLoader.addLoader(".esm", &esmLoader);
         gameContentLoader.addLoader(".esp", &esmLoader);
@@ -174,7 +195,12 @@ namespace MWWorld
         gameContentLoader.addLoader(".omwaddon", &esmLoader);
         gameContentLoader.addLoader(".project", &esmLoader);
 
-        loadContentFiles(fileCollections, contentFiles, gameContentLoader);
+        loadContentFiles(contentPaths, gameContentLoader);
+
+        if (useStoreCache)
+            storeCache->read(mStore, *listener);
+        else if (storeCache)
+            storeCache->write(mStore);
 
         listener->loadingOff();
 
@@ -191,7 +217,7 @@ namespace MWWorld
 
         mWeatherManager.reset(new MWWorld::WeatherManager(*mRendering, mFallback, mStore));
 
-        mWorldScene.reset(new Scene(*mRendering.get(), mPhysics.get()));
+        mWorldScene.reset(new Scene(*mRendering.get(), mPhysics.get(), mCells.getRefIndex()));
     }
 
     void World::fillGlobalVariables()
@@ -490,6 +516,7 @@ namespace MWWorld
     {
         // Must be cleared before mRendering is destroyed
         mProjectileManager->clear();
+        mCells.getRefIndex().clear();
     }
 
     const ESM::Cell *World::getExterior (const std::string& cellName) const
@@ -612,6 +639,49 @@ namespace MWWorld
         return mGlobalVariables.getType (name);
     }
 
+    int World::getGlobalSlot (const std::string& name) const
+    {
+        return mGlobalVariables.getSlot (name);
+    }
+
+    void World::setGlobalInt (int slot, int value)
+    {
+        ESM::Variant& variable = mGlobalVariables.getValue (slot);
+
+        if (&variable==mGameHour)
+            setHour (value);
+        else if (&variable==mDay)
+            setDay (value);
+        else if (&variable==mMonth)
+            setMonth (value);
+        else
+            variable.setInteger (value);
+    }
+
+    void World::setGlobalFloat (int slot, float value)
+    {
+        ESM::Variant& variable = mGlobalVariables.getValue (slot);
+
+        if (&variable==mGameHour)
+            setHour (value);
+        else if (&variable==mDay)
+            setDay (static_cast<int>(value));
+        else if (&variable==mMonth)
+            setMonth (static_cast<int>(value));
+        else
+            variable.setFloat (value);
+    }
+
+    int World::getGlobalInt (int slot) const
+    {
+        return mGlobalVariables.getValue (slot).getInteger();
+    }
+
+    float World::getGlobalFloat (int slot) const
+    {
+        return mGlobalVariables.getValue (slot).getFloat();
+    }
+
     std::string World::getCellName (const MWWorld::CellStore *cell) const
     {
         if (!cell)
@@ -642,16 +712,9 @@ namespace MWWorld
 
         std::string lowerCaseName = Misc::StringUtils::lowerCase(name);
 
-        for (Scene::CellStoreCollection::const_iterator iter (mWorldScene->getActiveCells().begin());
-            iter!=mWorldScene->getActiveCells().end(); ++iter)
-        {
-            // TODO: caching still doesn't work efficiently here (only works for the one CellStore that the reference is in)
-            CellStore* cellstore = *iter;
-            Ptr ptr = mCells.getPtr (lowerCaseName, *cellstore, false);
-
-            if (!ptr.isEmpty())
-                return ptr;
-        }
+        ret = mCells.getPtr (lowerCaseName, mWorldScene->getActiveCells());
+        if (!ret.isEmpty())
+            return ret;
 
         if (!activeOnly)
         {
@@ -1232,6 +1295,7 @@ namespace MWWorld
             mRendering->moveObject(newPtr, vec);
             if (movePhysics)
                 mPhysics->updatePosition(newPtr);
+            MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr);
         }
         if (isPlayer)
         {
@@ -1451,7 +1515,11 @@ namespace MWWorld
 
         mProjectileManager->update(duration);
 
-        const MWPhysics::PtrVelocityList &results = mPhysics->applyQueuedMovement(duration);
+        moveActors(mPhysics->applyQueuedMovement(duration));
+    }
+
+    void World::moveActors(const MWPhysics::PtrVelocityList& results)
+    {
         MWPhysics::PtrVelocityList::const_iterator player(results.end());
         for(MWPhysics::PtrVelocityList::const_iterator iter(results.begin());iter != results.end();++iter)
         {
@@ -1655,6 +1723,16 @@ namespace MWWorld
         }
     }
 
+    void World::startPhysics()
+    {
+        mPhysics->startQueuedMovement();
+    }
+
+    void World::finishPhysics()
+    {
+        moveActors(mPhysics->finishQueuedMovement());
+    }
+
     void World::updatePlayer()
     {
         MWWorld::Ptr player = getPlayerPtr();
@@ -2701,18 +2779,17 @@ namespace MWWorld
         return mScriptsEnabled;
     }
 
-    void World::loadContentFiles(const Files::Collections& fileCollections,
-        const std::vector<std::string>& content, ContentLoader& contentLoader)
+    std::vector<boost::filesystem::path> World::findContentFiles(const Files::Collections& fileCollections,
+        const std::vector<std::string>& content)
     {
-        std::vector<std::string>::const_iterator it(content.begin());
-        std::vector<std::string>::const_iterator end(content.end());
-        for (int idx = 0; it != end; ++it, ++idx)
+        std::vector<boost::filesystem::path> paths;
+        for (std::vector<std::string>::const_iterator it = content.begin(); it != content.end(); ++it)
         {
             boost::filesystem::path filename(*it);
             const Files::MultiDirCollection& col = fileCollections.getCollection(filename.extension().string());
             if (col.doesExist(*it))
             {
-                contentLoader.load(col.getPath(*it), idx);
+                paths.push_back(col.getPath(*it));
             }
             else
             {
@@ -2721,6 +2798,18 @@ namespace MWWorld
                 throw std::runtime_error(msg.str());
             }
         }
+        return paths;
+    }
+
+    void World::loadContentFiles(const std::vector<boost::filesystem::path>& content, ContentLoader& contentLoader)
+    {
+        for (size_t idx = 0; idx < content.size(); ++idx)
+        {
+            int index = static_cast<int>(idx);
+            contentLoader.load(content[idx], index);
+        }
+
+        contentLoader.finish();
     }
 
     bool World::startSpellCast(const Ptr &actor)
@@ -147,18 +147,19 @@ namespace MWWorld
             void doPhysics(float duration);
             ///< Run physics simulation and modify \a world accordingly.
 
+            void moveActors(const std::vector<std::pair<Ptr, osg::Vec3f> >& results);
+            ///< Move the actors to the positions found by the physics simulation.
+
             void ensureNeededRecords();
 
             void fillGlobalVariables();
 
             /**
              * @brief loadContentFiles - Loads content files (esm,esp,omwgame,omwaddon)
-             * @param fileCollections- Container which holds content file names and their paths
-             * @param content - Container which holds content file names
+             * @param content - Paths of the content files, in load order
              * @param contentLoader -
              */
-            void loadContentFiles(const Files::Collections& fileCollections,
-                const std::vector<std::string>& content, ContentLoader& contentLoader);
+            void loadContentFiles(const std::vector<boost::filesystem::path>& content, ContentLoader& contentLoader);
 
             float mSwimHeightScale;
 
@@ -186,10 +187,21 @@ namespace MWWorld
                 const Files::Collections& fileCollections,
                 const std::vector<std::string>& contentFiles,
                 ToUTF8::Utf8Encoder* encoder, const std::map<std::string,std::string>& fallbackMap,
-                int activationDistanceOverride, const std::string& startCell, const std::string& startupScript, const std::string& resourcePath, const std::string& userDataPath);
+                int activationDistanceOverride, const std::string& startCell, const std::string& startupScript, const std::string& resourcePath, const std::string& userDataPath,
+                const std::string& contentCacheFile = "", bool rebuildContentCache = false);
+            ///< \param contentCacheFile File to cache the records of the content files in, or empty to disable the cache.
+            /// \param rebuildContentCache Ignore the existing cache file and write a new one.
 
             virtual ~World();
 
+            /**
+             * @brief findContentFiles - Looks up the paths of content files (esm,esp,omwgame,omwaddon)
+             * @param fileCollections- Container which holds content file names and their paths
+             * @param content - Container which holds content file names
+             */
+            static std::vector<boost::filesystem::path> findContentFiles(const Files::Collections& fileCollections,
+                const std::vector<std::string>& content);
+
             void startNewGame (bool bypass) override;
             ///< \param bypass Bypass regular game start.
 
@@ -261,6 +273,22 @@ namespace MWWorld
             char getGlobalVariableType (const std::string& name) const override;
             ///< Return ' ', if there is no global variable with this name.
 
+            int getGlobalSlot (const std::string& name) const override;
+            ///< Return a number that refers to the global variable \a name for the rest of the session,
+            /// or -1, if there is no global variable with this name.
+
+            void setGlobalInt (int slot, int value) override;
+            ///< Set value independently from real type.
+
+            void setGlobalFloat (int slot, float value) override;
+            ///< Set value independently from real type.
+
+            int getGlobalInt (int slot) const override;
+            ///< Get value independently from real type.
+
+            float getGlobalFloat (int slot) const override;
+            ///< Get value independently from real type.
+
             std::string getCellName (const MWWorld::CellStore *cell = 0) const override;
             ///< Return name of the cell.
             ///
@@ -462,6 +490,9 @@ namespace MWWorld
 
             void update (float duration, bool paused) override;
 
+            void startPhysics() override;
+            void finishPhysics() override;
+
             void updateWindowManager () override;
 
             MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount) override;
@@ -0,0 +1,393 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/extensions.hpp>
+#include <components/compiler/extensions0.hpp>
+#include <components/compiler/fileparser.hpp>
+#include <components/compiler/opcodes.hpp>
+#include <components/compiler/scanner.hpp>
+#include <components/compiler/streamerrorhandler.hpp>
+
+#include <components/interpreter/context.hpp>
+#include <components/interpreter/installopcodes.hpp>
+#include <components/interpreter/interpreter.hpp>
+#include <components/interpreter/opcodes.hpp>
+#include <components/interpreter/runtime.hpp>
+
+#include <components/misc/stringops.hpp>
+
+#include "apps/openmw/mwscript/scriptcache.hpp"
+
+namespace
+{
+    /// Scripts in the style of the local and global scripts of the original game: mostly polling of
+    /// timers, locals, globals and engine functions, exiting early most of the time.
+    const char* const sCorpus[] =
+    {
+        "begin bench_activator\n"
+        "short done\n"
+        "float timer\n"
+        "if ( MenuMode == 1 )\n"
+        "    return\n"
+        "endif\n"
+        "set timer to timer + GetSecondsPassed\n"
+        "if ( timer < 0.5 )\n"
+        "    return\n"
+        "endif\n"
+        "set timer to 0\n"
+        "if ( OnActivate == 1 )\n"
+        "    if ( GetJournalIndex \"bench_quest\" >= 10 )\n"
+        "        set done to 1\n"
+        "    endif\n"
+        "endif\n"
+        "end\n",
+
+        "begin bench_follower\n"
+        "float x\n"
+        "float y\n"
+        "float dist\n"
+        "short state\n"
+        "long counter\n"
+        "set x to GetPos x\n"
+        "set y to GetPos y\n"
+        "set dist to GetDistance player\n"
+        "if ( dist > 512 )\n"
+        "    set state to 1\n"
+        "elseif ( dist > 128 )\n"
+        "    set state to 2\n"
+        "else\n"
+        "    set state to 0\n"
+        "endif\n"
+        "set counter to counter + 1\n"
+        "if ( counter > 1000 )\n"
+        "    set counter to 0\n"
+        "endif\n"
+        "if ( state == 1 )\n"
+        "    SetPos z 100\n"
+        "endif\n"
+        "end\n",
+
+        "begin bench_global\n"
+        "short i\n"
+        "long sum\n"
+        "set sum to 0\n"
+        "set i to 0\n"
+        "while ( i < 20 )\n"
+        "    set sum to sum + i * 2\n"
+        "    set i to i + 1\n"
+        "endwhile\n"
+        "set BenchGlobal to sum\n"
+        "if ( player->GetItemCount \"gold_001\" > 100 )\n"
+        "    set BenchGlobal to BenchGlobal + 1\n"
+        "endif\n"
+        "end\n"
+    };
+
+    class CompilerContext : public Compiler::Context
+    {
+        public:
+
+            virtual bool canDeclareLocals() const { return true; }
+
+            virtual char getGlobalType (const std::string& name) const
+            {
+                return Misc::StringUtils::ciEqual (name, "benchglobal") ? 'l' : ' ';
+            }
+
+            virtual int getGlobalSlot (const std::string& name) const
+            {
+                return Misc::StringUtils::ciEqual (name, "benchglobal") ? 0 : -1;
+            }
+
+            virtual std::pair<char, bool> getMemberType (const std::string& name, const std::string& id) const
+            {
+                return std::make_pair (' ', false);
+            }
+
+            virtual bool isId (const std::string& name) const
+            {
+                return Misc::StringUtils::ciEqual (name, "player") || Misc::StringUtils::ciEqual (name, "gold_001");
+            }
+
+            virtual bool isJournalId (const std::string& name) const
+            {
+                return Misc::StringUtils::ciEqual (name, "bench_quest");
+            }
+    };
+
+    /// Locals of one script instance and the globals, everything else is a constant.
+    class InterpreterContext : public Interpreter::Context
+    {
+            std::vector<int> mShorts;
+            std::vector<int> mLongs;
+            std::vector<float> mFloats;
+            std::map<std::string, int>& mGlobals;
+
+        public:
+
+            InterpreterContext (const Compiler::Locals& locals, std::map<std::string, int>& globals)
+            : mShorts (locals.get ('s').size()), mLongs (locals.get ('l').size()),
+              mFloats (locals.get ('f').size()), mGlobals (globals)
+            {}
+
+            virtual int getLocalShort (int index) const { return mShorts.at (index); }
+            virtual int getLocalLong (int index) const { return mLongs.at (index); }
+            virtual float getLocalFloat (int index) const { return mFloats.at (index); }
+            virtual void setLocalShort (int index, int value) { mShorts.at (index) = value; }
+            virtual void setLocalLong (int index, int value) { mLongs.at (index) = value; }
+            virtual void setLocalFloat (int index, float value) { mFloats.at (index) = value; }
+
+            virtual void messageBox (const std::string& message, const std::vector<std::string>& buttons) {}
+            virtual void report (const std::string& message) {}
+            virtual bool menuMode() { return false; }
+
+            virtual int getGlobalShort (const std::string& name) const { return mGlobals[name]; }
+            virtual int getGlobalLong (const std::string& name) const { return mGlobals[name]; }
+            virtual float getGlobalFloat (const std::string& name) const { return static_cast<float> (mGlobals[name]); }
+            virtual void setGlobalShort (const std::string& name, int value) { mGlobals[name] = value; }
+            virtual void setGlobalLong (const std::string& name, int value) { mGlobals[name] = value; }
+            virtual void setGlobalFloat (const std::string& name, float value) { mGlobals[name] = static_cast<int> (value); }
+            virtual int getGlobalShort (int slot) const { return getGlobalShort (getGlobalName (slot)); }
+            virtual int getGlobalLong (int slot) const { return getGlobalLong (getGlobalName (slot)); }
+            virtual float getGlobalFloat (int slot) const { return getGlobalFloat (getGlobalName (slot)); }
+            virtual void setGlobalShort (int slot, int value) { setGlobalShort (getGlobalName (slot), value); }
+            virtual void setGlobalLong (int slot, int value) { setGlobalLong (getGlobalName (slot), value); }
+            virtual void setGlobalFloat (int slot, float value) { setGlobalFloat (getGlobalName (slot), value); }
+            virtual std::vector<std::string> getGlobals() const { return std::vector<std::string>(); }
+            virtual char getGlobalType (const std::string& name) const { return 'l'; }
+
+            virtual std::string getActionBinding (const std::string& action) const { return ""; }
+            virtual std::string getNPCName() const { return ""; }
+            virtual std::string getNPCRace() const { return ""; }
+            virtual std::string getNPCClass() const { return ""; }
+            virtual std::string getNPCFaction() const { return ""; }
+            virtual std::string getNPCRank() const { return ""; }
+            virtual std::string getPCName() const { return ""; }
+            virtual std::string getPCRace() const { return ""; }
+            virtual std::string getPCClass() const { return ""; }
+            virtual std::string getPCRank() const { return ""; }
+            virtual std::string getPCNextRank() const { return ""; }
+            virtual int getPCBounty() const { return 0; }
+            virtual std::string getCurrentCellName() const { return ""; }
+
+            virtual bool isScriptRunning (const std::string& name) const { return false; }
+            virtual void startScript (const std::string& name, const std::string& targetId) {}
+            virtual void stopScript (const std::string& name) {}
+
+            virtual float getDistance (const std::string& name, const std::string& id) const { return 300.f; }
+            virtual float getSecondsPassed() const { return 1/60.f; }
+            virtual bool isDisabled (const std::string& id) const { return false; }
+            virtual void enable (const std::string& id) {}
+            virtual void disable (const std::string& id) {}
+
+            virtual int getMemberShort (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual int getMemberLong (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual float getMemberFloat (const std::string& id, const std::string& name, bool global) const { return 0; }
+            virtual void setMemberShort (const std::string& id, const std::string& name, int value, bool global) {}
+            virtual void setMemberLong (const std::string& id, const std::string& name, int value, bool global) {}
+            virtual void setMemberFloat (const std::string& id, const std::string& name, float value, bool global) {}
+
+            virtual int getMemberShort (const std::string& id, int index, bool global) const { return 0; }
+            virtual int getMemberLong (const std::string& id, int index, bool global) const { return 0; }
+            virtual float getMemberFloat (const std::string& id, int index, bool global) const { return 0; }
+            virtual void setMemberShort (const std::string& id, int index, int value, bool global) {}
+            virtual void setMemberLong (const std::string& id, int index, int value, bool global) {}
+            virtual void setMemberFloat (const std::string& id, int index, float value, bool global) {}
+
+            virtual std::string getTargetId() const { return ""; }
+
+            static std::string getGlobalName (int slot)
+            {
+                if (slot!=0)
+                    throw std::runtime_error ("unknown global variable slot");
+                return "benchglobal";
+            }
+    };
+
+    /// Stands in for an engine function: consumes the arguments and returns 0.
+    class OpStub : public Interpreter::Opcode0
+    {
+            int mArguments;
+            bool mReturns;
+
+        public:
+
+            OpStub (int arguments, bool returns) : mArguments (arguments), mReturns (returns) {}
+
+            virtual void execute (Interpreter::Runtime& runtime)
+            {
+                for (int i = 0; i < mArguments; ++i)
+                    runtime.pop();
+
+                if (mReturns)
+                    runtime.push (static_cast<Interpreter::Type_Integer> (0));
+            }
+    };
+
+    struct CompiledScript
+    {
+        std::vector<Interpreter::Type_Code> mCode;
+        Compiler::Locals mLocals;
+    };
+
+    class InterpreterTest : public ::testing::Test
+    {
+        protected:
+
+            virtual void SetUp()
+            {
+                Compiler::registerExtensions (mExtensions);
+                mCompilerContext.setExtensions (&mExtensions);
+
+                Interpreter::installOpcodes (mInterpreter);
+                mInterpreter.installSegment5 (Compiler::Dialogue::opcodeGetJournalIndex, new OpStub (1, true));
+                mInterpreter.installSegment5 (Compiler::Misc::opcodeOnActivate, new OpStub (0, true));
+                mInterpreter.installSegment5 (Compiler::Transformation::opcodeGetPos, new OpStub (1, true));
+                mInterpreter.installSegment5 (Compiler::Transformation::opcodeSetPos, new OpStub (2, false));
+                mInterpreter.installSegment5 (Compiler::Container::opcodeGetItemCountExplicit, new OpStub (2, true));
+
+                for (size_t i = 0; i < sizeof (sCorpus) / sizeof (sCorpus[0]); ++i)
+                    mScripts.push_back (compile (sCorpus[i]));
+            }
+
+            CompiledScript compile (const std::string& source)
+            {
+                Compiler::StreamErrorHandler errorHandler (std::cerr);
+                Compiler::FileParser parser (errorHandler, mCompilerContext);
+                std::istringstream input (source);
+                Compiler::Scanner scanner (errorHandler, input, mCompilerContext.getExtensions());
+                scanner.scan (parser);
+                EXPECT_TRUE (errorHandler.isGood()) << source;
+
+                CompiledScript script;
+                parser.getCode (script.mCode);
+                script.mLocals = parser.getLocals();
+                return script;
+            }
+
+            Compiler::Extensions mExtensions;
+            CompilerContext mCompilerContext;
+            Interpreter::Interpreter mInterpreter;
+            std::vector<CompiledScript> mScripts;
+            std::map<std::string, int> mGlobals;
+    };
+}
+
+TEST_F(InterpreterTest, run_corpus)
+{
+    ASSERT_EQ (mScripts.size(), 3u);
+
+    InterpreterContext context (mScripts[2].mLocals, mGlobals);
+    int executed = mInterpreter.run (&mScripts[2].mCode[0], mScripts[2].mCode.size(), context);
+
+    EXPECT_GT (executed, 20 * 5);
+    EXPECT_EQ (mGlobals["benchglobal"], 2 * (19 * 20 / 2));
+}
+
+TEST_F(InterpreterTest, opcode_counts)
+{
+    InterpreterContext context (mScripts[2].mLocals, mGlobals);
+    int uncounted = mInterpreter.run (&mScripts[2].mCode[0], mScripts[2].mCode.size(), context);
+    EXPECT_TRUE (mInterpreter.getOpcodeCounts().empty());
+
+    mInterpreter.setCountOpcodes (true);
+    InterpreterContext followerContext (mScripts[1].mLocals, mGlobals);
+    mInterpreter.run (&mScripts[1].mCode[0], mScripts[1].mCode.size(), followerContext);
+    int executed = mInterpreter.run (&mScripts[2].mCode[0], mScripts[2].mCode.size(), context);
+    EXPECT_EQ (executed, uncounted);
+
+    unsigned long total = 0;
+    bool getPosFound = false;
+    const Interpreter::Interpreter::OpcodeCounts& counts = mInterpreter.getOpcodeCounts();
+    for (Interpreter::Interpreter::OpcodeCounts::const_iterator iter = counts.begin(); iter != counts.end(); ++iter)
+    {
+        total += iter->second;
+        if (iter->first.first == 5 && mExtensions.getKeyword (5, iter->first.second) == "getpos")
+            getPosFound = true;
+    }
+    EXPECT_GT (total, static_cast<unsigned long> (executed));
+    EXPECT_TRUE (getPosFound);
+
+    mInterpreter.clearOpcodeCounts();
+    EXPECT_TRUE (mInterpreter.getOpcodeCounts().empty());
+}
+
+TEST_F(InterpreterTest, cached_corpus)
+{
+    boost::filesystem::path cacheFile =
+        boost::filesystem::temp_directory_path() / boost::filesystem::unique_path ("openmw-test-%%%%%%%%.cache");
+    std::vector<boost::filesystem::path> contentFiles;
+
+    {
+        MWScript::ScriptCache cache (cacheFile, contentFiles, "test");
+        cache.read();
+        for (size_t i = 0; i < mScripts.size(); ++i)
+        {
+            std::ostringstream name;
+            name << "Script" << i;
+            cache.add (name.str(), sCorpus[i], mScripts[i].mCode, mScripts[i].mLocals);
+        }
+        cache.write();
+    }
+
+    MWScript::ScriptCache cache (cacheFile, contentFiles, "test");
+    cache.read();
+
+    CompiledScript script;
+    EXPECT_FALSE (cache.get ("script2", std::string (sCorpus[2]) + " ", script.mCode, script.mLocals));
+    ASSERT_TRUE (cache.get ("script2", sCorpus[2], script.mCode, script.mLocals));
+    EXPECT_EQ (script.mCode, mScripts[2].mCode);
+    const Compiler::Locals& locals = script.mLocals;
+    const Compiler::Locals& expectedLocals = mScripts[2].mLocals;
+    for (const char* type = "slf"; *type; ++type)
+        EXPECT_EQ (locals.get (*type), expectedLocals.get (*type));
+
+    InterpreterContext context (script.mLocals, mGlobals);
+    mInterpreter.run (&script.mCode[0], script.mCode.size(), context);
+    EXPECT_EQ (mGlobals["benchglobal"], 2 * (19 * 20 / 2));
+
+    // A cache written for other content files is ignored
+    MWScript::ScriptCache otherCache (cacheFile, contentFiles, "other");
+    otherCache.read();
+    EXPECT_FALSE (otherCache.get ("script2", sCorpus[2], script.mCode, script.mLocals));
+
+    boost::filesystem::remove (cacheFile);
+}
+
+/// Runs every script of the corpus on a number of script instances, like the local scripts of a busy
+/// area, and reports the interpreter throughput.
+TEST_F(InterpreterTest, dispatch_benchmark)
+{
+    const int numInstances = 100;
+    const int numFrames = 200;
+
+    std::vector<InterpreterContext> contexts;
+    for (int i = 0; i < numInstances; ++i)
+        for (size_t script = 0; script < mScripts.size(); ++script)
+            contexts.push_back (InterpreterContext (mScripts[script].mLocals, mGlobals));
+
+    long long executed = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        for (size_t i = 0; i < contexts.size(); ++i)
+        {
+            const CompiledScript& script = mScripts[i % mScripts.size()];
+            executed += mInterpreter.run (&script.mCode[0], script.mCode.size(), contexts[i]);
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    ASSERT_GT (executed, 0);
+
+    std::cout << executed << " instructions in " << duration.count() * 1000 << " ms, "
+              << executed / duration.count() / 1e6 << " million instructions per second" << std::endl;
+}
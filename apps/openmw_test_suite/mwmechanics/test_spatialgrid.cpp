@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "apps/openmw/mwmechanics/spatialgrid.hpp"
+
+namespace
+{
+    /// Deterministic pseudo random positions, so that failures are reproducible
+    struct PositionGenerator
+    {
+        PositionGenerator(float extent)
+            : mState(12345u)
+            , mExtent(extent)
+        {
+        }
+
+        float next()
+        {
+            mState = mState * 1664525u + 1013904223u;
+            return (mState >> 8) / static_cast<float>(1 << 24) * mExtent - mExtent / 2;
+        }
+
+        osg::Vec3f position()
+        {
+            float x = next();
+            float y = next();
+            float z = next() / 16;
+            return osg::Vec3f(x, y, z);
+        }
+
+        unsigned int mState;
+        float mExtent;
+    };
+
+    void getInRangeLinear(const std::vector<osg::Vec3f>& positions, const osg::Vec3f& position, float radius, std::vector<int>& out)
+    {
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            if ((positions[i] - position).length2() <= radius*radius)
+                out.push_back(static_cast<int>(i));
+        }
+    }
+}
+
+TEST(SpatialGridTest, range_test)
+{
+    // Three exterior cells across, like the active grid of exterior cells
+    PositionGenerator generator(3 * 8192.f);
+    MWMechanics::SpatialGrid<int> grid(4096.f);
+    std::vector<osg::Vec3f> positions;
+    for (int i = 0; i < 300; ++i)
+    {
+        positions.push_back(generator.position());
+        grid.update(i, positions.back());
+    }
+    ASSERT_EQ (grid.size(), 300u);
+
+    // Move some of the items, possibly into other grid cells
+    for (int i = 0; i < 300; i += 3)
+    {
+        positions[i] = positions[i] + osg::Vec3f(generator.next() / 10, generator.next() / 10, 0);
+        grid.update(i, positions[i]);
+    }
+
+    const float radii[] = { 0.f, 100.f, 500.f, 2048.f, 7168.f, 100000.f };
+    for (int query = 0; query < 50; ++query)
+    {
+        osg::Vec3f center = query % 2 ? positions[query] : generator.position();
+        for (size_t r = 0; r < sizeof(radii) / sizeof(radii[0]); ++r)
+        {
+            std::vector<int> expected;
+            getInRangeLinear(positions, center, radii[r], expected);
+            std::vector<int> found;
+            grid.getItemsInRange(center, radii[r], found);
+            std::sort(found.begin(), found.end());
+            ASSERT_EQ (found, expected) << "radius " << radii[r];
+            ASSERT_EQ (grid.isAnyItemInRange(center, radii[r]), !expected.empty());
+        }
+    }
+
+    grid.remove(1);
+    grid.remove(1);
+    std::vector<int> found;
+    grid.getItemsInRange(positions[1], 0.f, found);
+    ASSERT_TRUE (std::find(found.begin(), found.end(), 1) == found.end());
+    ASSERT_EQ (grid.size(), 299u);
+
+    grid.clear();
+    ASSERT_FALSE (grid.isAnyItemInRange(positions[0], 100000.f));
+}
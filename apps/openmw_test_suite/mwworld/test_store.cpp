@@ -1,10 +1,13 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include <boost/filesystem/fstream.hpp>
 
 #include <components/files/configurationmanager.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
+#include <components/esm/savedgame.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 
 #include "apps/openmw/mwworld/esmstore.hpp"
@@ -219,14 +222,17 @@ protected:
 
 /// Create an ESM file in-memory containing the specified record.
 /// @param deleted Write record with deleted flag?
+/// @param flags Flags to write in the record header
+/// @param compression zlib compression level of the record, writes a saved game format that supports compression
 template <typename T>
-Files::IStreamPtr getEsmFile(T record, bool deleted)
+Files::IStreamPtr getEsmFile(T record, bool deleted, uint32_t flags = 0, int compression = 0)
 {
     ESM::ESMWriter writer;
     std::stringstream* stream = new std::stringstream;
-    writer.setFormat(0);
+    writer.setFormat(compression > 0 ? ESM::SavedGame::sCurrentFormat : 0);
+    writer.setCompression(compression);
     writer.save(*stream);
-    writer.startRecord(T::sRecordId);
+    writer.startRecord(T::sRecordId, flags);
     record.save(writer, deleted);
     writer.endRecord(T::sRecordId);
 
@@ -275,6 +281,97 @@ TEST_F(StoreTest, delete_test)
     ASSERT_TRUE (mEsmStore.get<RecordType>().getSize() == 1);
 }
 
+/// Tests reading of compressed records.
+TEST_F(StoreTest, compressed_record_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = "foobar";
+    record.mName = std::string(200, 'a');
+
+    ESM::ESMReader reader;
+    Files::IStreamPtr file = getEsmFile(record, false, 0, 1);
+    reader.open(file, "filename");
+
+    ASSERT_TRUE (reader.hasMoreRecs());
+    reader.getRecName();
+    reader.getRecHeader();
+    ASSERT_TRUE (reader.isRecordCompressed());
+    ASSERT_EQ (0u, reader.getRecordFlags());
+
+    RecordType loaded;
+    bool isDeleted = false;
+    loaded.load(reader, isDeleted);
+
+    ASSERT_FALSE (isDeleted);
+    ASSERT_FALSE (reader.hasMoreSubs());
+    ASSERT_FALSE (reader.hasMoreRecs());
+    ASSERT_EQ (record.mId, loaded.mId);
+    ASSERT_EQ (record.mName, loaded.mName);
+}
+
+/// Tests compressing the records of a saved game that was written without compression.
+TEST_F(StoreTest, compress_records_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = "foobar";
+    record.mName = std::string(200, 'a');
+
+    ESM::ESMWriter writer;
+    std::stringstream uncompressed;
+    writer.setFormat(ESM::SavedGame::sCurrentFormat);
+    writer.save(uncompressed);
+    writer.startRecord(RecordType::sRecordId);
+    record.save(writer);
+    writer.endRecord(RecordType::sRecordId);
+
+    std::stringstream* stream = new std::stringstream;
+    ESM::ESMWriter::compressRecords(uncompressed, 1, *stream);
+    ASSERT_LT (stream->str().size(), uncompressed.str().size());
+
+    ESM::ESMReader reader;
+    reader.open(Files::IStreamPtr(stream), "filename");
+
+    ASSERT_EQ (ESM::SavedGame::sCurrentFormat, reader.getFormat());
+    ASSERT_TRUE (reader.hasMoreRecs());
+    reader.getRecName();
+    reader.getRecHeader();
+    ASSERT_TRUE (reader.isRecordCompressed());
+
+    RecordType loaded;
+    bool isDeleted = false;
+    loaded.load(reader, isDeleted);
+
+    ASSERT_FALSE (reader.hasMoreSubs());
+    ASSERT_FALSE (reader.hasMoreRecs());
+    ASSERT_EQ (record.mId, loaded.mId);
+    ASSERT_EQ (record.mName, loaded.mName);
+}
+
+/// Tests that the compression flag is rejected in files that do not support compressed records.
+TEST_F(StoreTest, compressed_record_in_content_file_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = "foobar";
+
+    ESM::ESMReader reader;
+    Files::IStreamPtr file = getEsmFile(record, false, ESM::FLAG_Compressed);
+    reader.open(file, "filename");
+
+    ASSERT_TRUE (reader.hasMoreRecs());
+    reader.getRecName();
+    ASSERT_THROW (reader.getRecHeader(), std::runtime_error);
+    ASSERT_FALSE (reader.isRecordCompressed());
+}
+
 /// Tests overwriting of records.
 TEST_F(StoreTest, overwrite_test)
 {
@@ -313,3 +410,184 @@ TEST_F(StoreTest, overwrite_test)
 
     ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
 }
+
+/// Load a file through ESMStore::stage() and the staged overload of ESMStore::load(), the way the parallel loader does.
+void loadStaged(MWWorld::ESMStore& esmStore, ESM::ESMReader& reader, Files::IStreamPtr file)
+{
+    std::stringstream* copy = new std::stringstream;
+    *copy << file->rdbuf();
+    file->seekg(0);
+
+    ESM::ESMReader stagingReader;
+    stagingReader.open(Files::IStreamPtr(copy), "filename");
+    MWWorld::StagedContentFile staged;
+    esmStore.stage(stagingReader, staged);
+
+    reader.open(file, "filename");
+    esmStore.load(reader, staged, &dummyListener);
+    esmStore.setUp();
+}
+
+/// Tests that staged loading applies deletions and overwrites like the regular loading does.
+TEST_F(StoreTest, staged_load_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = "foobar";
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+
+    loadStaged(mEsmStore, reader, getEsmFile(record, false));
+    ASSERT_TRUE (mEsmStore.get<RecordType>().getSize() == 1);
+
+    loadStaged(mEsmStore, reader, getEsmFile(record, true));
+    ASSERT_TRUE (mEsmStore.get<RecordType>().getSize() == 0);
+
+    record.mId = "Foobar";
+    record.mModel = "the_new_model";
+    loadStaged(mEsmStore, reader, getEsmFile(record, false));
+    const RecordType* overwrittenRec = mEsmStore.get<RecordType>().search("foobar");
+    ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
+
+    // dialogue records can not be staged, and are read back from the main reader
+    ESM::Dialogue dialogue;
+    dialogue.blank();
+    dialogue.mId = "Greeting";
+    dialogue.mType = ESM::Dialogue::Greeting;
+    loadStaged(mEsmStore, reader, getEsmFile(dialogue, false));
+    ASSERT_TRUE (mEsmStore.get<ESM::Dialogue>().search("greeting") != NULL);
+}
+
+/// Tests that records written by ESMStore::writeCache() are restored by ESMStore::readCache().
+TEST_F(StoreTest, cache_test)
+{
+    ESM::NPC npc;
+    npc.blank();
+    npc.mId = "Foobar";
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+
+    reader.open(getEsmFile(npc, false, 0x0400), "filename"); // persistent
+    mEsmStore.load(reader, &dummyListener);
+
+    ESM::ESMWriter writer;
+    std::stringstream* stream = new std::stringstream;
+    writer.setFormat(0);
+    writer.save(*stream);
+    mEsmStore.writeCache(writer);
+    writer.close();
+
+    // the cached records are skipped when loading the content file
+    MWWorld::ESMStore cachedStore;
+    reader.open(getEsmFile(npc, false), "filename");
+    cachedStore.loadUncached(reader, &dummyListener);
+    ASSERT_TRUE (cachedStore.get<ESM::NPC>().getSize() == 0);
+
+    reader.open(Files::IStreamPtr(stream), "cache");
+    cachedStore.readCache(reader, &dummyListener);
+    cachedStore.setUp();
+
+    const ESM::NPC* cachedNpc = cachedStore.get<ESM::NPC>().search("foobar");
+    ASSERT_TRUE (cachedNpc != NULL);
+    ASSERT_TRUE (cachedNpc->mPersistent);
+}
+
+/// Tests lookups by id after inserting and erasing static and dynamic records.
+TEST(StoreLookupTest, lookup_test)
+{
+    MWWorld::Store<ESM::Static> store;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ESM::Static record;
+        std::ostringstream id;
+        id << "Static_" << i;
+        record.mId = id.str();
+        store.insertStatic(record);
+    }
+
+    // every other static record is deleted by a plugin
+    for (int i = 0; i < 1000; i += 2)
+    {
+        std::ostringstream id;
+        id << "static_" << i;
+        store.eraseStatic(id.str());
+    }
+
+    ESM::Static dynamic;
+    dynamic.mId = "STATIC_1";
+    dynamic.mModel = "dynamic";
+    store.insert(dynamic);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        std::ostringstream id;
+        id << "sTaTiC_" << i;
+        const ESM::Static* record = store.search(id.str());
+        if (i % 2 == 0)
+            ASSERT_TRUE (record == NULL);
+        else
+            ASSERT_TRUE (record != NULL && Misc::StringUtils::ciEqual(record->mId, id.str()));
+    }
+
+    // dynamic records take precedence over static ones with the same id
+    ASSERT_TRUE (store.search("static_1")->mModel == "dynamic");
+    store.erase("static_1");
+    ASSERT_TRUE (store.search("static_1") != NULL && store.search("static_1")->mModel.empty());
+
+    const char* id = "static_3 with trailing data";
+    ASSERT_TRUE (store.search(id, 8) == store.search("static_3"));
+}
+
+/// Compares lookups in a Store with lookups in a std::map keyed by lower case ids, as Store used to do.
+TEST(StoreLookupTest, lookup_benchmark)
+{
+    const int numRecords = 20000;
+    const int numLookups = 1000000;
+
+    MWWorld::Store<ESM::Static> store;
+    std::map<std::string, ESM::Static> map;
+    std::vector<std::string> ids;
+    for (int i = 0; i < numRecords; ++i)
+    {
+        ESM::Static record;
+        std::ostringstream id;
+        id << "Furn_De_Ex_Bench_" << i;
+        record.mId = id.str();
+        store.insertStatic(record);
+        map[Misc::StringUtils::lowerCase(record.mId)] = record;
+        ids.push_back(record.mId);
+    }
+
+    size_t found = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numLookups; ++i)
+    {
+        const std::string& id = ids[(i * 7919u) % numRecords];
+        std::map<std::string, ESM::Static>::const_iterator it = map.find(Misc::StringUtils::lowerCase(id));
+        if (it != map.end())
+            ++found;
+    }
+    std::chrono::steady_clock::time_point mapEnd = std::chrono::steady_clock::now();
+    for (int i = 0; i < numLookups; ++i)
+    {
+        if (store.search(ids[(i * 7919u) % numRecords]))
+            ++found;
+    }
+    std::chrono::steady_clock::time_point storeEnd = std::chrono::steady_clock::now();
+
+    ASSERT_EQ (found, static_cast<size_t>(numLookups) * 2);
+
+    typedef std::chrono::duration<double, std::milli> Milliseconds;
+    std::cout << numLookups << " lookups in " << numRecords << " records: std::map "
+              << Milliseconds(mapEnd - start).count() << " ms, Store "
+              << Milliseconds(storeEnd - mapEnd).count() << " ms" << std::endl;
+}
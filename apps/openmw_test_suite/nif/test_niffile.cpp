@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+
+#include "components/nif/niffile.hpp"
+#include "components/nif/extra.hpp"
+#include "components/nif/data.hpp"
+
+namespace
+{
+    void writeUInt(std::ostream& stream, unsigned int value)
+    {
+        // NIF files are little endian
+        for (int i=0; i<4; ++i)
+            stream.put(char((value >> (i*8)) & 0xff));
+    }
+
+    void writeUShort(std::ostream& stream, unsigned short value)
+    {
+        stream.put(char(value & 0xff));
+        stream.put(char(value >> 8));
+    }
+
+    void writeFloat(std::ostream& stream, float value)
+    {
+        unsigned int bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUInt(stream, bits);
+    }
+
+    void writeString(std::ostream& stream, const std::string& str)
+    {
+        writeUInt(stream, str.size());
+        stream << str;
+    }
+
+    std::string makeStringExtraDataFile(const std::string& str)
+    {
+        std::ostringstream stream;
+        stream << "NetImmerse File Format, Version 4.0.0.2\n";
+        writeUInt(stream, 0x04000002);
+        writeUInt(stream, 1); // records
+        writeString(stream, "NiStringExtraData");
+        writeUInt(stream, 0xffffffff); // no extra data
+        writeUInt(stream, str.size() + 4);
+        writeString(stream, str);
+        writeUInt(stream, 1); // roots
+        writeUInt(stream, 0);
+        return stream.str();
+    }
+
+    /// A single triangle, with vertices but no normals, colors or texture coordinates
+    std::string makeTriShapeDataFile()
+    {
+        std::ostringstream stream;
+        stream << "NetImmerse File Format, Version 4.0.0.2\n";
+        writeUInt(stream, 0x04000002);
+        writeUInt(stream, 1); // records
+        writeString(stream, "NiTriShapeData");
+        writeUShort(stream, 3); // vertices
+        writeUInt(stream, 1);
+        for (int i=0; i<9; ++i)
+            writeFloat(stream, float(i));
+        writeUInt(stream, 0); // no normals
+        for (int i=0; i<4; ++i)
+            writeFloat(stream, 0.f); // center and radius
+        writeUInt(stream, 0); // no colors
+        writeUShort(stream, 0); // no texture coordinates
+        writeUInt(stream, 0);
+        writeUShort(stream, 1); // triangles
+        writeUInt(stream, 3);
+        for (int i=0; i<3; ++i)
+            writeUShort(stream, i);
+        writeUShort(stream, 0); // no match groups
+        writeUInt(stream, 1); // roots
+        writeUInt(stream, 0);
+        return stream.str();
+    }
+
+    Files::IStreamPtr makeStream(const std::string& data)
+    {
+        return Files::IStreamPtr(new std::istringstream(data));
+    }
+}
+
+TEST(NIFFileTest, parse_test)
+{
+    std::string data = makeStringExtraDataFile("sgo");
+    Nif::NIFFile file(makeStream(data), "test.nif");
+
+    EXPECT_EQ(file.getSize(), data.size());
+    ASSERT_EQ(file.numRecords(), 1u);
+    ASSERT_EQ(file.numRoots(), 1u);
+    const Nif::NiStringExtraData* extra = dynamic_cast<const Nif::NiStringExtraData*>(file.getRoot());
+    ASSERT_TRUE(extra != NULL);
+    EXPECT_EQ(extra->string, "sgo");
+}
+
+TEST(NIFFileTest, truncated_file_test)
+{
+    std::string data = makeStringExtraDataFile("sgo");
+    // Reading past the end fails, also in the middle of a value or a string
+    for (size_t size = data.size()-1; size > data.size()-12; --size)
+        EXPECT_THROW(Nif::NIFFile(makeStream(data.substr(0, size)), "test.nif"), std::runtime_error);
+}
+
+TEST(NIFFileTest, corrupted_count_test)
+{
+    // A string length larger than the file must not be allocated
+    std::string data = makeStringExtraDataFile("sgo");
+    for (size_t i = data.size() - 15; i < data.size() - 11; ++i)
+        data[i] = char(0xff);
+    EXPECT_THROW(Nif::NIFFile(makeStream(data), "test.nif"), std::runtime_error);
+}
+
+TEST(NIFFileTest, arena_arrays_test)
+{
+    Nif::NIFFile file(makeStream(makeTriShapeDataFile()), "test.nif");
+
+    ASSERT_EQ(file.numRecords(), 1u);
+    const Nif::NiTriShapeData* data = dynamic_cast<const Nif::NiTriShapeData*>(file.getRoot());
+    ASSERT_TRUE(data != NULL);
+    ASSERT_EQ(data->vertices.size(), 3u);
+    EXPECT_EQ(data->vertices[2], osg::Vec3f(6.f, 7.f, 8.f));
+    ASSERT_EQ(data->triangles.size(), 3u);
+    EXPECT_EQ(data->triangles[2], 2);
+    EXPECT_TRUE(data->normals.empty());
+
+    // The record and its two arrays come from the arena
+    EXPECT_EQ(data->vertices.get_allocator().getArena(), &file.getArena());
+    EXPECT_EQ(data->triangles.get_allocator().getArena(), &file.getArena());
+    EXPECT_EQ(file.getArena().getNumAllocations(), 3u);
+
+    // Copies do not share the arena, which is not thread safe
+    Nif::ArenaVector<osg::Vec3f> copy = data->vertices;
+    EXPECT_TRUE(copy.get_allocator().getArena() == NULL);
+    EXPECT_EQ(copy[2], data->vertices[2]);
+}
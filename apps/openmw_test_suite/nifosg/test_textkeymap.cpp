@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "components/nifosg/textkeymap.hpp"
+
+TEST(TextKeyMapTest, split_and_type_test)
+{
+    NifOsg::TextKey key(0.5f, "attack1: chop hit");
+    EXPECT_EQ(key.mGroup, "attack1");
+    EXPECT_EQ(key.mEvent, "chop hit");
+    EXPECT_EQ(key.mType, NifOsg::TextKey::Type_ChopHit);
+
+    EXPECT_EQ(NifOsg::TextKey(0.f, "soundgen: left 0.5").mType, NifOsg::TextKey::Type_SoundGen);
+    EXPECT_EQ(NifOsg::TextKey(0.f, "spellcast: touch release").mType, NifOsg::TextKey::Type_Release);
+    EXPECT_EQ(NifOsg::TextKey(0.f, "idle3: stop.").mType, NifOsg::TextKey::Type_Other);
+
+    NifOsg::TextKey noGroup(0.f, "footstep");
+    EXPECT_TRUE(noGroup.mGroup.empty());
+    EXPECT_EQ(noGroup.mEvent, "footstep");
+}
+
+TEST(TextKeyMapTest, group_index_test)
+{
+    NifOsg::TextKeyMap keys;
+    keys.insert(1.f, "walkforward: stop");
+    keys.insert(0.f, "walkforward: start");
+    keys.insert(0.5f, "idle: start");
+    keys.insert(0.5f, "walkforward: loop start");
+    keys.insert(2.f, "idle: stop");
+
+    ASSERT_EQ(keys.size(), 5u);
+    for (size_t i=1; i<keys.size(); ++i)
+        EXPECT_LE(keys[i-1].mTime, keys[i].mTime);
+    // Keys of the same time keep their insertion order
+    EXPECT_EQ(keys[1].mText, "idle: start");
+    EXPECT_EQ(keys[2].mText, "walkforward: loop start");
+
+    const NifOsg::TextKeyMap::Group* group = keys.getGroup("walkforward");
+    ASSERT_TRUE(group != NULL);
+    ASSERT_EQ(group->size(), 3u);
+    EXPECT_EQ(keys[(*group)[0]].mType, NifOsg::TextKey::Type_Start);
+    EXPECT_EQ(keys[(*group)[1]].mType, NifOsg::TextKey::Type_LoopStart);
+    EXPECT_EQ(keys[(*group)[2]].mType, NifOsg::TextKey::Type_Stop);
+    EXPECT_TRUE(keys.getGroup("run") == NULL);
+
+    EXPECT_EQ(keys.getTime("idle: stop"), 2.f);
+    EXPECT_EQ(keys.getTime("walkforward: loop"), 0.5f);
+    EXPECT_EQ(keys.getTime("run: start"), -1.f);
+
+    EXPECT_EQ(keys.lowerBound(0.5f) - keys.begin(), 1);
+    EXPECT_EQ(keys.upperBound(0.5f) - keys.begin(), 3);
+}
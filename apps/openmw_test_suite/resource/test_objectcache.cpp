@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include <osg/Node>
+
+#include "components/resource/objectcache.hpp"
+#include "components/resource/resourcemanager.hpp"
+
+namespace
+{
+    class TestObjectCache : public Resource::ObjectCache
+    {
+    public:
+        /// Is the object cached, without marking it as used?
+        bool contains(const std::string& name)
+        {
+            Shard& shard = getShard(name);
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+            return shard.mObjectCache.find(name) != shard.mObjectCache.end();
+        }
+
+        /// Make \a count names that are stored in the same shard.
+        std::vector<std::string> makeNamesInOneShard(size_t count)
+        {
+            std::vector<std::string> names;
+            for (int i=0; names.size() < count; ++i)
+            {
+                std::ostringstream name;
+                name << "meshes/object" << i << ".nif";
+                if (names.empty() || &getShard(names.front()) == &getShard(name.str()))
+                    names.push_back(name.str());
+            }
+            return names;
+        }
+    };
+
+    class TestResourceManager : public Resource::ResourceManager
+    {
+    public:
+        TestResourceManager()
+            : Resource::ResourceManager(NULL)
+        {
+        }
+
+        Resource::ObjectCache* getCache()
+        {
+            return mCache.get();
+        }
+    };
+
+    TEST(ObjectCacheTest, removes_least_recently_used_objects_first)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+        std::vector<std::string> names = cache->makeNamesInOneShard(3);
+
+        cache->addEntryToObjectCache(names[0], new osg::Node, 100);
+        cache->addEntryToObjectCache(names[1], new osg::Node, 100);
+        cache->addEntryToObjectCache(names[2], new osg::Node, 100);
+        EXPECT_TRUE(cache->getRefFromObjectCache(names[0]));
+
+        cache->removeLeastRecentlyUsedObjectsInCache(200);
+        EXPECT_TRUE(cache->contains(names[0]));
+        EXPECT_FALSE(cache->contains(names[1]));
+        EXPECT_TRUE(cache->contains(names[2]));
+
+        cache->removeLeastRecentlyUsedObjectsInCache(100);
+        EXPECT_TRUE(cache->contains(names[0]));
+        EXPECT_FALSE(cache->contains(names[2]));
+        EXPECT_EQ(cache->getStats().mEvictions, 2u);
+    }
+
+    TEST(ObjectCacheTest, keeps_referenced_objects)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+        std::vector<std::string> names = cache->makeNamesInOneShard(2);
+
+        osg::ref_ptr<osg::Node> referenced (new osg::Node);
+        cache->addEntryToObjectCache(names[0], referenced, 100);
+        cache->addEntryToObjectCache(names[1], new osg::Node, 100);
+
+        cache->removeLeastRecentlyUsedObjectsInCache(1);
+        EXPECT_TRUE(cache->contains(names[0]));
+        EXPECT_FALSE(cache->contains(names[1]));
+
+        for (int i=0; i<10; ++i)
+            cache->updateTimeStampsAndRemoveExpiredObjectsInCache(100.0, 100.0);
+        EXPECT_TRUE(cache->contains(names[0]));
+
+        // counts towards the budget once the sweep has seen that it is no longer referenced
+        referenced = NULL;
+        cache->updateTimeStampsAndRemoveExpiredObjectsInCache(100.0, 0.0);
+        cache->removeLeastRecentlyUsedObjectsInCache(1);
+        EXPECT_FALSE(cache->contains(names[0]));
+        EXPECT_EQ(cache->getCacheSize(), 0u);
+    }
+
+    TEST(ObjectCacheTest, budget_only_counts_unreferenced_objects)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+        std::vector<std::string> names = cache->makeNamesInOneShard(3);
+
+        std::vector<osg::ref_ptr<osg::Node> > inUse;
+        for (int i=0; i<2; ++i)
+        {
+            inUse.push_back(new osg::Node);
+            cache->addEntryToObjectCache(names[i], inUse.back(), 1000);
+        }
+        cache->addEntryToObjectCache(names[2], new osg::Node, 100);
+
+        // the objects in use exceed the budget, but the unreferenced one is within it
+        cache->removeLeastRecentlyUsedObjectsInCache(100);
+        EXPECT_TRUE(cache->contains(names[2]));
+        EXPECT_EQ(cache->getStats().mEvictions, 0u);
+    }
+
+    TEST(ObjectCacheTest, budget_applies_to_whole_cache)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+
+        // larger than an equal share of the budget per shard, but the cache as a whole is within the budget
+        const size_t budget = 1000;
+        cache->addEntryToObjectCache("meshes/large.nif", new osg::Node, budget / 2);
+        cache->removeLeastRecentlyUsedObjectsInCache(budget);
+        EXPECT_TRUE(cache->contains("meshes/large.nif"));
+
+        cache->removeLeastRecentlyUsedObjectsInCache(budget / 4);
+        EXPECT_FALSE(cache->contains("meshes/large.nif"));
+    }
+
+    TEST(ObjectCacheTest, eviction_resumes_where_it_stopped)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+        const size_t count = 1000;
+        std::vector<std::string> names = cache->makeNamesInOneShard(count);
+
+        // entries in use at the end of the usage list do not hold up the eviction of the others
+        std::vector<osg::ref_ptr<osg::Node> > inUse;
+        for (size_t i=0; i<count; ++i)
+        {
+            osg::Node* node = new osg::Node;
+            if (i < count / 2)
+                inUse.push_back(node);
+            cache->addEntryToObjectCache(names[i], node, 1);
+        }
+
+        // Each call only visits part of the shard
+        cache->removeLeastRecentlyUsedObjectsInCache(0);
+        EXPECT_GT(cache->getCacheSize(), count / 2);
+
+        unsigned int calls = 1;
+        while (cache->getCacheSize() > count / 2 && calls < count)
+        {
+            cache->removeLeastRecentlyUsedObjectsInCache(0);
+            ++calls;
+        }
+
+        EXPECT_EQ(cache->getCacheSize(), count / 2);
+        EXPECT_EQ(cache->getStats().mEvictions, count / 2);
+        for (size_t i=0; i<count / 2; ++i)
+            EXPECT_TRUE(cache->contains(names[i]));
+    }
+
+    TEST(ObjectCacheTest, keeps_objects_of_unknown_size)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+
+        cache->addEntryToObjectCache("meshes/unknown.nif", new osg::Node);
+        cache->removeLeastRecentlyUsedObjectsInCache(1);
+        EXPECT_TRUE(cache->contains("meshes/unknown.nif"));
+    }
+
+    TEST(ObjectCacheTest, update_cache_enforces_budget)
+    {
+        TestResourceManager manager;
+        manager.setExpiryDelay(1000.0);
+        const size_t budget = 100 * 1024;
+        manager.setCacheBudget(budget);
+
+        for (int i=0; i<1000; ++i)
+        {
+            std::ostringstream name;
+            name << "meshes/object" << i << ".nif";
+            manager.getCache()->addEntryToObjectCache(name.str(), new osg::Node, 1024, 0.0);
+        }
+        EXPECT_EQ(manager.getCache()->getStats().mSize, 1000u * 1024);
+
+        manager.updateCache(1.0);
+
+        // The objects have not expired yet, only the budget applies
+        Resource::ObjectCache::Stats stats = manager.getCache()->getStats();
+        EXPECT_LE(stats.mSize, budget);
+        EXPECT_GT(stats.mSize, 0u);
+        EXPECT_EQ(manager.getCache()->getCacheSize() + stats.mEvictions, 1000u);
+    }
+
+    TEST(ObjectCacheTest, expiry_sweep_resumes_where_it_stopped)
+    {
+        osg::ref_ptr<TestObjectCache> cache (new TestObjectCache);
+
+        const unsigned int count = 20000;
+        for (unsigned int i=0; i<count; ++i)
+        {
+            std::ostringstream name;
+            name << "meshes/object" << i << ".nif";
+            cache->addEntryToObjectCache(name.str(), new osg::Node, 1, 0.0);
+        }
+
+        // Each call only visits part of the cache, later calls continue with the entries not visited yet
+        unsigned int calls = 0;
+        unsigned int remaining = count;
+        while (remaining > 0 && calls < count)
+        {
+            cache->updateTimeStampsAndRemoveExpiredObjectsInCache(10.0, 5.0);
+            ++calls;
+
+            unsigned int size = cache->getCacheSize();
+            EXPECT_LT(size, remaining);
+            remaining = size;
+        }
+
+        EXPECT_EQ(remaining, 0u);
+        EXPECT_GT(calls, 1u);
+        EXPECT_EQ(cache->getStats().mEvictions, count);
+    }
+}
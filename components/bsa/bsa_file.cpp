@@ -24,6 +24,7 @@
 #include "bsa_file.hpp"
 
 #include <cassert>
+#include <iostream>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/fstream.hpp>
@@ -160,10 +161,29 @@ int BSAFile::getIndex(const char *str) const
 }
 
 /// Open an archive file.
-void BSAFile::open(const string &file)
+void BSAFile::open(const string &file, bool memoryMapped)
 {
     filename = file;
     readHeader();
+
+    if (memoryMapped)
+    {
+        try
+        {
+            mappedFile.reset(new Files::MappedFile(filename));
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Warning: " << e.what() << ", falling back to file streams" << std::endl;
+        }
+    }
+}
+
+Files::IStreamPtr BSAFile::openFile(const FileStruct &file) const
+{
+    if (mappedFile)
+        return Files::IStreamPtr(new Files::MappedFileStream(mappedFile, file.offset, file.fileSize));
+    return Files::openConstrainedFileStream (filename.c_str (), file.offset, file.fileSize);
 }
 
 Files::IStreamPtr BSAFile::getFile(const char *file)
@@ -173,12 +193,10 @@ Files::IStreamPtr BSAFile::getFile(const char *file)
     if(i == -1)
         fail("File not found: " + string(file));
 
-    const FileStruct &fs = files[i];
-
-    return Files::openConstrainedFileStream (filename.c_str (), fs.offset, fs.fileSize);
+    return openFile(files[i]);
 }
 
 Files::IStreamPtr BSAFile::getFile(const FileStruct *file)
 {
-    return Files::openConstrainedFileStream (filename.c_str (), file->offset, file->fileSize);
+    return openFile(*file);
 }
@@ -32,6 +32,7 @@
 #include <components/misc/stringops.hpp>
 
 #include <components/files/constrainedfilestream.hpp>
+#include <components/files/mappedfile.hpp>
 
 
 namespace Bsa
@@ -69,6 +70,9 @@ private:
     /// Used for error messages
     std::string filename;
 
+    /// The whole archive mapped into memory, NULL when files are read through streams
+    std::shared_ptr<const Files::MappedFile> mappedFile;
+
     /// Case insensitive string comparison
     struct iltstr
     {
@@ -93,6 +97,10 @@ private:
     /// @note Thread safe.
     int getIndex(const char *str) const;
 
+    /// Open a stream for the given file, either a view into the mapped archive or a file stream.
+    /// @note Thread safe.
+    Files::IStreamPtr openFile(const FileStruct &file) const;
+
 public:
     /* -----------------------------------
      * BSA management methods
@@ -104,7 +112,17 @@ public:
     { }
 
     /// Open an archive file.
-    void open(const std::string &file);
+    /// @param memoryMapped Map the whole archive into memory and hand out views into it, instead of
+    /// opening a new file stream for every file requested. Falls back to file streams if mapping fails.
+    void open(const std::string &file, bool memoryMapped=false);
+
+    /// Path of the archive
+    const std::string& getFilename() const
+    { return filename; }
+
+    /// Is the archive mapped into memory?
+    bool isMemoryMapped() const
+    { return mappedFile.get() != NULL; }
 
     /* -----------------------------------
      * Archive file routines
@@ -117,6 +135,7 @@ public:
 
     /** Open a file contained in the archive. Throws an exception if the
         file doesn't exist.
+     * @note If the archive is memory mapped, the returned stream is a Files::MappedFileStream.
      * @note Thread safe.
     */
     Files::IStreamPtr getFile(const char *file);
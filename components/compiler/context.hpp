@@ -40,6 +40,15 @@ namespace Compiler
             /// \return first: 'l: long, 's': short, 'f': float, ' ': does not exist.
             /// second: true: script of reference
 
+            virtual int getGlobalSlot (const std::string& name) const { return -1; }
+            ///< Return a number that identifies global variable \a name at runtime in place of its name.
+            /// \return -1: access the variable by name.
+
+            virtual int getMemberIndex (const std::string& name, const std::string& id) const { return -1; }
+            ///< Return index of member variable \a name among the variables of its type (see getMemberType)
+            /// in script \a id or in script of reference of \a id.
+            /// \return -1: access the variable by name.
+
             virtual bool isId (const std::string& name) const = 0;
             ///< Does \a name match an ID, that can be referenced?
 
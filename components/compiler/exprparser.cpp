@@ -209,7 +209,8 @@ namespace Compiler
 
         if (type.first!=' ')
         {
-            Generator::fetchMember (mCode, mLiterals, type.first, name2, id, !type.second);
+            Generator::fetchMember (mCode, mLiterals, type.first, name2,
+                getContext().getMemberIndex (name2, id), id, !type.second);
 
             mNextOperand = false;
             mExplicit.clear();
@@ -305,7 +306,7 @@ namespace Compiler
 
             if (type!=' ')
             {
-                Generator::fetchGlobal (mCode, mLiterals, type, name2);
+                Generator::fetchGlobal (mCode, mLiterals, type, name2, getContext().getGlobalSlot (name2));
                 mNextOperand = false;
                 mOperands.push_back (type=='f' ? 'f' : 'l');
                 return true;
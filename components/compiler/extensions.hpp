@@ -109,6 +109,10 @@ namespace Compiler
 
             void listKeywords (std::vector<std::string>& keywords) const;
             ///< Append all known keywords to \a kaywords.
+
+            std::string getKeyword (int segment, int code) const;
+            ///< Return the keyword of the function or instruction that is implemented by opcode \a code
+            /// in \a segment (the longest one, if there are several), or an empty string.
     };
 }
 
@@ -320,6 +320,10 @@ namespace Compiler
             extensions.registerInstruction ("removefromlevitem", "ccl", opcodeRemoveFromLevItem);
             extensions.registerInstruction ("tb", "", opcodeToggleBorders);
             extensions.registerInstruction ("toggleborders", "", opcodeToggleBorders);
+            extensions.registerInstruction ("tsp", "", opcodeToggleScriptProfiler);
+            extensions.registerInstruction ("togglescriptprofiler", "", opcodeToggleScriptProfiler);
+            extensions.registerInstruction ("rsp", "", opcodeReportScriptProfile);
+            extensions.registerInstruction ("reportscriptprofile", "", opcodeReportScriptProfile);
         }
     }
 
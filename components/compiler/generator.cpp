@@ -227,64 +227,82 @@ namespace
         code.push_back (Compiler::Generator::segment5 (38));
     }
 
-    void opStoreGlobalShort (Compiler::Generator::CodeContainer& code)
+    void opStoreGlobalShort (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (39));
+        code.push_back (Compiler::Generator::segment5 (slot ? 72 : 39));
     }
 
-    void opStoreGlobalLong (Compiler::Generator::CodeContainer& code)
+    void opStoreGlobalLong (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (40));
+        code.push_back (Compiler::Generator::segment5 (slot ? 73 : 40));
     }
 
-    void opStoreGlobalFloat (Compiler::Generator::CodeContainer& code)
+    void opStoreGlobalFloat (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (41));
+        code.push_back (Compiler::Generator::segment5 (slot ? 74 : 41));
     }
 
-    void opFetchGlobalShort (Compiler::Generator::CodeContainer& code)
+    void opFetchGlobalShort (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (42));
+        code.push_back (Compiler::Generator::segment5 (slot ? 75 : 42));
     }
 
-    void opFetchGlobalLong (Compiler::Generator::CodeContainer& code)
+    void opFetchGlobalLong (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (43));
+        code.push_back (Compiler::Generator::segment5 (slot ? 76 : 43));
     }
 
-    void opFetchGlobalFloat (Compiler::Generator::CodeContainer& code)
+    void opFetchGlobalFloat (Compiler::Generator::CodeContainer& code, bool slot)
     {
-        code.push_back (Compiler::Generator::segment5 (44));
+        code.push_back (Compiler::Generator::segment5 (slot ? 77 : 44));
     }
 
-    void opStoreMemberShort (Compiler::Generator::CodeContainer& code, bool global)
+    void opStoreMemberShort (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 65 : 59));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 84 : 78));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 65 : 59));
     }
 
-    void opStoreMemberLong (Compiler::Generator::CodeContainer& code, bool global)
+    void opStoreMemberLong (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 66 : 60));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 85 : 79));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 66 : 60));
     }
 
-    void opStoreMemberFloat (Compiler::Generator::CodeContainer& code, bool global)
+    void opStoreMemberFloat (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 67 : 61));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 86 : 80));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 67 : 61));
     }
 
-    void opFetchMemberShort (Compiler::Generator::CodeContainer& code, bool global)
+    void opFetchMemberShort (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 68 : 62));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 87 : 81));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 68 : 62));
     }
 
-    void opFetchMemberLong (Compiler::Generator::CodeContainer& code, bool global)
+    void opFetchMemberLong (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 69 : 63));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 88 : 82));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 69 : 63));
     }
 
-    void opFetchMemberFloat (Compiler::Generator::CodeContainer& code, bool global)
+    void opFetchMemberFloat (Compiler::Generator::CodeContainer& code, bool global, bool index)
     {
-        code.push_back (Compiler::Generator::segment5 (global ? 70 : 64));
+        if (index)
+            code.push_back (Compiler::Generator::segment5 (global ? 89 : 83));
+        else
+            code.push_back (Compiler::Generator::segment5 (global ? 70 : 64));
     }
 
     void opRandom (Compiler::Generator::CodeContainer& code)
@@ -651,11 +669,12 @@ namespace Compiler
         }
 
         void assignToGlobal (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name, const CodeContainer& value, char valueType)
+            const std::string& name, int slot, const CodeContainer& value, char valueType)
         {
-            int index = literals.addString (name);
-
-            opPushInt (code, index);
+            if (slot!=-1)
+                opPushInt (code, slot);
+            else
+                opPushInt (code, literals.addString (name));
 
             std::copy (value.begin(), value.end(), std::back_inserter (code));
 
@@ -675,17 +694,17 @@ namespace Compiler
             {
                 case 'f':
 
-                    opStoreGlobalFloat (code);
+                    opStoreGlobalFloat (code, slot!=-1);
                     break;
 
                 case 's':
 
-                    opStoreGlobalShort (code);
+                    opStoreGlobalShort (code, slot!=-1);
                     break;
 
                 case 'l':
 
-                    opStoreGlobalLong (code);
+                    opStoreGlobalLong (code, slot!=-1);
                     break;
 
                 default:
@@ -695,27 +714,28 @@ namespace Compiler
         }
 
         void fetchGlobal (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name)
+            const std::string& name, int slot)
         {
-            int index = literals.addString (name);
-
-            opPushInt (code, index);
+            if (slot!=-1)
+                opPushInt (code, slot);
+            else
+                opPushInt (code, literals.addString (name));
 
             switch (localType)
             {
                 case 'f':
 
-                    opFetchGlobalFloat (code);
+                    opFetchGlobalFloat (code, slot!=-1);
                     break;
 
                 case 's':
 
-                    opFetchGlobalShort (code);
+                    opFetchGlobalShort (code, slot!=-1);
                     break;
 
                 case 'l':
 
-                    opFetchGlobalLong (code);
+                    opFetchGlobalLong (code, slot!=-1);
                     break;
 
                 default:
@@ -725,16 +745,15 @@ namespace Compiler
         }
 
         void assignToMember (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name, const std::string& id, const CodeContainer& value,
+            const std::string& name, int index, const std::string& id, const CodeContainer& value,
             char valueType, bool global)
         {
-            int index = literals.addString (name);
-
-            opPushInt (code, index);
-
-            index = literals.addString (id);
+            if (index!=-1)
+                opPushInt (code, index);
+            else
+                opPushInt (code, literals.addString (name));
 
-            opPushInt (code, index);
+            opPushInt (code, literals.addString (id));
 
             std::copy (value.begin(), value.end(), std::back_inserter (code));
 
@@ -754,17 +773,17 @@ namespace Compiler
             {
                 case 'f':
 
-                    opStoreMemberFloat (code, global);
+                    opStoreMemberFloat (code, global, index!=-1);
                     break;
 
                 case 's':
 
-                    opStoreMemberShort (code, global);
+                    opStoreMemberShort (code, global, index!=-1);
                     break;
 
                 case 'l':
 
-                    opStoreMemberLong (code, global);
+                    opStoreMemberLong (code, global, index!=-1);
                     break;
 
                 default:
@@ -774,31 +793,30 @@ namespace Compiler
         }
 
         void fetchMember (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name, const std::string& id, bool global)
+            const std::string& name, int index, const std::string& id, bool global)
         {
-            int index = literals.addString (name);
-
-            opPushInt (code, index);
-
-            index = literals.addString (id);
+            if (index!=-1)
+                opPushInt (code, index);
+            else
+                opPushInt (code, literals.addString (name));
 
-            opPushInt (code, index);
+            opPushInt (code, literals.addString (id));
 
             switch (localType)
             {
                 case 'f':
 
-                    opFetchMemberFloat (code, global);
+                    opFetchMemberFloat (code, global, index!=-1);
                     break;
 
                 case 's':
 
-                    opFetchMemberShort (code, global);
+                    opFetchMemberShort (code, global, index!=-1);
                     break;
 
                 case 'l':
 
-                    opFetchMemberLong (code, global);
+                    opFetchMemberLong (code, global, index!=-1);
                     break;
 
                 default:
@@ -94,18 +94,23 @@ namespace Compiler
         void menuMode (CodeContainer& code);
 
         void assignToGlobal (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name, const CodeContainer& value, char valueType);
+            const std::string& name, int slot, const CodeContainer& value, char valueType);
+        ///< \param slot Slot of the variable as returned by Context::getGlobalSlot (-1: access by name).
 
         void fetchGlobal (CodeContainer& code, Literals& literals, char localType,
-            const std::string& name);
+            const std::string& name, int slot);
+        ///< \param slot Slot of the variable as returned by Context::getGlobalSlot (-1: access by name).
 
         void assignToMember (CodeContainer& code, Literals& literals, char memberType,
-            const std::string& name, const std::string& id, const CodeContainer& value, char valueType, bool global);
-        ///< \param global Member of a global script instead of a script of a reference.
+            const std::string& name, int index, const std::string& id, const CodeContainer& value, char valueType,
+            bool global);
+        ///< \param index Index of the variable as returned by Context::getMemberIndex (-1: access by name).
+        /// \param global Member of a global script instead of a script of a reference.
 
         void fetchMember (CodeContainer& code, Literals& literals, char memberType,
-            const std::string& name, const std::string& id, bool global);
-        ///< \param global Member of a global script instead of a script of a reference.
+            const std::string& name, int index, const std::string& id, bool global);
+        ///< \param index Index of the variable as returned by Context::getMemberIndex (-1: access by name).
+        /// \param global Member of a global script instead of a script of a reference.
 
         void random (CodeContainer& code);
 
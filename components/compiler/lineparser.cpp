@@ -451,7 +451,8 @@ namespace Compiler
             std::vector<Interpreter::Type_Code> code;
             char type = mExprParser.append (code);
 
-            Generator::assignToGlobal (mCode, mLiterals, mType, mName, code, type);
+            Generator::assignToGlobal (mCode, mLiterals, mType, mName, getContext().getGlobalSlot (mName),
+                code, type);
 
             mState = EndState;
             return true;
@@ -464,8 +465,8 @@ namespace Compiler
             std::vector<Interpreter::Type_Code> code;
             char type = mExprParser.append (code);
 
-            Generator::assignToMember (mCode, mLiterals, mType, mMemberName, mName, code, type,
-                !mReferenceMember);
+            Generator::assignToMember (mCode, mLiterals, mType, mMemberName,
+                getContext().getMemberIndex (mMemberName, mName), mName, code, type, !mReferenceMember);
 
             mState = EndState;
             return true;
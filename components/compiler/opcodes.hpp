@@ -296,6 +296,8 @@ namespace Compiler
         const int opcodeShowSceneGraph = 0x2002f;
         const int opcodeShowSceneGraphExplicit = 0x20030;
         const int opcodeToggleBorders = 0x2000307;
+        const int opcodeToggleScriptProfiler = 0x2000308;
+        const int opcodeReportScriptProfile = 0x2000309;
     }
 
     namespace Sky
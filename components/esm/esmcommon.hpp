@@ -15,6 +15,13 @@ enum Version
     VER_13 = 0x3fa66666
   };
 
+enum RecordFlag
+  {
+    // Not used by Morrowind. The record data is compressed with zlib and preceded by its uncompressed
+    // size (saved games of format 6 and later only, see ESMWriter::setCompression)
+    FLAG_Compressed = 0x00040000
+  };
+
 
 // CRTP for FIXED_STRING class, a structure used for holding fixed-length strings
 template< template<size_t> class DERIVED, size_t SIZE>
@@ -2,6 +2,12 @@
 
 #include <stdexcept>
 
+#include <zlib.h>
+
+#include <components/files/memorystream.hpp>
+
+#include "savedgame.hpp"
+
 namespace ESM
 {
 
@@ -21,6 +27,7 @@ ESM_Context ESMReader::getContext()
 
 ESMReader::ESMReader()
     : mIdx(0)
+    , mRecordCompressed(false)
     , mRecordFlags(0)
     , mBuffer(50*1024)
     , mGlobalReaderList(NULL)
@@ -36,6 +43,8 @@ int ESMReader::getFormat() const
 
 void ESMReader::restoreContext(const ESM_Context &rc)
 {
+    endCompressedRecord();
+
     // Reopen the file if necessary
     if (mCtx.filename != rc.filename)
         openRaw(rc.filename);
@@ -49,6 +58,7 @@ void ESMReader::restoreContext(const ESM_Context &rc)
 
 void ESMReader::close()
 {
+    endCompressedRecord();
     mEsm.reset();
     mCtx.filename.clear();
     mCtx.leftFile = 0;
@@ -75,6 +85,11 @@ void ESMReader::openRaw(const std::string& filename)
     openRaw(Files::openConstrainedFileStream(filename.c_str()), filename);
 }
 
+void ESMReader::reopen()
+{
+    mEsm = Files::openConstrainedFileStream(mCtx.filename.c_str());
+}
+
 void ESMReader::open(Files::IStreamPtr _esm, const std::string &name)
 {
     openRaw(_esm, name);
@@ -269,6 +284,7 @@ NAME ESMReader::getRecName()
 {
     if (!hasMoreRecs())
         fail("No more records, getRecName() failed");
+    endCompressedRecord();
     getName(mCtx.recName);
     mCtx.leftFile -= mCtx.recName.data_size();
 
@@ -287,6 +303,26 @@ void ESMReader::skipRecord()
     mCtx.subCached = false;
 }
 
+void ESMReader::getSubRecordPosition(size_t &filePos, uint32_t &leftRec)
+{
+    filePos = mEsm->tellg();
+    leftRec = mCtx.leftRec;
+
+    if (mCtx.subCached)
+    {
+        filePos -= mCtx.subName.data_size();
+        leftRec += mCtx.subName.data_size();
+    }
+}
+
+void ESMReader::seekSubRecord(size_t filePos, uint32_t leftRec)
+{
+    mEsm->seekg(filePos);
+    mCtx.leftRec = leftRec;
+    mCtx.leftSub = 0;
+    mCtx.subCached = false;
+}
+
 void ESMReader::getRecHeader(uint32_t &flags)
 {
     // General error checking
@@ -306,6 +342,55 @@ void ESMReader::getRecHeader(uint32_t &flags)
 
     // Adjust number of bytes mCtx.left in file
     mCtx.leftFile -= mCtx.leftRec;
+
+    mRecordCompressed = (flags & FLAG_Compressed) != 0;
+    if (mRecordCompressed)
+    {
+        // The flag is not defined for content files and older saved games
+        if (getFormat() < SavedGame::sCompressedRecordsFormat)
+        {
+            mRecordCompressed = false;
+            fail("Compressed record in a file of format " + std::to_string(getFormat()));
+        }
+
+        flags &= ~FLAG_Compressed;
+        decompressRecord();
+    }
+}
+
+void ESMReader::decompressRecord()
+{
+    uint32_t size;
+    if (mCtx.leftRec < sizeof(size))
+        fail("Compressed record is too small");
+
+    getUint(size);
+    mCtx.leftRec -= sizeof(size);
+
+    std::vector<char> compressed(mCtx.leftRec);
+    if (!compressed.empty())
+        getExact(&compressed[0], compressed.size());
+
+    std::shared_ptr<std::vector<char> > data = std::make_shared<std::vector<char> >(size);
+    uLongf dataSize = size;
+    if (size > 0 && (uncompress(reinterpret_cast<Bytef*>(&(*data)[0]), &dataSize,
+        reinterpret_cast<const Bytef*>(compressed.data()), compressed.size()) != Z_OK || dataSize != size))
+        fail("Failed to decompress record");
+
+    mFileStream = mEsm;
+    mRecordData = data;
+    mEsm = std::make_shared<Files::IMemStream>(mRecordData->data(), mRecordData->size());
+    mCtx.leftRec = size;
+}
+
+void ESMReader::endCompressedRecord()
+{
+    if (!mFileStream)
+        return;
+
+    mEsm = mFileStream;
+    mFileStream.reset();
+    mRecordData.reset();
 }
 
 /*************************************************************************
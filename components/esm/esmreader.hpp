@@ -6,6 +6,7 @@
 #include <cassert>
 #include <vector>
 #include <sstream>
+#include <memory>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -73,6 +74,10 @@ public:
 
   void openRaw(const std::string &filename);
 
+  /// Open a new stream of the current file, keeping the header. Allows a copy of this reader to read
+  /// the same file independently, e.g. on another thread. Use restoreContext() before reading.
+  void reopen();
+
   /// Get the current position in the file. Make sure that the file has been opened!
   size_t getFileOffset();
 
@@ -237,6 +242,14 @@ public:
   bool hasMoreRecs() const { return mCtx.leftFile > 0; }
   bool hasMoreSubs() const { return mCtx.leftRec > 0; }
 
+  /// Get the position of the next subrecord of the current record, including a subrecord name that has been read
+  /// but not used, and the number of bytes left in the record from there. See seekSubRecord().
+  void getSubRecordPosition(size_t &filePos, uint32_t &leftRec);
+
+  /// Continue reading the current record at a position from getSubRecordPosition(). The context of the record must
+  /// have been restored with restoreContext() first.
+  void seekSubRecord(size_t filePos, uint32_t leftRec);
+
 
   /*************************************************************************
    *
@@ -266,11 +279,26 @@ public:
   /// Get record flags of last record
   unsigned int getRecordFlags() { return mRecordFlags; }
 
+  /// Was the last record stored compressed? The data of compressed records is decompressed by getRecHeader(),
+  /// reading it works the same as for other records, but file offsets refer to the decompressed data.
+  bool isRecordCompressed() const { return mRecordCompressed; }
+
   size_t getFileSize() const { return mFileSize; }
 
 private:
+  /// Read the rest of the current record, which is compressed, and continue reading from its decompressed data.
+  void decompressRecord();
+
+  /// Continue reading from the file after a compressed record.
+  void endCompressedRecord();
+
   Files::IStreamPtr mEsm;
 
+  // The file stream while mEsm reads the decompressed data of a record
+  Files::IStreamPtr mFileStream;
+  std::shared_ptr<std::vector<char> > mRecordData;
+  bool mRecordCompressed;
+
   ESM_Context mCtx;
 
   unsigned int mRecordFlags;
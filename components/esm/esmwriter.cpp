@@ -1,16 +1,45 @@
 #include "esmwriter.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
+#include <vector>
+
+#include <zlib.h>
 
 #include <components/to_utf8/to_utf8.hpp>
 
+#include "savedgame.hpp"
+
+namespace
+{
+    /// Compress the data of a record, unless that does not make it smaller.
+    /// \return Was the data compressed? \a compressed then holds the uncompressed size followed by the compressed data.
+    bool compressRecordData(const char* data, size_t size, int level, std::vector<char>& compressed)
+    {
+        uLongf compressedSize = compressBound(size);
+        compressed.resize(sizeof(uint32_t) + compressedSize);
+
+        if (compress2(reinterpret_cast<Bytef*>(&compressed[sizeof(uint32_t)]), &compressedSize,
+                reinterpret_cast<const Bytef*>(data), size, level) != Z_OK
+            || compressedSize + sizeof(uint32_t) >= size)
+            return false;
+
+        uint32_t uncompressedSize = static_cast<uint32_t>(size);
+        std::memcpy(&compressed[0], &uncompressedSize, sizeof(uint32_t));
+        compressed.resize(sizeof(uint32_t) + compressedSize);
+        return true;
+    }
+}
+
 namespace ESM
 {
     ESMWriter::ESMWriter()
         : mRecords()
         , mStream(NULL)
+        , mFileStream(NULL)
+        , mCompression(0)
         , mHeaderPos()
         , mEncoder(NULL)
         , mRecordCount(0)
@@ -53,6 +82,11 @@ namespace ESM
         mHeader.mFormat = format;
     }
 
+    void ESMWriter::setCompression (int level)
+    {
+        mCompression = level;
+    }
+
     void ESMWriter::clearMaster()
     {
         mHeader.mMaster.clear();
@@ -95,12 +129,22 @@ namespace ESM
         rec.name = name;
         rec.position = mStream->tellp();
         rec.size = 0;
+        rec.flags = flags;
         writeT<uint32_t>(0); // Size goes here
         writeT<uint32_t>(0); // Unused header?
         writeT(flags);
         mRecords.push_back(rec);
 
         assert(mRecords.back().size == 0);
+
+        // Collect the record data, it is compressed as a whole when the record is complete
+        if (mCompression > 0 && name != "TES3" && mHeader.mFormat >= SavedGame::sCompressedRecordsFormat)
+        {
+            mFileStream = mStream;
+            mRecordBuffer.str("");
+            mRecordBuffer.clear();
+            mStream = &mRecordBuffer;
+        }
     }
 
     void ESMWriter::startRecord (uint32_t name, uint32_t flags)
@@ -123,6 +167,7 @@ namespace ESM
         rec.name = name;
         rec.position = mStream->tellp();
         rec.size = 0;
+        rec.flags = 0;
         writeT<uint32_t>(0); // Size goes here
         mRecords.push_back(rec);
 
@@ -135,6 +180,12 @@ namespace ESM
         assert(rec.name == name);
         mRecords.pop_back();
 
+        if (mRecords.empty() && mFileStream)
+        {
+            writeCompressedRecord(rec);
+            return;
+        }
+
         mStream->seekp(rec.position);
 
         mCounting = false;
@@ -145,6 +196,79 @@ namespace ESM
 
     }
 
+    void ESMWriter::writeCompressedRecord(RecordData& rec)
+    {
+        mStream = mFileStream;
+        mFileStream = NULL;
+
+        const std::string data = mRecordBuffer.str();
+        mRecordBuffer.str("");
+
+        std::vector<char> compressed;
+
+        mCounting = false;
+
+        if (compressRecordData(data.data(), data.size(), mCompression, compressed))
+        {
+            write(&compressed[0], compressed.size());
+
+            rec.size = static_cast<uint32_t>(compressed.size());
+            rec.flags |= FLAG_Compressed;
+        }
+        else
+            write(data.data(), data.size());
+
+        mStream->seekp(rec.position);
+        writeT(rec.size);
+        writeT<uint32_t>(0);
+        writeT(rec.flags);
+
+        mCounting = true;
+
+        mStream->seekp(0, std::ios::end);
+    }
+
+    void ESMWriter::compressRecords (std::istream& in, int level, std::ostream& out)
+    {
+        std::vector<char> data;
+        std::vector<char> compressed;
+        bool first = true;
+
+        // name, size, unused, flags
+        char header[4 * sizeof(uint32_t)];
+
+        while (in.read(header, sizeof(header)))
+        {
+            uint32_t size;
+            uint32_t flags;
+            std::memcpy(&size, header + 4, sizeof(uint32_t));
+            std::memcpy(&flags, header + 12, sizeof(uint32_t));
+
+            data.resize(size);
+            if (size > 0 && !in.read(&data[0], size))
+                throw std::runtime_error("Record extends past the end of the data to compress");
+
+            // the TES3 header is never compressed
+            if (!first && compressRecordData(data.data(), data.size(), level, compressed))
+            {
+                size = static_cast<uint32_t>(compressed.size());
+                flags |= FLAG_Compressed;
+                std::memcpy(header + 4, &size, sizeof(uint32_t));
+                std::memcpy(header + 12, &flags, sizeof(uint32_t));
+                data.swap(compressed);
+            }
+
+            out.write(header, sizeof(header));
+            if (size > 0)
+                out.write(&data[0], size);
+
+            first = false;
+        }
+
+        if (in.gcount() != 0)
+            throw std::runtime_error("Incomplete record header in the data to compress");
+    }
+
     void ESMWriter::endRecord (uint32_t name)
     {
         std::string type;
@@ -1,8 +1,8 @@
 #ifndef OPENMW_ESM_WRITER_H
 #define OPENMW_ESM_WRITER_H
 
-#include <iosfwd>
 #include <list>
+#include <sstream>
 
 #include "esmcommon.hpp"
 #include "loadtes3.hpp"
@@ -21,6 +21,7 @@ class ESMWriter
             std::string name;
             std::streampos position;
             uint32_t size;
+            uint32_t flags;
         };
 
     public:
@@ -45,6 +46,19 @@ class ESMWriter
         int getRecordCount() { return mRecordCount; }
         void setFormat (int format);
 
+        /// Compress the data of the records started after this call with zlib (FLAG_Compressed), unless that
+        /// does not make them smaller. The TES3 header is never compressed.
+        /// \param level zlib compression level from 1 (fastest) to 9 (smallest), 0 disables compression.
+        /// \note Only applies to saved games of format SavedGame::sCompressedRecordsFormat and later, older readers
+        /// can not read compressed records.
+        void setCompression (int level);
+
+        /// Copy a file written without compression to \a out, compressing its records like setCompression() does.
+        /// Allows the compression to run separately from writing the records, e.g. on another thread.
+        /// \param in The file, from its TES3 header to its end.
+        /// \note The file must be a saved game of format SavedGame::sCompressedRecordsFormat or later.
+        static void compressRecords (std::istream& in, int level, std::ostream& out);
+
         void clearMaster();
 
         void addMaster(const std::string& name, uint64_t size);
@@ -127,8 +141,15 @@ public:
         void write(const char* data, size_t size);
 
     private:
+        /// Replace the data of the record \a rec, written to mRecordBuffer, with its compressed form.
+        void writeCompressedRecord(RecordData& rec);
+
         std::list<RecordData> mRecords;
         std::ostream* mStream;
+        // The output stream while mStream points to mRecordBuffer
+        std::ostream* mFileStream;
+        std::ostringstream mRecordBuffer;
+        int mCompression;
         std::streampos mHeaderPos;
         ToUTF8::Utf8Encoder* mEncoder;
         int mRecordCount;
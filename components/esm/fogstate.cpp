@@ -7,17 +7,20 @@ void ESM::FogState::load (ESMReader &esm)
 {
     esm.getHNOT(mBounds, "BOUN");
     esm.getHNOT(mNorthMarkerAngle, "ANGL");
-    while (esm.isNextSub("FTEX"))
+    while (esm.peekNextSub("FTEX") || esm.peekNextSub("FRAW"))
     {
+        esm.getSubName();
         esm.getSubHeader();
         FogTexture tex;
+        tex.mRaw = esm.retSubName() == "FRAW";
 
         esm.getT(tex.mX);
         esm.getT(tex.mY);
 
         size_t imageSize = esm.getSubSize()-sizeof(int)*2;
         tex.mImageData.resize(imageSize);
-        esm.getExact(&tex.mImageData[0], imageSize);
+        if (imageSize)
+            esm.getExact(&tex.mImageData[0], imageSize);
         mFogTextures.push_back(tex);
     }
 }
@@ -31,10 +34,12 @@ void ESM::FogState::save (ESMWriter &esm, bool interiorCell) const
     }
     for (std::vector<FogTexture>::const_iterator it = mFogTextures.begin(); it != mFogTextures.end(); ++it)
     {
-        esm.startSubRecord("FTEX");
+        const char* name = it->mRaw ? "FRAW" : "FTEX";
+        esm.startSubRecord(name);
         esm.writeT(it->mX);
         esm.writeT(it->mY);
-        esm.write(&it->mImageData[0], it->mImageData.size());
-        esm.endRecord("FTEX");
+        if (!it->mImageData.empty())
+            esm.write(&it->mImageData[0], it->mImageData.size());
+        esm.endRecord(name);
     }
 }
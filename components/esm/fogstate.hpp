@@ -12,6 +12,7 @@ namespace ESM
     {
         int mX, mY; // Only used for interior cells
         std::vector<char> mImageData;
+        bool mRaw; // mImageData holds the alpha channel of the fog as is, rather than a TGA image
     };
 
     // format 0, saved games only
@@ -17,6 +17,9 @@ namespace ESM
 
         static int sCurrentFormat;
 
+        /// First format that may contain compressed records, see ESMWriter::setCompression()
+        static const int sCompressedRecordsFormat = 6;
+
         struct TimeStamp
         {
             float mGameHour;
@@ -0,0 +1,150 @@
+#include "mappedfile.hpp"
+
+#include <stdexcept>
+#include <sstream>
+
+#if FILE_API == FILE_API_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+namespace Files
+{
+
+#if FILE_API == FILE_API_POSIX
+
+    MappedFile::MappedFile(const std::string &filename)
+        : mData(NULL)
+        , mSize(0)
+    {
+        int handle = ::open(filename.c_str(), O_RDONLY);
+        if (handle == -1)
+        {
+            std::ostringstream os;
+            os << "Failed to open '" << filename << "' for reading: " << strerror(errno);
+            throw std::runtime_error(os.str());
+        }
+
+        struct stat status;
+        if (::fstat(handle, &status) == -1)
+        {
+            ::close(handle);
+            std::ostringstream os;
+            os << "Failed to query size of '" << filename << "': " << strerror(errno);
+            throw std::runtime_error(os.str());
+        }
+
+        mSize = status.st_size;
+        if (mSize == 0)
+        {
+            ::close(handle);
+            return;
+        }
+
+        void* data = ::mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, handle, 0);
+        // The mapping keeps its own reference to the file
+        ::close(handle);
+
+        if (data == MAP_FAILED)
+        {
+            std::ostringstream os;
+            os << "Failed to map '" << filename << "' into memory: " << strerror(errno);
+            throw std::runtime_error(os.str());
+        }
+
+        mData = static_cast<const char*>(data);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData)
+            ::munmap(const_cast<char*>(mData), mSize);
+    }
+
+#elif FILE_API == FILE_API_WIN32
+
+    MappedFile::MappedFile(const std::string &filename)
+        : mData(NULL)
+        , mSize(0)
+        , mFileHandle(INVALID_HANDLE_VALUE)
+        , mMappingHandle(NULL)
+    {
+        mFileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+        if (mFileHandle == INVALID_HANDLE_VALUE)
+        {
+            std::ostringstream os;
+            os << "Failed to open '" << filename << "' for reading.";
+            throw std::runtime_error(os.str());
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFileHandle, &size))
+        {
+            CloseHandle(mFileHandle);
+            throw std::runtime_error("Failed to query size of '" + filename + "'.");
+        }
+
+        mSize = static_cast<size_t>(size.QuadPart);
+        if (mSize == 0)
+            return;
+
+        mMappingHandle = CreateFileMappingA(mFileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mMappingHandle != NULL)
+            mData = static_cast<const char*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+        if (!mData)
+        {
+            if (mMappingHandle != NULL)
+                CloseHandle(mMappingHandle);
+            CloseHandle(mFileHandle);
+            throw std::runtime_error("Failed to map '" + filename + "' into memory.");
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (mData)
+            UnmapViewOfFile(mData);
+        if (mMappingHandle != NULL)
+            CloseHandle(mMappingHandle);
+        if (mFileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(mFileHandle);
+    }
+
+#else
+
+    MappedFile::MappedFile(const std::string &filename)
+        : mData(NULL)
+        , mSize(0)
+    {
+        throw std::runtime_error("Failed to map '" + filename + "' into memory: not supported on this platform");
+    }
+
+    MappedFile::~MappedFile()
+    {
+    }
+
+#endif
+
+    MappedFileStream::MappedFileStream(std::shared_ptr<const MappedFile> file, size_t start, size_t length)
+        : MemBuf(file->getData() + start, length)
+        , IMemStream(file->getData() + start, length)
+        , mFile(file)
+        , mData(file->getData() + start)
+        , mSize(length)
+    {
+        if (start + length > file->getSize())
+            throw std::runtime_error("Mapped file region is out of bounds");
+    }
+
+    const MappedFileStream* getMappedData(const std::istream &stream)
+    {
+        return dynamic_cast<const MappedFileStream*>(&stream);
+    }
+
+}
@@ -0,0 +1,63 @@
+#ifndef OPENMW_COMPONENTS_FILES_MAPPEDFILE_H
+#define OPENMW_COMPONENTS_FILES_MAPPEDFILE_H
+
+#include <memory>
+#include <string>
+
+#include "lowlevelfile.hpp"
+#include "memorystream.hpp"
+
+namespace Files
+{
+
+    /// @brief A file mapped read-only into the address space of the process.
+    /// @note Throws an exception if the file can not be opened or mapped, or if the platform has no support for memory mapping.
+    class MappedFile
+    {
+    public:
+        MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        const char* getData() const { return mData; }
+
+        size_t getSize() const { return mSize; }
+
+    private:
+        MappedFile(const MappedFile&);
+        MappedFile& operator=(const MappedFile&);
+
+        const char* mData;
+        size_t mSize;
+
+#if FILE_API == FILE_API_WIN32
+        HANDLE mFileHandle;
+        HANDLE mMappingHandle;
+#endif
+    };
+
+    /// @brief A read-only stream over a region of a memory-mapped file. Reading does not involve any system calls.
+    /// @par Parsers that know about this class may bypass the stream entirely and read straight from getData(),
+    /// see getMappedData().
+    class MappedFileStream : public IMemStream
+    {
+    public:
+        MappedFileStream(std::shared_ptr<const MappedFile> file, size_t start, size_t length);
+
+        /// Pointer to the start of the region. Remains valid as long as this stream exists.
+        const char* getData() const { return mData; }
+
+        size_t getSize() const { return mSize; }
+
+    private:
+        std::shared_ptr<const MappedFile> mFile;
+        const char* mData;
+        size_t mSize;
+    };
+
+    /// Get direct access to the data behind the given stream, if it is backed by a memory-mapped file.
+    /// @return NULL if the stream is not a MappedFileStream.
+    const MappedFileStream* getMappedData(const std::istream& stream);
+
+}
+
+#endif
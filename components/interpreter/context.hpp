@@ -49,6 +49,19 @@ namespace Interpreter
 
             virtual void setGlobalFloat (const std::string& name, float value) = 0;
 
+            virtual int getGlobalShort (int slot) const = 0;
+            ///< \param slot As returned by Compiler::Context::getGlobalSlot.
+
+            virtual int getGlobalLong (int slot) const = 0;
+
+            virtual float getGlobalFloat (int slot) const = 0;
+
+            virtual void setGlobalShort (int slot, int value) = 0;
+
+            virtual void setGlobalLong (int slot, int value) = 0;
+
+            virtual void setGlobalFloat (int slot, float value) = 0;
+
             virtual std::vector<std::string> getGlobals () const = 0;
 
             virtual char getGlobalType (const std::string& name) const = 0;
@@ -109,6 +122,19 @@ namespace Interpreter
             virtual void setMemberFloat (const std::string& id, const std::string& name, float value, bool global)
                 = 0;
 
+            virtual int getMemberShort (const std::string& id, int index, bool global) const = 0;
+            ///< \param index As returned by Compiler::Context::getMemberIndex.
+
+            virtual int getMemberLong (const std::string& id, int index, bool global) const = 0;
+
+            virtual float getMemberFloat (const std::string& id, int index, bool global) const = 0;
+
+            virtual void setMemberShort (const std::string& id, int index, int value, bool global) = 0;
+
+            virtual void setMemberLong (const std::string& id, int index, int value, bool global) = 0;
+
+            virtual void setMemberFloat (const std::string& id, int index, float value, bool global) = 0;
+
             virtual std::string getTargetId() const = 0;
     };
 }
@@ -51,6 +51,24 @@ namespace Interpreter
         interpreter.installSegment5 (68, new OpFetchMemberShort (true));
         interpreter.installSegment5 (69, new OpFetchMemberLong (true));
         interpreter.installSegment5 (70, new OpFetchMemberFloat (true));
+        interpreter.installSegment5 (72, new OpStoreGlobalShortSlot);
+        interpreter.installSegment5 (73, new OpStoreGlobalLongSlot);
+        interpreter.installSegment5 (74, new OpStoreGlobalFloatSlot);
+        interpreter.installSegment5 (75, new OpFetchGlobalShortSlot);
+        interpreter.installSegment5 (76, new OpFetchGlobalLongSlot);
+        interpreter.installSegment5 (77, new OpFetchGlobalFloatSlot);
+        interpreter.installSegment5 (78, new OpStoreMemberShortIndex (false));
+        interpreter.installSegment5 (79, new OpStoreMemberLongIndex (false));
+        interpreter.installSegment5 (80, new OpStoreMemberFloatIndex (false));
+        interpreter.installSegment5 (81, new OpFetchMemberShortIndex (false));
+        interpreter.installSegment5 (82, new OpFetchMemberLongIndex (false));
+        interpreter.installSegment5 (83, new OpFetchMemberFloatIndex (false));
+        interpreter.installSegment5 (84, new OpStoreMemberShortIndex (true));
+        interpreter.installSegment5 (85, new OpStoreMemberLongIndex (true));
+        interpreter.installSegment5 (86, new OpStoreMemberFloatIndex (true));
+        interpreter.installSegment5 (87, new OpFetchMemberShortIndex (true));
+        interpreter.installSegment5 (88, new OpFetchMemberLongIndex (true));
+        interpreter.installSegment5 (89, new OpFetchMemberFloatIndex (true));
 
         // math
         interpreter.installSegment5 (9, new OpAddInt<Type_Integer>);
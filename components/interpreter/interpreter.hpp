@@ -3,9 +3,11 @@
 
 #include <map>
 #include <stack>
+#include <utility>
 
 #include "runtime.hpp"
 #include "types.hpp"
+#include "opcodetable.hpp"
 
 namespace Interpreter
 {
@@ -15,15 +17,24 @@ namespace Interpreter
 
     class Interpreter
     {
+        public:
+
+            typedef std::map<std::pair<int, int>, unsigned long> OpcodeCounts;
+            ///< Number of executions by segment and opcode.
+
+        private:
+
             std::stack<Runtime> mCallstack;
             bool mRunning;
             Runtime mRuntime;
-            std::map<int, Opcode1 *> mSegment0;
-            std::map<int, Opcode2 *> mSegment1;
-            std::map<int, Opcode1 *> mSegment2;
-            std::map<int, Opcode1 *> mSegment3;
-            std::map<int, Opcode2 *> mSegment4;
-            std::map<int, Opcode0 *> mSegment5;
+            OpcodeTable<Opcode1> mSegment0;
+            OpcodeTable<Opcode2> mSegment1;
+            OpcodeTable<Opcode1> mSegment2;
+            OpcodeTable<Opcode1> mSegment3;
+            OpcodeTable<Opcode2> mSegment4;
+            OpcodeTable<Opcode0> mSegment5;
+            bool mCountOpcodes;
+            OpcodeCounts mOpcodeCounts;
 
             // not implemented
             Interpreter (const Interpreter&);
@@ -33,6 +44,8 @@ namespace Interpreter
 
             void abortUnknownCode (int segment, int opcode);
 
+            void countOpcode (int segment, int opcode);
+
             void abortUnknownSegment (Type_Code code);
 
             void begin();
@@ -63,7 +76,17 @@ namespace Interpreter
             void installSegment5 (int code, Opcode0 *opcode);
             ///< ownership of \a opcode is transferred to *this.
 
-            void run (const Type_Code *code, int codeSize, Context& context);
+            int run (const Type_Code *code, int codeSize, Context& context);
+            ///< \return Number of instructions executed.
+
+            void setCountOpcodes (bool enable);
+            ///< Count the executions of each opcode (off by default, because it slows down execution).
+
+            bool getCountOpcodes() const;
+
+            const OpcodeCounts& getOpcodeCounts() const;
+
+            void clearOpcodeCounts();
     };
 }
 
@@ -206,6 +206,90 @@ namespace Interpreter
             }
     };
 
+    class OpStoreGlobalShortSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer data = runtime[0].mInteger;
+                int slot = runtime[1].mInteger;
+
+                runtime.getContext().setGlobalShort (slot, data);
+
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpStoreGlobalLongSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer data = runtime[0].mInteger;
+                int slot = runtime[1].mInteger;
+
+                runtime.getContext().setGlobalLong (slot, data);
+
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpStoreGlobalFloatSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Float data = runtime[0].mFloat;
+                int slot = runtime[1].mInteger;
+
+                runtime.getContext().setGlobalFloat (slot, data);
+
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpFetchGlobalShortSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                int slot = runtime[0].mInteger;
+                Type_Integer value = runtime.getContext().getGlobalShort (slot);
+                runtime[0].mInteger = value;
+            }
+    };
+
+    class OpFetchGlobalLongSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                int slot = runtime[0].mInteger;
+                Type_Integer value = runtime.getContext().getGlobalLong (slot);
+                runtime[0].mInteger = value;
+            }
+    };
+
+    class OpFetchGlobalFloatSlot : public Opcode0
+    {
+        public:
+
+            virtual void execute (Runtime& runtime)
+            {
+                int slot = runtime[0].mInteger;
+                Type_Float value = runtime.getContext().getGlobalFloat (slot);
+                runtime[0].mFloat = value;
+            }
+    };
+
     class OpStoreMemberShort : public Opcode0
     {
             bool mGlobal;
@@ -340,6 +424,135 @@ namespace Interpreter
                 runtime[0].mFloat = value;
             }
     };
+
+    class OpStoreMemberShortIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpStoreMemberShortIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer data = runtime[0].mInteger;
+                Type_Integer index = runtime[1].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[2].mInteger;
+
+                runtime.getContext().setMemberShort (id, index, data, mGlobal);
+
+                runtime.pop();
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpStoreMemberLongIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpStoreMemberLongIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer data = runtime[0].mInteger;
+                Type_Integer index = runtime[1].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[2].mInteger;
+
+                runtime.getContext().setMemberLong (id, index, data, mGlobal);
+
+                runtime.pop();
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpStoreMemberFloatIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpStoreMemberFloatIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Float data = runtime[0].mFloat;
+                Type_Integer index = runtime[1].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[2].mInteger;
+
+                runtime.getContext().setMemberFloat (id, index, data, mGlobal);
+
+                runtime.pop();
+                runtime.pop();
+                runtime.pop();
+            }
+    };
+
+    class OpFetchMemberShortIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpFetchMemberShortIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer index = runtime[0].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[1].mInteger;
+                runtime.pop();
+
+                int value = runtime.getContext().getMemberShort (id, index, mGlobal);
+                runtime[0].mInteger = value;
+            }
+    };
+
+    class OpFetchMemberLongIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpFetchMemberLongIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer index = runtime[0].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[1].mInteger;
+                runtime.pop();
+
+                int value = runtime.getContext().getMemberLong (id, index, mGlobal);
+                runtime[0].mInteger = value;
+            }
+    };
+
+    class OpFetchMemberFloatIndex : public Opcode0
+    {
+            bool mGlobal;
+
+        public:
+
+            OpFetchMemberFloatIndex (bool global) : mGlobal (global) {}
+
+            virtual void execute (Runtime& runtime)
+            {
+                Type_Integer index = runtime[0].mInteger;
+                std::string id = runtime.getStringLiteral (index);
+                index = runtime[1].mInteger;
+                runtime.pop();
+
+                float value = runtime.getContext().getMemberFloat (id, index, mGlobal);
+                runtime[0].mFloat = value;
+            }
+    };
 }
 
 #endif
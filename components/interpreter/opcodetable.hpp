@@ -0,0 +1,74 @@
+#ifndef INTERPRETER_OPCODETABLE_H_INCLUDED
+#define INTERPRETER_OPCODETABLE_H_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+namespace Interpreter
+{
+    /// @brief Dispatch table from the opcodes of one segment to their implementations.
+    /// @par Opcodes are looked up by indexing instead of searching. The table is split into pages of
+    /// 4096 opcodes, which are only allocated once an opcode within them is installed, because the
+    /// extension opcodes of some segments start far beyond the builtin ones.
+    /// @note Owns the installed opcodes.
+    template<typename T>
+    class OpcodeTable
+    {
+            enum
+            {
+                PageBits = 12,
+                PageSize = 1 << PageBits
+            };
+
+            std::vector<std::vector<T *> > mPages;
+
+            // not implemented
+            OpcodeTable (const OpcodeTable&);
+            OpcodeTable& operator= (const OpcodeTable&);
+
+        public:
+
+            OpcodeTable() {}
+
+            ~OpcodeTable()
+            {
+                for (typename std::vector<std::vector<T *> >::iterator page (mPages.begin());
+                    page!=mPages.end(); ++page)
+                    for (typename std::vector<T *>::iterator iter (page->begin()); iter!=page->end(); ++iter)
+                        delete *iter;
+            }
+
+            /// \return 0, if no opcode is installed for \a code.
+            T *find (unsigned int code) const
+            {
+                std::size_t page = code>>PageBits;
+
+                if (page>=mPages.size() || mPages[page].empty())
+                    return 0;
+
+                return mPages[page][code & (PageSize-1)];
+            }
+
+            /// \return Was \a code still free? If not, the table is left unchanged.
+            bool insert (unsigned int code, T *opcode)
+            {
+                std::size_t page = code>>PageBits;
+
+                if (page>=mPages.size())
+                    mPages.resize (page+1);
+
+                if (mPages[page].empty())
+                    mPages[page].resize (PageSize, 0);
+
+                T *& slot = mPages[page][code & (PageSize-1)];
+
+                if (slot)
+                    return false;
+
+                slot = opcode;
+                return true;
+            }
+    };
+}
+
+#endif
@@ -29,6 +29,11 @@ namespace Loading
         virtual void setProgress (size_t value) {}
         /// Increase current progress, default by 1.
         virtual void increaseProgress (size_t increase = 1) {}
+
+        /// Report how long a stage of the loading process took, for profiling.
+        /// @param stage Description of the stage, e.g. "Merged Morrowind.esm"
+        /// @param milliseconds Time taken by the stage
+        virtual void reportTime (const std::string& stage, double milliseconds) {}
     };
 
     /// @brief Used for stopping a loading sequence when the object goes out of scope
@@ -0,0 +1,54 @@
+#include "arena.hpp"
+
+#include <stdint.h>
+
+namespace Nif
+{
+
+Arena::Arena(size_t blockSize)
+    : mPos(NULL)
+    , mEnd(NULL)
+    , mBlockSize(blockSize)
+    , mNumAllocations(0)
+    , mBytesAllocated(0)
+    , mBlockBytes(0)
+{
+}
+
+Arena::~Arena()
+{
+    for (std::vector<char*>::iterator it = mBlocks.begin(); it != mBlocks.end(); ++it)
+        delete[] *it;
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    ++mNumAllocations;
+    mBytesAllocated += size;
+
+    // Large objects get a block of their own, so that they don't waste the rest of the current block
+    if (size + alignment > mBlockSize / 4)
+    {
+        char* block = new char[size + alignment];
+        mBlocks.push_back(block);
+        mBlockBytes += size + alignment;
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~uintptr_t(alignment - 1);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(mPos) + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (!mPos || aligned + size > reinterpret_cast<uintptr_t>(mEnd))
+    {
+        char* block = new char[mBlockSize];
+        mBlocks.push_back(block);
+        mBlockBytes += mBlockSize;
+        mPos = block;
+        mEnd = block + mBlockSize;
+        aligned = (reinterpret_cast<uintptr_t>(mPos) + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+
+    mPos = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+}
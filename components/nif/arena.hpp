@@ -0,0 +1,116 @@
+#ifndef OPENMW_COMPONENTS_NIF_ARENA_HPP
+#define OPENMW_COMPONENTS_NIF_ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Nif
+{
+
+/// @brief Allocates memory for many small objects out of large blocks, and releases all of it at once when destroyed.
+/// @note Does not call destructors, the owner of the objects has to do that before the arena goes away.
+class Arena
+{
+public:
+    /// @param blockSize Size of the blocks that are split up between allocations.
+    Arena(size_t blockSize = 32*1024);
+    ~Arena();
+
+    /// Get uninitialized memory of the given size and alignment. Remains valid until the arena is destroyed.
+    void* allocate(size_t size, size_t alignment);
+
+    /// Number of allocations made from the arena, for records and their arrays
+    size_t getNumAllocations() const { return mNumAllocations; }
+
+    /// Number of blocks requested from the heap, for all allocations
+    size_t getNumBlocks() const { return mBlocks.size(); }
+
+    /// Sum of the size of all allocations, in bytes
+    size_t getBytesAllocated() const { return mBytesAllocated; }
+
+    /// Sum of the size of all blocks, in bytes
+    size_t getBlockBytes() const { return mBlockBytes; }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    std::vector<char*> mBlocks;
+    char* mPos;
+    char* mEnd;
+    size_t mBlockSize;
+    size_t mNumAllocations;
+    size_t mBytesAllocated;
+    size_t mBlockBytes;
+};
+
+/// @brief Allocator for standard containers that takes their memory from an Arena, or from the heap if it has none.
+/// @par Memory from the arena is only released with the arena. Copies of a container get an allocator without arena,
+/// so that containers read from a shared file can be copied on any thread. Moving a container moves its allocator along,
+/// which allows replacing a container with one that allocates from an arena.
+template <class T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator(Arena* arena = NULL)
+        : mArena(arena)
+    {
+    }
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : mArena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (mArena)
+            return static_cast<T*>(mArena->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t)
+    {
+        if (!mArena)
+            ::operator delete(ptr);
+    }
+
+    ArenaAllocator select_on_container_copy_construction() const
+    {
+        return ArenaAllocator();
+    }
+
+    Arena* getArena() const { return mArena; }
+
+private:
+    Arena* mArena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.getArena() != b.getArena();
+}
+
+/// Array of a record, allocated from the Arena of its NIFFile, see NIFStream.
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T> >;
+
+}
+
+#endif
@@ -35,9 +35,9 @@ namespace Nif
 class ShapeData : public Record
 {
 public:
-    std::vector<osg::Vec3f> vertices, normals;
-    std::vector<osg::Vec4f> colors;
-    std::vector< std::vector<osg::Vec2f> > uvlist;
+    ArenaVector<osg::Vec3f> vertices, normals;
+    ArenaVector<osg::Vec4f> colors;
+    std::vector< ArenaVector<osg::Vec2f> > uvlist;
     osg::Vec3f center;
     float radius;
 
@@ -48,7 +48,7 @@ class NiTriShapeData : public ShapeData
 {
 public:
     // Triangles, three vertex indices per triangle
-    std::vector<unsigned short> triangles;
+    ArenaVector<unsigned short> triangles;
 
     void read(NIFStream *nif);
 };
@@ -62,7 +62,7 @@ public:
 
     int activeCount;
 
-    std::vector<float> sizes;
+    ArenaVector<float> sizes;
 
     void read(NIFStream *nif);
 };
@@ -70,7 +70,7 @@ public:
 class NiRotatingParticlesData : public NiAutoNormalParticlesData
 {
 public:
-    std::vector<osg::Quat> rotations;
+    ArenaVector<osg::Quat> rotations;
 
     void read(NIFStream *nif);
 };
@@ -187,7 +187,7 @@ struct NiMorphData : public Record
 {
     struct MorphData {
         FloatKeyMapPtr mKeyFrames;
-        std::vector<osg::Vec3f> mVertices;
+        ArenaVector<osg::Vec3f> mVertices;
     };
     std::vector<MorphData> mMorphs;
 
@@ -2,6 +2,7 @@
 #include "effect.hpp"
 
 #include <map>
+#include <new>
 #include <sstream>
 
 namespace Nif
@@ -12,23 +13,45 @@ NIFFile::NIFFile(Files::IStreamPtr stream, const std::string &name)
     : ver(0)
     , filename(name)
     , mUseSkinning(false)
+    , mSize(0)
 {
-    parse(stream);
+    try
+    {
+        parse(stream);
+    }
+    catch (...)
+    {
+        // the destructor won't run, so clean up the records that were read so far
+        destroyRecords();
+        throw;
+    }
 }
 
 NIFFile::~NIFFile()
 {
+    destroyRecords();
+}
+
+void NIFFile::destroyRecords()
+{
+    // the memory itself is released by the arena
     for (std::vector<Record*>::iterator it = records.begin() ; it != records.end(); ++it)
     {
-        delete *it;
+        if (*it)
+            (*it)->~Record();
     }
+    records.clear();
+    roots.clear();
 }
 
-template <typename NodeType> static Record* construct() { return new NodeType; }
+template <typename NodeType> static Record* construct(Arena& arena)
+{
+    return new (arena.allocate(sizeof(NodeType), alignof(NodeType))) NodeType;
+}
 
 struct RecordFactoryEntry {
 
-    typedef Record* (*create_t) ();
+    typedef Record* (*create_t) (Arena&);
 
     create_t        mCreate;
     RecordType      mType;
@@ -36,7 +59,7 @@ struct RecordFactoryEntry {
 };
 
 ///Helper function for adding records to the factory map
-static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (), RecordType type)
+static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName, Record* (*create_t) (Arena&), RecordType type)
 {
     RecordFactoryEntry anEntry = {create_t,type};
     return std::make_pair(recName, anEntry);
@@ -137,6 +160,7 @@ std::string NIFFile::printVersion(unsigned int version)
 void NIFFile::parse(Files::IStreamPtr stream)
 {
     NIFStream nif (this, stream);
+    mSize = nif.size();
 
     // Check the header string
     std::string head = nif.getVersionString();
@@ -176,7 +200,7 @@ void NIFFile::parse(Files::IStreamPtr stream)
 
         if (entry != factories.end())
         {
-            r = entry->second.mCreate ();
+            r = entry->second.mCreate (mArena);
             r->recType = entry->second.mType;
         }
         else
@@ -10,6 +10,7 @@
 #include <components/files/constrainedfilestream.hpp>
 
 #include "record.hpp"
+#include "arena.hpp"
 
 namespace Nif
 {
@@ -26,6 +27,9 @@ class NIFFile
     /// File name, used for error messages and opening the file
     std::string filename;
 
+    /// Memory of the records, released together with the file
+    Arena mArena;
+
     /// Record list
     std::vector<Record*> records;
 
@@ -34,9 +38,15 @@ class NIFFile
 
     bool mUseSkinning;
 
+    /// Size of the file in bytes
+    size_t mSize;
+
     /// Parse the file
     void parse(Files::IStreamPtr stream);
 
+    /// Call the destructors of the records, their memory stays with the arena
+    void destroyRecords();
+
     /// Get the file's version in a human readable form
     ///\returns A string containing a human readable NIF version number
     std::string printVersion(unsigned int version);
@@ -74,6 +84,14 @@ public:
     /// Number of records
     size_t numRecords() const { return records.size(); }
 
+    /// Size of the file in bytes
+    size_t getSize() const { return mSize; }
+
+    /// Allocator of the records and their arrays
+    Arena& getArena() { return mArena; }
+    /// Allocator of the records and their arrays, for reporting its usage
+    const Arena& getArena() const { return mArena; }
+
     /// Get a given root
     Record *getRoot(size_t index=0) const
     {
@@ -6,7 +6,8 @@
 #include "nifstream.hpp"
 
 #include <sstream>
-#include <map>
+#include <vector>
+#include <algorithm>
 
 #include "niffile.hpp"
 
@@ -16,25 +17,21 @@ namespace Nif
 template<typename T>
 struct KeyT {
     T mValue;
-
-    // FIXME: Implement Quadratic and TBC interpolation
-    /*
     T mForwardValue;  // Only for Quadratic interpolation, and never for QuaternionKeyList
     T mBackwardValue; // Only for Quadratic interpolation, and never for QuaternionKeyList
     float mTension;    // Only for TBC interpolation
     float mBias;       // Only for TBC interpolation
     float mContinuity; // Only for TBC interpolation
-    */
 };
 typedef KeyT<float> FloatKey;
 typedef KeyT<osg::Vec3f> Vector3Key;
 typedef KeyT<osg::Vec4f> Vector4Key;
 typedef KeyT<osg::Quat> QuaternionKey;
 
+/// A keyframe track. The keys are stored as separate, contiguous arrays of times and values (sorted by time),
+/// so that finding the keys around a time only needs to search the times.
 template<typename T, T (NIFStream::*getValue)()>
 struct KeyMapT {
-    typedef std::map< float, KeyT<T> > MapType;
-
     typedef T ValueType;
     typedef KeyT<T> KeyType;
 
@@ -44,10 +41,20 @@ struct KeyMapT {
     static const unsigned int sXYZInterpolation = 4;
 
     unsigned int mInterpolationType;
-    MapType mKeys;
+
+    std::vector<float> mTimes;
+    std::vector<T> mValues;
+
+    // Hermite tangents of the keys, towards the previous key (mInTangents) and the next key (mOutTangents).
+    // Only set for Quadratic and TBC interpolation, and never for QuaternionKeyList.
+    std::vector<T> mInTangents;
+    std::vector<T> mOutTangents;
 
     KeyMapT() : mInterpolationType(sLinearInterpolation) {}
 
+    bool empty() const { return mTimes.empty(); }
+    size_t size() const { return mTimes.size(); }
+
     //Read in a KeyGroup (see http://niftools.sourceforge.net/doc/nif/NiKeyframeData.html)
     void read(NIFStream *nif, bool force=false)
     {
@@ -59,38 +66,41 @@ struct KeyMapT {
         if(count == 0 && !force)
             return;
 
-        mKeys.clear();
+        mTimes.clear();
+        mValues.clear();
+        mInTangents.clear();
+        mOutTangents.clear();
 
         mInterpolationType = nif->getUInt();
 
-        KeyT<T> key;
+        std::vector<std::pair<float, KeyType> > keys;
         NIFStream &nifReference = *nif;
 
         if(mInterpolationType == sLinearInterpolation)
         {
+            keys.resize(count);
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
-                readValue(nifReference, key);
-                mKeys[time] = key;
+                keys[i].first = nif->getFloat();
+                readValue(nifReference, keys[i].second);
             }
         }
         else if(mInterpolationType == sQuadraticInterpolation)
         {
+            keys.resize(count);
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
-                readQuadratic(nifReference, key);
-                mKeys[time] = key;
+                keys[i].first = nif->getFloat();
+                readQuadratic(nifReference, keys[i].second);
             }
         }
         else if(mInterpolationType == sTBCInterpolation)
         {
+            keys.resize(count);
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
-                readTBC(nifReference, key);
-                mKeys[time] = key;
+                keys[i].first = nif->getFloat();
+                readTBC(nifReference, keys[i].second);
             }
         }
         //XYZ keys aren't actually read here.
@@ -120,9 +130,118 @@ struct KeyMapT {
             error << "Unhandled interpolation type: " << mInterpolationType;
             nif->file->fail(error.str());
         }
+
+        setKeys(keys);
     }
 
 private:
+    static bool compareTime(const std::pair<float, KeyType>& a, const std::pair<float, KeyType>& b)
+    {
+        return a.first < b.first;
+    }
+
+    void setKeys(std::vector<std::pair<float, KeyType> >& keys)
+    {
+        // Keys are normally stored in order. Otherwise sort them, where a later key replaces an earlier
+        // key of the same time.
+        bool sorted = true;
+        for (size_t i = 1; i < keys.size() && sorted; ++i)
+            sorted = keys[i-1].first < keys[i].first;
+        if (!sorted)
+        {
+            std::stable_sort(keys.begin(), keys.end(), compareTime);
+            size_t last = 0;
+            for (size_t i = 1; i < keys.size(); ++i)
+            {
+                if (keys[i].first != keys[last].first)
+                    ++last;
+                keys[last] = keys[i];
+            }
+            keys.resize(last+1);
+        }
+
+        mTimes.resize(keys.size());
+        mValues.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            mTimes[i] = keys[i].first;
+            mValues[i] = keys[i].second.mValue;
+        }
+
+        if (mInterpolationType == sQuadraticInterpolation)
+            setQuadraticTangents(keys);
+        else if (mInterpolationType == sTBCInterpolation)
+            setTBCTangents(keys);
+    }
+
+    template <typename U>
+    void setQuadraticTangents(const std::vector<std::pair<float, KeyT<U> > >& keys)
+    {
+        mInTangents.resize(keys.size());
+        mOutTangents.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            mInTangents[i] = keys[i].second.mBackwardValue;
+            mOutTangents[i] = keys[i].second.mForwardValue;
+        }
+    }
+
+    void setQuadraticTangents(const std::vector<std::pair<float, KeyT<osg::Quat> > >& keys)
+    {
+    }
+
+    /// Convert the tension, continuity and bias of the keys into Hermite tangents (Kochanek-Bartels splines).
+    /// The tangents are scaled to the length of the segment they are used for, the first and last keys use
+    /// the difference to their only neighbour.
+    template <typename U>
+    void setTBCTangents(const std::vector<std::pair<float, KeyT<U> > >& keys)
+    {
+        mInTangents.resize(keys.size());
+        mOutTangents.resize(keys.size());
+        if (keys.size() < 2)
+        {
+            if (!keys.empty())
+                mInTangents[0] = mOutTangents[0] = U();
+            return;
+        }
+
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            const KeyT<U>& key = keys[i].second;
+            if (i == 0)
+            {
+                mInTangents[i] = mOutTangents[i] = keys[i+1].second.mValue - key.mValue;
+                continue;
+            }
+            if (i == keys.size()-1)
+            {
+                mInTangents[i] = mOutTangents[i] = key.mValue - keys[i-1].second.mValue;
+                continue;
+            }
+
+            const U prevDelta = key.mValue - keys[i-1].second.mValue;
+            const U nextDelta = keys[i+1].second.mValue - key.mValue;
+            const float prevLength = keys[i].first - keys[i-1].first;
+            const float nextLength = keys[i+1].first - keys[i].first;
+
+            const float t = 1.f - key.mTension;
+            const float c = key.mContinuity;
+            const float b = key.mBias;
+
+            const U in = prevDelta * (t * (1.f - c) * (1.f + b) * 0.5f)
+                       + nextDelta * (t * (1.f + c) * (1.f - b) * 0.5f);
+            const U out = prevDelta * (t * (1.f + c) * (1.f + b) * 0.5f)
+                        + nextDelta * (t * (1.f - c) * (1.f - b) * 0.5f);
+
+            mInTangents[i] = in * (2.f * prevLength / (prevLength + nextLength));
+            mOutTangents[i] = out * (2.f * nextLength / (prevLength + nextLength));
+        }
+    }
+
+    void setTBCTangents(const std::vector<std::pair<float, KeyT<osg::Quat> > >& keys)
+    {
+    }
+
     static void readValue(NIFStream &nif, KeyT<T> &key)
     {
         key.mValue = (nif.*getValue)();
@@ -132,8 +251,8 @@ private:
     static void readQuadratic(NIFStream &nif, KeyT<U> &key)
     {
         readValue(nif, key);
-        /*key.mForwardValue = */(nif.*getValue)();
-        /*key.mBackwardValue = */(nif.*getValue)();
+        key.mForwardValue = (nif.*getValue)();
+        key.mBackwardValue = (nif.*getValue)();
     }
 
     static void readQuadratic(NIFStream &nif, KeyT<osg::Quat> &key)
@@ -144,9 +263,9 @@ private:
     static void readTBC(NIFStream &nif, KeyT<T> &key)
     {
         readValue(nif, key);
-        /*key.mTension = */nif.getFloat();
-        /*key.mBias = */nif.getFloat();
-        /*key.mContinuity = */nif.getFloat();
+        key.mTension = nif.getFloat();
+        key.mBias = nif.getFloat();
+        key.mContinuity = nif.getFloat();
     }
 };
 typedef KeyMapT<float,&NIFStream::getFloat> FloatKeyMap;
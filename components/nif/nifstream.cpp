@@ -1,4 +1,9 @@
 #include "nifstream.hpp"
+
+#include <sstream>
+
+#include <components/files/mappedfile.hpp>
+
 //For error reporting
 #include "niffile.hpp"
 
@@ -7,7 +12,73 @@ namespace Nif
 
 //Private functions
 
+void NIFStream::failReadPastEnd(size_t count, size_t elementSize) const
+{
+    std::stringstream error;
+    error << "Trying to read " << count;
+    if (elementSize != 1)
+        error << " elements of " << elementSize;
+    error << " bytes at offset " << (mPos - mStart) << " past the end of the file (" << (mEnd - mStart) << " bytes)";
+    file->fail(error.str());
+}
+
+Arena* NIFStream::getArena() const
+{
+    return &file->getArena();
+}
 
 //Public functions
 
+NIFStream::NIFStream(NIFFile *file, Files::IStreamPtr inp)
+    : inp(inp)
+    , mStart(NULL)
+    , mPos(NULL)
+    , mEnd(NULL)
+    , file(file)
+{
+    std::streamoff offset = inp->tellg();
+    if (offset < 0)
+        offset = 0;
+
+    // A memory-mapped file can be read in place
+    if (const Files::MappedFileStream* mapped = Files::getMappedData(*inp))
+    {
+        if (size_t(offset) > mapped->getSize())
+            offset = mapped->getSize();
+        mStart = mapped->getData() + offset;
+        mEnd = mapped->getData() + mapped->getSize();
+    }
+    else
+    {
+        // Otherwise, read the rest of the stream with as few calls as possible
+        inp->seekg(0, std::ios_base::end);
+        std::streamoff end = inp->tellg();
+        inp->clear();
+        if (end > offset)
+        {
+            inp->seekg(offset);
+            mBuffer.resize(size_t(end - offset));
+            inp->read(&mBuffer[0], mBuffer.size());
+            mBuffer.resize(size_t(inp->gcount()));
+        }
+        else
+        {
+            // Not seekable, read in chunks until the end
+            const size_t chunkSize = 65536;
+            size_t size = 0;
+            while (inp->good())
+            {
+                mBuffer.resize(size + chunkSize);
+                inp->read(&mBuffer[size], chunkSize);
+                size += size_t(inp->gcount());
+            }
+            mBuffer.resize(size);
+        }
+
+        mStart = mBuffer.data();
+        mEnd = mStart + mBuffer.size();
+    }
+    mPos = mStart;
+}
+
 }
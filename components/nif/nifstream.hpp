@@ -3,7 +3,9 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stdint.h>
 #include <stdexcept>
 #include <vector>
@@ -15,22 +17,22 @@
 #include <osg/Quat>
 
 #include "niftypes.hpp"
+#include "arena.hpp"
 
 namespace Nif
 {
 
 class NIFFile;
 
-/* 
+/*
     readLittleEndianBufferOfType: This template should only be used with non POD data types
 */
-template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(Files::IStreamPtr &pIStream, T* dest)
+template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(const char* src, T* dest)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     /*
         Due to the loop iterations being known at compile time,
         this nested loop will most likely be unrolled
@@ -44,7 +46,7 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
     {
         u = { 0 };
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= (((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
+            u.i |= (((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
         dest[i] = u.t;
     }
 #endif
@@ -53,13 +55,12 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
 /*
     readLittleEndianDynamicBufferOfType: This template should only be used with non POD data types
 */
-template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr &pIStream, T* dest, uint32_t numInstances)
+template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(const char* src, T* dest, uint32_t numInstances)
 {
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, src, numInstances * sizeof(T));
 #else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    const uint8_t* srcByteBuffer = (const uint8_t*)src;
     union {
         IntegerT i;
         T t;
@@ -68,79 +69,125 @@ template <typename T, typename IntegerT> inline void readLittleEndianDynamicBuff
     {
         u.i = 0;
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= ((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
+            u.i |= ((IntegerT)srcByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
         dest[i] = u.t;
     }
 #endif
 }
-template<typename type, typename IntegerT> type inline readLittleEndianType(Files::IStreamPtr &pIStream)
+template<typename type, typename IntegerT> type inline readLittleEndianType(const char* src)
 {
     type val;
-    readLittleEndianBufferOfType<1,type,IntegerT>(pIStream, (type*)&val);
+    readLittleEndianBufferOfType<1,type,IntegerT>(src, (type*)&val);
     return val;
 }
 
+/// Reads values from the contents of a NIF file, which are held in memory as a whole.
+/// Every read is checked against the end of the file, reading past it makes the file fail to load.
 class NIFStream {
 
-    /// Input stream
+    /// Input stream, holds on to the memory-mapped file if the data is read from one
     Files::IStreamPtr inp;
 
+    /// Contents of the input stream, unless it is memory-mapped
+    std::vector<char> mBuffer;
+
+    const char* mStart;
+    const char* mPos;
+    const char* mEnd;
+
+    /// Get the current position and move past the next \a size bytes
+    const char* read(size_t size)
+    {
+        if (size > size_t(mEnd - mPos))
+            failReadPastEnd(size);
+        const char* pos = mPos;
+        mPos += size;
+        return pos;
+    }
+
+    /// Get the current position and move past the next \a count elements of \a elementSize bytes each
+    /// @note Checked without multiplying, so that a corrupted count can not overflow
+    const char* readArray(size_t count, size_t elementSize)
+    {
+        if (count > size_t(mEnd - mPos) / elementSize)
+            failReadPastEnd(count, elementSize);
+        return read(count * elementSize);
+    }
+
+    void failReadPastEnd(size_t count, size_t elementSize = 1) const;
+
+    /// Arena of the file being read, which holds the arrays of its records
+    Arena* getArena() const;
+
+    /// Replace the contents of \a vec with \a size elements allocated from the arena
+    template <class T>
+    void allocateArray(ArenaVector<T> &vec, size_t size)
+    {
+        vec = ArenaVector<T>(size, ArenaAllocator<T>(getArena()));
+    }
+
+    NIFStream(const NIFStream&);
+    NIFStream& operator=(const NIFStream&);
+
 public:
 
     NIFFile * const file;
 
-    NIFStream (NIFFile * file, Files::IStreamPtr inp): inp (inp), file (file) {}
+    NIFStream (NIFFile * file, Files::IStreamPtr inp);
+
+    /// Size of the data to read in bytes
+    size_t size() const { return mEnd - mStart; }
 
-    void skip(size_t size) { inp->ignore(size); }
+    void skip(size_t size) { read(size); }
 
     char getChar() 
     {
-        return readLittleEndianType<char,char>(inp); 
+        return readLittleEndianType<char,char>(read(sizeof(char)));
     }
     short getShort() 
     { 
-        return readLittleEndianType<short,short>(inp);
+        return readLittleEndianType<short,short>(read(sizeof(short)));
     }
     unsigned short getUShort() 
     { 
-        return readLittleEndianType<unsigned short,unsigned short>(inp);
+        return readLittleEndianType<unsigned short,unsigned short>(read(sizeof(unsigned short)));
     }
     int getInt() 
     {
-        return readLittleEndianType<int,int>(inp);
+        return readLittleEndianType<int,int>(read(sizeof(int)));
     }
     unsigned int getUInt() 
     { 
-        return readLittleEndianType<unsigned int,unsigned int>(inp);
+        return readLittleEndianType<unsigned int,unsigned int>(read(sizeof(unsigned int)));
     }
     float getFloat() 
     { 
-        return readLittleEndianType<float,uint32_t>(inp);
+        return readLittleEndianType<float,uint32_t>(read(sizeof(float)));
     }
 
     osg::Vec2f getVector2() {
         osg::Vec2f vec;
-        readLittleEndianBufferOfType<2,float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<2,float,uint32_t>(read(2 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
     osg::Vec3f getVector3() {
         osg::Vec3f vec;
-        readLittleEndianBufferOfType<3, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<3, float,uint32_t>(read(3 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
     osg::Vec4f getVector4() {
         osg::Vec4f vec;
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readLittleEndianBufferOfType<4, float,uint32_t>(read(4 * sizeof(float)), (float*)&vec._v[0]);
         return vec;
     }
     Matrix3 getMatrix3() {
         Matrix3 mat;
-        readLittleEndianBufferOfType<9, float,uint32_t>(inp, (float*)&mat.mValues);
+        readLittleEndianBufferOfType<9, float,uint32_t>(read(9 * sizeof(float)), (float*)&mat.mValues);
         return mat;
     }
     osg::Quat getQuaternion() {
         float f[4];
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&f);
+        readLittleEndianBufferOfType<4, float,uint32_t>(read(4 * sizeof(float)), (float*)&f);
         osg::Quat quat;
         quat.w() = f[0];
         quat.x() = f[1];
@@ -158,49 +205,58 @@ public:
 
     ///Read in a string of the given length
     std::string getString(size_t length) {
-        std::vector<char> str(length + 1, 0);
-
-        inp->read(&str[0], length);
-
-        return &str[0];
+        const char* str = read(length);
+        // the string ends at the first null character, if there is one
+        return std::string(str, std::find(str, str + length, '\0'));
     }
     ///Read in a string of the length specified in the file
     std::string getString() {
-        size_t size = readLittleEndianType<uint32_t,uint32_t>(inp);
+        size_t size = readLittleEndianType<uint32_t,uint32_t>(read(sizeof(uint32_t)));
         return getString(size);
     }
     ///This is special since the version string doesn't start with a number, and ends with "\n"
     std::string getVersionString() {
-        std::string result;
-        std::getline(*inp, result);
+        const char* end = std::find(mPos, mEnd, '\n');
+        std::string result(mPos, end);
+        mPos = (end == mEnd) ? mEnd : end + 1;
         return result;
     }
 
-    void getUShorts(std::vector<unsigned short> &vec, size_t size) {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(inp, &vec.front(), size);
+    // The sizes are checked before allocating, so that a corrupted count fails cleanly.
+    // The arrays are allocated from the arena of the file, along with the records they belong to.
+    void getUShorts(ArenaVector<unsigned short> &vec, size_t size) {
+        const char* data = readArray(size, sizeof(unsigned short));
+        allocateArray(vec, size);
+        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(data, vec.data(), size);
     }
-    void getFloats(std::vector<float> &vec, size_t size) {
-        vec.resize(size);
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, &vec.front(), size);
+    void getFloats(ArenaVector<float> &vec, size_t size) {
+        const char* data = readArray(size, sizeof(float));
+        allocateArray(vec, size);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, vec.data(), size);
     }
-    void getVector2s(std::vector<osg::Vec2f> &vec, size_t size) {
-        vec.resize(size);
+    void getVector2s(ArenaVector<osg::Vec2f> &vec, size_t size) {
+        const char* data = readArray(size, 2 * sizeof(float));
+        allocateArray(vec, size);
         /* The packed storage of each Vec2f is 2 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp,(float*) &vec.front(), size*2);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*) vec.data(), size*2);
     }
-    void getVector3s(std::vector<osg::Vec3f> &vec, size_t size) {
-        vec.resize(size);
+    void getVector3s(ArenaVector<osg::Vec3f> &vec, size_t size) {
+        const char* data = readArray(size, 3 * sizeof(float));
+        allocateArray(vec, size);
         /* The packed storage of each Vec3f is 3 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*3);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*) vec.data(), size*3);
     }
-    void getVector4s(std::vector<osg::Vec4f> &vec, size_t size) {
-        vec.resize(size);
+    void getVector4s(ArenaVector<osg::Vec4f> &vec, size_t size) {
+        const char* data = readArray(size, 4 * sizeof(float));
+        allocateArray(vec, size);
         /* The packed storage of each Vec4f is 4 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*4);
+        readLittleEndianDynamicBufferOfType<float,uint32_t>(data, (float*) vec.data(), size*4);
     }
-    void getQuaternions(std::vector<osg::Quat> &quat, size_t size) {
-        quat.resize(size);
+    void getQuaternions(ArenaVector<osg::Quat> &quat, size_t size) {
+        // 4 floats each
+        if (size > size_t(mEnd - mPos) / (4 * sizeof(float)))
+            failReadPastEnd(size, 4 * sizeof(float));
+        allocateArray(quat, size);
         for (size_t i = 0;i < quat.size();i++)
             quat[i] = getQuaternion();
     }
@@ -272,8 +272,8 @@ void BulletNifLoader::handleNiTriShape(const Nif::NiTriShape *shape, int flags,
         childMesh->preallocateVertices(data->vertices.size());
         childMesh->preallocateIndices(data->triangles.size());
 
-        const std::vector<osg::Vec3f> &vertices = data->vertices;
-        const std::vector<unsigned short> &triangles = data->triangles;
+        const Nif::ArenaVector<osg::Vec3f> &vertices = data->vertices;
+        const Nif::ArenaVector<unsigned short> &triangles = data->triangles;
 
         for(size_t i = 0;i < data->triangles.size();i+=3)
         {
@@ -309,8 +309,8 @@ void BulletNifLoader::handleNiTriShape(const Nif::NiTriShape *shape, int flags,
 
         // Static shape, just transform all vertices into position
         const Nif::NiTriShapeData *data = shape->data.getPtr();
-        const std::vector<osg::Vec3f> &vertices = data->vertices;
-        const std::vector<unsigned short> &triangles = data->triangles;
+        const Nif::ArenaVector<osg::Vec3f> &vertices = data->vertices;
+        const Nif::ArenaVector<unsigned short> &triangles = data->triangles;
 
         mStaticMesh->preallocateVertices(data->vertices.size());
         mStaticMesh->preallocateIndices(data->triangles.size());
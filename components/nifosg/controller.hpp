@@ -42,19 +42,16 @@ namespace NifOsg
         typedef typename MapT::ValueType ValueT;
 
         ValueInterpolator()
-            : mDefaultVal(ValueT())
+            : mLastHighKey(0)
+            , mDefaultVal(ValueT())
         {
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
-            : mKeys(keys)
+            : mLastHighKey(0)
+            , mKeys(keys)
             , mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueT interpKey(float time) const
@@ -62,59 +59,55 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType & keys = mKeys->mKeys;
+            const std::vector<float>& times = mKeys->mTimes;
+            const std::vector<ValueT>& values = mKeys->mValues;
 
-            if(time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            if(time <= times.front())
+                return values.front();
+            if(time >= times.back())
+                return values.back();
 
-            // retrieve the current position in the map, optimized for the most common case
+            // retrieve the current position in the track, optimized for the most common case
             // where time moves linearly along the keyframe track
-            typename MapT::MapType::const_iterator it = mLastHighKey;
-            if (mLastHighKey != keys.end())
+            size_t high = mLastHighKey;
+            if (high == 0 || high >= times.size() || time <= times[high-1] || time > times[high])
             {
-                if (time > mLastHighKey->first)
-                {
-                    // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
-                    it = mLastHighKey;
-                }
-                if (mLastHighKey == keys.end() || (time < mLastLowKey->first || time > mLastHighKey->first))
-                    it = keys.lower_bound(time); // still not there, reorient by performing lower_bound check on the whole map
+                // try if we're there by incrementing one
+                if (high != 0 && high+1 < times.size() && time > times[high] && time <= times[high+1])
+                    ++high;
+                else // still not there, reorient by searching the whole track
+                    high = std::lower_bound(times.begin(), times.end(), time) - times.begin();
             }
-            else
-                it = keys.lower_bound(time);
-
-            // now do the actual interpolation
-            if (it != keys.end())
-            {
-                float aTime = it->first;
-                const typename MapT::KeyType* aKey = &it->second;
 
-                // cache for next time
-                mLastHighKey = it;
+            // cache for next time
+            mLastHighKey = high;
 
-                typename MapT::MapType::const_iterator last = --it;
-                mLastLowKey = last;
-                float aLastTime = last->first;
-                const typename MapT::KeyType* aLastKey = &last->second;
+            // now do the actual interpolation
+            size_t low = high-1;
+            float a = (time - times[low]) / (times[high] - times[low]);
 
-                float a = (time - aLastTime) / (aTime - aLastTime);
+            if (!mKeys->mOutTangents.empty())
+                return hermite(values[low], mKeys->mOutTangents[low], values[high], mKeys->mInTangents[high], a);
 
-                return InterpolationFunc()(aLastKey->mValue, aKey->mValue, a);
-            }
-            else
-                return keys.rbegin()->second.mValue;
+            return InterpolationFunc()(values[low], values[high], a);
         }
 
         bool empty() const
         {
-            return !mKeys || mKeys->mKeys.empty();
+            return !mKeys || mKeys->empty();
         }
 
     private:
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        /// Cubic Hermite interpolation, used for Quadratic and TBC keys.
+        static ValueT hermite(const ValueT& a, const ValueT& outTangent, const ValueT& b, const ValueT& inTangent, float fraction)
+        {
+            const float x2 = fraction * fraction;
+            const float x3 = x2 * fraction;
+            return a * (2.f * x3 - 3.f * x2 + 1.f) + b * (3.f * x2 - 2.f * x3)
+                 + outTangent * (x3 - 2.f * x2 + fraction) + inTangent * (x3 - x2);
+        }
+
+        mutable size_t mLastHighKey;
 
         std::shared_ptr<const MapT> mKeys;
 
@@ -0,0 +1,136 @@
+#include "textkeymap.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    struct EventType
+    {
+        const char* mEvent;
+        NifOsg::TextKey::Type mType;
+    };
+
+    const EventType sEventTypes[] = {
+        { "start", NifOsg::TextKey::Type_Start },
+        { "stop", NifOsg::TextKey::Type_Stop },
+        { "loop start", NifOsg::TextKey::Type_LoopStart },
+        { "loop stop", NifOsg::TextKey::Type_LoopStop },
+        { "equip attach", NifOsg::TextKey::Type_EquipAttach },
+        { "unequip detach", NifOsg::TextKey::Type_UnequipDetach },
+        { "hit", NifOsg::TextKey::Type_Hit },
+        { "chop hit", NifOsg::TextKey::Type_ChopHit },
+        { "slash hit", NifOsg::TextKey::Type_SlashHit },
+        { "thrust hit", NifOsg::TextKey::Type_ThrustHit },
+        { "block hit", NifOsg::TextKey::Type_BlockHit },
+        { "shoot attach", NifOsg::TextKey::Type_ShootAttach },
+        { "shoot release", NifOsg::TextKey::Type_ShootRelease },
+        { "shoot follow attach", NifOsg::TextKey::Type_ShootFollowAttach }
+    };
+
+    NifOsg::TextKey::Type getType(const std::string& group, const std::string& event)
+    {
+        if (group == "sound")
+            return NifOsg::TextKey::Type_Sound;
+        if (group == "soundgen")
+            return NifOsg::TextKey::Type_SoundGen;
+
+        for (size_t i=0; i<sizeof(sEventTypes)/sizeof(sEventTypes[0]); ++i)
+            if (event == sEventTypes[i].mEvent)
+                return sEventTypes[i].mType;
+
+        static const std::string release = "release";
+        if (event.size() >= release.size() && event.compare(event.size()-release.size(), release.size(), release) == 0)
+            return NifOsg::TextKey::Type_Release;
+
+        return NifOsg::TextKey::Type_Other;
+    }
+
+    bool compareTime(float time, const NifOsg::TextKey& key)
+    {
+        return time < key.mTime;
+    }
+
+    bool compareKeyTime(const NifOsg::TextKey& key, float time)
+    {
+        return key.mTime < time;
+    }
+}
+
+namespace NifOsg
+{
+    TextKey::TextKey(float time, const std::string& text)
+        : mTime(time)
+        , mText(text)
+    {
+        std::string::size_type separator = text.find(": ");
+        if (separator != std::string::npos)
+        {
+            mGroup = text.substr(0, separator);
+            mEvent = text.substr(separator+2);
+        }
+        else
+            mEvent = text;
+
+        mType = getType(mGroup, mEvent);
+    }
+
+    void TextKeyMap::insert(float time, const std::string& text)
+    {
+        size_t pos = upperBound(time) - mKeys.begin();
+        mKeys.insert(mKeys.begin() + pos, TextKey(time, text));
+
+        for (std::map<std::string, Group>::iterator it = mGroups.begin(); it != mGroups.end(); ++it)
+            for (Group::iterator key = it->second.begin(); key != it->second.end(); ++key)
+                if (*key >= pos)
+                    ++*key;
+
+        const std::string& groupName = mKeys[pos].mGroup;
+        if (!groupName.empty())
+        {
+            Group& group = mGroups[groupName];
+            group.insert(std::upper_bound(group.begin(), group.end(), pos), pos);
+        }
+    }
+
+    TextKeyMap::const_iterator TextKeyMap::lowerBound(float time) const
+    {
+        return std::lower_bound(mKeys.begin(), mKeys.end(), time, compareKeyTime);
+    }
+
+    TextKeyMap::const_iterator TextKeyMap::upperBound(float time) const
+    {
+        return std::upper_bound(mKeys.begin(), mKeys.end(), time, compareTime);
+    }
+
+    const TextKeyMap::Group* TextKeyMap::getGroup(const std::string& group) const
+    {
+        std::map<std::string, Group>::const_iterator found = mGroups.find(group);
+        if (found == mGroups.end())
+            return NULL;
+        return &found->second;
+    }
+
+    float TextKeyMap::getTime(const std::string& text) const
+    {
+        // A key starting with "<group>: " belongs to that group, only its keys need to be checked
+        std::string::size_type separator = text.find(": ");
+        if (separator != std::string::npos)
+        {
+            const Group* group = getGroup(text.substr(0, separator));
+            if (!group)
+                return -1.f;
+
+            for (Group::const_iterator it = group->begin(); it != group->end(); ++it)
+                if (mKeys[*it].mText.compare(0, text.size(), text) == 0)
+                    return mKeys[*it].mTime;
+
+            return -1.f;
+        }
+
+        for (const_iterator it = mKeys.begin(); it != mKeys.end(); ++it)
+            if (it->mText.compare(0, text.size(), text) == 0)
+                return it->mTime;
+
+        return -1.f;
+    }
+}
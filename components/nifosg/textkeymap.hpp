@@ -0,0 +1,85 @@
+#ifndef OPENMW_COMPONENTS_NIFOSG_TEXTKEYMAP
+#define OPENMW_COMPONENTS_NIFOSG_TEXTKEYMAP
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace NifOsg
+{
+    /// A text key of an animation, split into its group and event when it is loaded.
+    /// @par "attack1: chop hit" belongs to the group "attack1" and has the event "chop hit". Keys without
+    ///      a group, e.g. "soundgen: left", are split the same way.
+    struct TextKey
+    {
+        enum Type
+        {
+            Type_Other,
+            Type_Start,
+            Type_Stop,
+            Type_LoopStart,
+            Type_LoopStop,
+            Type_Sound,         ///< "sound: <id>"
+            Type_SoundGen,      ///< "soundgen: <type> [volume] [pitch]"
+            Type_EquipAttach,
+            Type_UnequipDetach,
+            Type_Hit,
+            Type_ChopHit,
+            Type_SlashHit,
+            Type_ThrustHit,
+            Type_BlockHit,
+            Type_ShootAttach,
+            Type_ShootRelease,
+            Type_ShootFollowAttach,
+            Type_Release        ///< "<range type> release" of spell casting
+        };
+
+        TextKey(float time, const std::string& text);
+
+        float mTime;
+        std::string mText;  ///< Lower case
+        std::string mGroup; ///< Empty if the text contains no ": "
+        std::string mEvent; ///< Text after the group, the whole text if there is no group
+        Type mType;
+    };
+
+    /// The text keys of an animation, ordered by time, with an index of the keys of each group.
+    class TextKeyMap
+    {
+    public:
+        typedef std::vector<TextKey>::const_iterator const_iterator;
+        typedef std::vector<TextKey>::const_reverse_iterator const_reverse_iterator;
+        typedef std::vector<size_t> Group; ///< Positions of the keys of a group, in time order
+
+        /// Add a key after the keys of the same or an earlier time.
+        void insert(float time, const std::string& text);
+
+        const_iterator begin() const { return mKeys.begin(); }
+        const_iterator end() const { return mKeys.end(); }
+        const_reverse_iterator rbegin() const { return mKeys.rbegin(); }
+        const_reverse_iterator rend() const { return mKeys.rend(); }
+
+        bool empty() const { return mKeys.empty(); }
+        size_t size() const { return mKeys.size(); }
+
+        const TextKey& operator[](size_t pos) const { return mKeys[pos]; }
+
+        /// First key with a time not before \a time.
+        const_iterator lowerBound(float time) const;
+
+        /// First key with a time after \a time.
+        const_iterator upperBound(float time) const;
+
+        /// @return The keys of \a group, or NULL if there are none.
+        const Group* getGroup(const std::string& group) const;
+
+        /// Time of the first key whose text starts with \a text, or -1 if there is none.
+        float getTime(const std::string& text) const;
+
+    private:
+        std::vector<TextKey> mKeys;
+        std::map<std::string, Group> mGroups;
+    };
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include <osg/Version>
 
 #include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <BulletCollision/CollisionShapes/btTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
 
 #include <components/vfs/manager.hpp>
 
@@ -94,6 +96,35 @@ private:
     std::unique_ptr<btTriangleMesh> mTriangleMesh;
 };
 
+/// Estimates the memory used by a collision shape, for the cache budget.
+size_t estimateShapeSize(const btCollisionShape* shape)
+{
+    if (!shape)
+        return 0;
+
+    if (shape->isCompound())
+    {
+        const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+        size_t size = sizeof(btCompoundShape);
+        for (int i=0; i<compound->getNumChildShapes(); ++i)
+            size += sizeof(btCompoundShapeChild) + estimateShapeSize(compound->getChildShape(i));
+        return size;
+    }
+
+    if (shape->getShapeType() == TRIANGLE_MESH_SHAPE_PROXYTYPE)
+    {
+        const btTriangleMeshShape* meshShape = static_cast<const btTriangleMeshShape*>(shape);
+        const btTriangleMesh* mesh = dynamic_cast<const btTriangleMesh*>(meshShape->getMeshInterface());
+        // indices and unwelded vertices of the mesh, plus about two quantized BVH nodes per triangle
+        const size_t triangleSize = 3 * sizeof(int) + 3 * sizeof(btVector3) + 2 * 16;
+        if (mesh)
+            return sizeof(btBvhTriangleMeshShape) + mesh->getNumTriangles() * triangleSize;
+    }
+
+    // primitive shapes such as boxes
+    return 256;
+}
+
 BulletShapeManager::BulletShapeManager(const VFS::Manager* vfs, SceneManager* sceneMgr, NifFileManager* nifFileManager)
     : ResourceManager(vfs)
     , mInstanceCache(new MultiObjectCache)
@@ -142,7 +173,7 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
                 return osg::ref_ptr<BulletShape>();
         }
 
-        mCache->addEntryToObjectCache(normalized, shape);
+        mCache->addEntryToObjectCache(normalized, shape, sizeof(BulletShape) + estimateShapeSize(shape->mCollisionShape));
     }
     return shape;
 }
@@ -197,6 +228,7 @@ void BulletShapeManager::reportStats(unsigned int frameNumber, osg::Stats *stats
 {
     stats->setAttribute(frameNumber, "Shape", mCache->getCacheSize());
     stats->setAttribute(frameNumber, "Shape Instance", mInstanceCache->getCacheSize());
+    reportCacheStats(frameNumber, stats, "Shape");
 }
 
 }
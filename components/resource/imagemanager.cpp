@@ -149,7 +149,7 @@ namespace Resource
                 }
             }
 
-            mCache->addEntryToObjectCache(normalized, image);
+            mCache->addEntryToObjectCache(normalized, image, image->getTotalSizeInBytesIncludingMipmaps());
             return image;
         }
     }
@@ -162,6 +162,7 @@ namespace Resource
     void ImageManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Image", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Image");
     }
 
 }
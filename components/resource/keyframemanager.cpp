@@ -27,9 +27,12 @@ namespace Resource
         else
         {
             osg::ref_ptr<NifOsg::KeyframeHolder> loaded (new NifOsg::KeyframeHolder);
-            NifOsg::Loader::loadKf(Nif::NIFFilePtr(new Nif::NIFFile(mVFS->getNormalized(normalized), normalized)), *loaded.get());
+            Files::IStreamPtr stream = mVFS->getNormalized(normalized);
+            Nif::NIFFilePtr file (new Nif::NIFFile(stream, normalized));
+            NifOsg::Loader::loadKf(file, *loaded.get());
 
-            mCache->addEntryToObjectCache(normalized, loaded);
+            // the keyframes make up most of a .kf file, so use its size as estimate
+            mCache->addEntryToObjectCache(normalized, loaded, file->getSize());
             return loaded;
         }
     }
@@ -37,6 +40,7 @@ namespace Resource
     void KeyframeManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Keyframe", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Keyframe");
     }
 
 
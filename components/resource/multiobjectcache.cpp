@@ -1,15 +1,24 @@
 #include "multiobjectcache.hpp"
 
+#include <functional>
 #include <vector>
 
 #include <osg/Object>
 
+namespace
+{
+    // Number of entries each shard visits per call of removeUnreferencedObjectsInCache,
+    // keeps the time the lock is held short regardless of the size of the cache.
+    const size_t sSweepEntriesPerShard = 256;
+}
+
 namespace Resource
 {
 
     MultiObjectCache::MultiObjectCache()
     {
-
+        for (unsigned int i=0; i<sNumShards; ++i)
+            _shards[i].mSweepBucket = 0;
     }
 
     MultiObjectCache::~MultiObjectCache()
@@ -17,26 +26,52 @@ namespace Resource
 
     }
 
+    MultiObjectCache::Shard& MultiObjectCache::getShard(const std::string& fileName)
+    {
+        return _shards[std::hash<std::string>()(fileName) % sNumShards];
+    }
+
     void MultiObjectCache::removeUnreferencedObjectsInCache()
     {
         std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+        std::vector<std::pair<std::string, osg::Object*> > unreferenced;
+
+        for (unsigned int i=0; i<sNumShards; ++i)
         {
-            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+            Shard& shard = _shards[i];
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
 
-            // Remove unreferenced entries from object cache
-            ObjectCacheMap::iterator oitr = _objectCache.begin();
-            while(oitr != _objectCache.end())
+            size_t numBuckets = shard.mObjectCache.bucket_count();
+            size_t visited = 0;
+            for (size_t b = 0; b < numBuckets && visited < sSweepEntriesPerShard; ++b)
             {
-                if (oitr->second->referenceCount() <= 1)
+                if (shard.mSweepBucket >= numBuckets)
+                    shard.mSweepBucket = 0;
+                size_t bucket = shard.mSweepBucket++;
+
+                for (ObjectCacheMap::local_iterator itr = shard.mObjectCache.begin(bucket); itr != shard.mObjectCache.end(bucket); ++itr)
                 {
-                    objectsToRemove.push_back(oitr->second);
-                    _objectCache.erase(oitr++);
+                    ++visited;
+                    if (itr->second->referenceCount() <= 1)
+                        unreferenced.push_back(std::make_pair(itr->first, itr->second.get()));
                 }
-                else
+            }
+
+            // Remove unreferenced entries from object cache
+            for (std::vector<std::pair<std::string, osg::Object*> >::const_iterator it = unreferenced.begin(); it != unreferenced.end(); ++it)
+            {
+                std::pair<ObjectCacheMap::iterator, ObjectCacheMap::iterator> range = shard.mObjectCache.equal_range(it->first);
+                for (ObjectCacheMap::iterator oitr = range.first; oitr != range.second; ++oitr)
                 {
-                    ++oitr;
+                    if (oitr->second.get() == it->second)
+                    {
+                        objectsToRemove.push_back(oitr->second);
+                        shard.mObjectCache.erase(oitr);
+                        break;
+                    }
                 }
             }
+            unreferenced.clear();
         }
 
         // note, actual unref happens outside of the lock
@@ -45,8 +80,13 @@ namespace Resource
 
     void MultiObjectCache::clear()
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-        _objectCache.clear();
+        for (unsigned int i=0; i<sNumShards; ++i)
+        {
+            Shard& shard = _shards[i];
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+            shard.mObjectCache.clear();
+            shard.mSweepBucket = 0;
+        }
     }
 
     void MultiObjectCache::addEntryToObjectCache(const std::string &filename, osg::Object *object)
@@ -56,41 +96,53 @@ namespace Resource
             OSG_ALWAYS << " trying to add NULL object to cache for " << filename << std::endl;
             return;
         }
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-        _objectCache.insert(std::make_pair(filename, object));
+        Shard& shard = getShard(filename);
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        shard.mObjectCache.insert(std::make_pair(filename, object));
     }
 
     osg::ref_ptr<osg::Object> MultiObjectCache::takeFromObjectCache(const std::string &fileName)
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-        ObjectCacheMap::iterator found = _objectCache.find(fileName);
-        if (found == _objectCache.end())
+        Shard& shard = getShard(fileName);
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        ObjectCacheMap::iterator found = shard.mObjectCache.find(fileName);
+        if (found == shard.mObjectCache.end())
             return osg::ref_ptr<osg::Object>();
         else
         {
             osg::ref_ptr<osg::Object> object = found->second;
-            _objectCache.erase(found);
+            shard.mObjectCache.erase(found);
             return object;
         }
     }
 
     void MultiObjectCache::releaseGLObjects(osg::State *state)
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-        for(ObjectCacheMap::iterator itr = _objectCache.begin();
-            itr != _objectCache.end();
-            ++itr)
+        for (unsigned int i=0; i<sNumShards; ++i)
         {
-            osg::Object* object = itr->second.get();
-            object->releaseGLObjects(state);
+            Shard& shard = _shards[i];
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+
+            for(ObjectCacheMap::iterator itr = shard.mObjectCache.begin();
+                itr != shard.mObjectCache.end();
+                ++itr)
+            {
+                osg::Object* object = itr->second.get();
+                object->releaseGLObjects(state);
+            }
         }
     }
 
     unsigned int MultiObjectCache::getCacheSize() const
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-        return _objectCache.size();
+        unsigned int size = 0;
+        for (unsigned int i=0; i<sNumShards; ++i)
+        {
+            const Shard& shard = _shards[i];
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+            size += shard.mObjectCache.size();
+        }
+        return size;
     }
 
 }
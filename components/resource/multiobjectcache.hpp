@@ -1,7 +1,7 @@
 #ifndef OPENMW_COMPONENTS_MULTIOBJECTCACHE_H
 #define OPENMW_COMPONENTS_MULTIOBJECTCACHE_H
 
-#include <map>
+#include <unordered_map>
 #include <string>
 
 #include <osg/ref_ptr>
@@ -23,6 +23,8 @@ namespace Resource
         MultiObjectCache();
         ~MultiObjectCache();
 
+        /** Visit a bounded number of objects in each shard of the cache, continuing where the previous call stopped,
+          * and remove the ones that are not referenced elsewhere. */
         void removeUnreferencedObjectsInCache();
 
         /** Remove all objects from the cache. */
@@ -40,10 +42,20 @@ namespace Resource
 
     protected:
 
-        typedef std::multimap<std::string, osg::ref_ptr<osg::Object> >             ObjectCacheMap;
+        typedef std::unordered_multimap<std::string, osg::ref_ptr<osg::Object> >   ObjectCacheMap;
 
-        ObjectCacheMap                          _objectCache;
-        mutable OpenThreads::Mutex              _objectCacheMutex;
+        struct Shard
+        {
+            ObjectCacheMap                      mObjectCache;
+            size_t                              mSweepBucket; // where the next incremental sweep starts
+            mutable OpenThreads::Mutex          mMutex;
+        };
+
+        static const unsigned int sNumShards = 16;
+
+        Shard& getShard(const std::string& fileName);
+
+        Shard                                   _shards[sNumShards];
 
     };
 
@@ -49,9 +49,11 @@ namespace Resource
             return static_cast<NifFileHolder*>(obj.get())->mNifFile;
         else
         {
-            Nif::NIFFilePtr file (new Nif::NIFFile(mVFS->get(name), name));
+            Files::IStreamPtr stream = mVFS->get(name);
+            Nif::NIFFilePtr file (new Nif::NIFFile(stream, name));
             obj = new NifFileHolder(file);
-            mCache->addEntryToObjectCache(name, obj);
+            // the parsed records take about as much memory as the file they were read from
+            mCache->addEntryToObjectCache(name, obj, file->getSize());
             return file;
         }
     }
@@ -59,6 +61,7 @@ namespace Resource
     void NifFileManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
     {
         stats->setAttribute(frameNumber, "Nif", mCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Nif");
     }
 
 }
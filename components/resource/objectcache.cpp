@@ -13,6 +13,11 @@
 
 #include "objectcache.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
 #include <osg/Object>
 #include <osg/Node>
 
@@ -23,87 +28,220 @@ namespace Resource
 //
 // ObjectCache
 //
+namespace
+{
+    // Number of entries each shard visits per call of updateTimeStampsAndRemoveExpiredObjectsInCache,
+    // keeps the time the lock is held short regardless of the size of the cache.
+    const size_t sSweepEntriesPerShard = 256;
+
+    // Number of entries each shard visits per call of removeLeastRecentlyUsedObjectsInCache, for the same reason.
+    const size_t sEvictEntriesPerShard = 256;
+}
+
 ObjectCache::ObjectCache():
     osg::Referenced(true)
 {
+    for (unsigned int i=0; i<sNumShards; ++i)
+    {
+        Shard& shard = _shards[i];
+        shard.mStats.mSize = 0;
+        shard.mStats.mHits = 0;
+        shard.mStats.mMisses = 0;
+        shard.mStats.mEvictions = 0;
+        shard.mReferencedSize = 0;
+        shard.mSweepBucket = 0;
+    }
 }
 
 ObjectCache::~ObjectCache()
 {
 }
 
-void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp)
+ObjectCache::Shard& ObjectCache::getShard(const std::string& fileName)
+{
+    return _shards[std::hash<std::string>()(fileName) % sNumShards];
+}
+
+void ObjectCache::markUsed(Shard& shard, CacheEntry& entry)
+{
+    shard.mUsage.splice(shard.mUsage.begin(), shard.mUsage, entry.mUsage);
+}
+
+void ObjectCache::setReferenced(Shard& shard, CacheEntry& entry, bool referenced)
+{
+    if (entry.mReferenced == referenced)
+        return;
+    entry.mReferenced = referenced;
+    if (referenced)
+        shard.mReferencedSize += entry.mSize;
+    else
+        shard.mReferencedSize -= entry.mSize;
+}
+
+osg::ref_ptr<osg::Object> ObjectCache::eraseEntry(Shard& shard, ObjectCacheMap::iterator itr)
+{
+    osg::ref_ptr<osg::Object> object = itr->second.mObject;
+    setReferenced(shard, itr->second, false);
+    shard.mStats.mSize -= itr->second.mSize;
+    shard.mUsage.erase(itr->second.mUsage);
+    shard.mObjectCache.erase(itr);
+    return object;
+}
+
+void ObjectCache::addEntryToObjectCache(const std::string& filename, osg::Object* object, size_t size, double timestamp)
 {
     if (!object)
     {
         OSG_ALWAYS << " trying to add NULL object to cache for " << filename << std::endl;
         return;
     }
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    _objectCache[filename]=ObjectTimeStampPair(object,timestamp);
+    Shard& shard = getShard(filename);
+    osg::ref_ptr<osg::Object> replaced;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        ObjectCacheMap::iterator itr = shard.mObjectCache.find(filename);
+        if (itr != shard.mObjectCache.end())
+            replaced = eraseEntry(shard, itr);
+
+        CacheEntry& entry = shard.mObjectCache[filename];
+        entry.mObject = object;
+        entry.mTimeStamp = timestamp;
+        entry.mSize = size;
+        entry.mReferenced = false;
+        entry.mUsage = shard.mUsage.insert(shard.mUsage.begin(), filename);
+        shard.mStats.mSize += size;
+        setReferenced(shard, entry, object->referenceCount()>1);
+    }
 }
 
 osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string& fileName)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end())
+    Shard& shard = getShard(fileName);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+    ObjectCacheMap::iterator itr = shard.mObjectCache.find(fileName);
+    if (itr!=shard.mObjectCache.end())
+    {
+        ++shard.mStats.mHits;
+        markUsed(shard, itr->second);
+        return itr->second.mObject;
+    }
+    else
     {
-        return itr->second.first;
+        ++shard.mStats.mMisses;
+        return 0;
     }
-    else return 0;
 }
 
 bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeStamp)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end())
+    Shard& shard = getShard(fileName);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+    ObjectCacheMap::iterator itr = shard.mObjectCache.find(fileName);
+    if (itr!=shard.mObjectCache.end())
     {
-        itr->second.second = timeStamp;
+        itr->second.mTimeStamp = timeStamp;
+        markUsed(shard, itr->second);
         return true;
     }
     else return false;
 }
 
-void ObjectCache::updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime)
+void ObjectCache::updateTimeStampsAndRemoveExpiredObjectsInCache(double referenceTime, double expiryTime)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
+    std::vector<std::string> expired;
 
-    // look for objects with external references and update their time stamp.
-    for(ObjectCacheMap::iterator itr=_objectCache.begin();
-        itr!=_objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<sNumShards; ++i)
     {
-        // if ref count is greater the 1 the object has an external reference.
-        if (itr->second.first->referenceCount()>1)
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+
+        // Walk whole buckets starting from where the last sweep stopped. The bucket count only changes
+        // when the map rehashes, in which case some entries are visited twice or skipped until the next round.
+        size_t numBuckets = shard.mObjectCache.bucket_count();
+        size_t visited = 0;
+        for (size_t b = 0; b < numBuckets && visited < sSweepEntriesPerShard; ++b)
+        {
+            if (shard.mSweepBucket >= numBuckets)
+                shard.mSweepBucket = 0;
+            size_t bucket = shard.mSweepBucket++;
+
+            for (ObjectCacheMap::local_iterator itr = shard.mObjectCache.begin(bucket); itr != shard.mObjectCache.end(bucket); ++itr)
+            {
+                ++visited;
+                // if ref count is greater the 1 the object has an external reference.
+                bool referenced = itr->second.mObject->referenceCount()>1;
+                setReferenced(shard, itr->second, referenced);
+                if (referenced)
+                {
+                    // so update it time stamp.
+                    itr->second.mTimeStamp = referenceTime;
+                    markUsed(shard, itr->second);
+                }
+                else if (itr->second.mTimeStamp<=expiryTime)
+                    expired.push_back(itr->first);
+            }
+        }
+
+        // Remove expired entries from object cache
+        for (std::vector<std::string>::const_iterator it = expired.begin(); it != expired.end(); ++it)
         {
-            // so update it time stamp.
-            itr->second.second = referenceTime;
+            objectsToRemove.push_back(eraseEntry(shard, shard.mObjectCache.find(*it)));
+            ++shard.mStats.mEvictions;
         }
+        expired.clear();
     }
+
+    // note, actual unref happens outside of the lock
+    objectsToRemove.clear();
 }
 
-void ObjectCache::removeExpiredObjectsInCache(double expiryTime)
+void ObjectCache::removeLeastRecentlyUsedObjectsInCache(size_t budget)
 {
+    // The budget applies to the cache as a whole, each shard removes its share of the excess
+    size_t unreferenced[sNumShards];
+    size_t totalUnreferenced = 0;
+    for (unsigned int i=0; i<sNumShards; ++i)
+    {
+        const Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        unreferenced[i] = shard.mStats.mSize - shard.mReferencedSize;
+        totalUnreferenced += unreferenced[i];
+    }
+
+    if (totalUnreferenced <= budget)
+        return;
+    const double excess = static_cast<double>(totalUnreferenced - budget);
+
     std::vector<osg::ref_ptr<osg::Object> > objectsToRemove;
 
+    for (unsigned int i=0; i<sNumShards; ++i)
     {
-        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+        if (unreferenced[i] == 0)
+            continue;
+        size_t toRemove = static_cast<size_t>(std::ceil(excess * unreferenced[i] / totalUnreferenced));
 
-        // Remove expired entries from object cache
-        ObjectCacheMap::iterator oitr = _objectCache.begin();
-        while(oitr != _objectCache.end())
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+
+        size_t removed = 0;
+        size_t numEntries = std::min(shard.mUsage.size(), sEvictEntriesPerShard);
+        for (size_t visited = 0; visited < numEntries && removed < toRemove; ++visited)
         {
-            if (oitr->second.second<=expiryTime)
-            {
-                objectsToRemove.push_back(oitr->second.first);
-                _objectCache.erase(oitr++);
-            }
-            else
+            ObjectCacheMap::iterator oitr = shard.mObjectCache.find(shard.mUsage.back());
+
+            // removing objects that are still referenced elsewhere would not free any memory,
+            // move them and objects of unknown size to the front so that the next call continues with other entries
+            setReferenced(shard, oitr->second, oitr->second.mObject->referenceCount()>1);
+            if (oitr->second.mSize == 0 || oitr->second.mReferenced)
             {
-                ++oitr;
+                markUsed(shard, oitr->second);
+                continue;
             }
+
+            removed += oitr->second.mSize;
+            objectsToRemove.push_back(eraseEntry(shard, oitr));
+            ++shard.mStats.mEvictions;
         }
     }
 
@@ -113,52 +251,97 @@ void ObjectCache::removeExpiredObjectsInCache(double expiryTime)
 
 void ObjectCache::removeFromObjectCache(const std::string& fileName)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    ObjectCacheMap::iterator itr = _objectCache.find(fileName);
-    if (itr!=_objectCache.end()) _objectCache.erase(itr);
+    Shard& shard = getShard(fileName);
+    osg::ref_ptr<osg::Object> removed;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        ObjectCacheMap::iterator itr = shard.mObjectCache.find(fileName);
+        if (itr!=shard.mObjectCache.end()) removed = eraseEntry(shard, itr);
+    }
 }
 
 void ObjectCache::clear()
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    _objectCache.clear();
+    for (unsigned int i=0; i<sNumShards; ++i)
+    {
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        shard.mObjectCache.clear();
+        shard.mUsage.clear();
+        shard.mStats.mSize = 0;
+        shard.mReferencedSize = 0;
+        shard.mSweepBucket = 0;
+    }
 }
 
 void ObjectCache::releaseGLObjects(osg::State* state)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-    for(ObjectCacheMap::iterator itr = _objectCache.begin();
-        itr != _objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<sNumShards; ++i)
     {
-        osg::Object* object = itr->second.first.get();
-        object->releaseGLObjects(state);
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+
+        for(ObjectCacheMap::iterator itr = shard.mObjectCache.begin();
+            itr != shard.mObjectCache.end();
+            ++itr)
+        {
+            osg::Object* object = itr->second.mObject.get();
+            object->releaseGLObjects(state);
+        }
     }
 }
 
 void ObjectCache::accept(osg::NodeVisitor &nv)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-
-    for(ObjectCacheMap::iterator itr = _objectCache.begin();
-        itr != _objectCache.end();
-        ++itr)
+    for (unsigned int i=0; i<sNumShards; ++i)
     {
-        osg::Object* object = itr->second.first.get();
-        if (object)
+        Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+
+        for(ObjectCacheMap::iterator itr = shard.mObjectCache.begin();
+            itr != shard.mObjectCache.end();
+            ++itr)
         {
-            osg::Node* node = dynamic_cast<osg::Node*>(object);
-            if (node)
-                node->accept(nv);
+            osg::Object* object = itr->second.mObject.get();
+            if (object)
+            {
+                osg::Node* node = dynamic_cast<osg::Node*>(object);
+                if (node)
+                    node->accept(nv);
+            }
         }
     }
 }
 
 unsigned int ObjectCache::getCacheSize() const
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-    return _objectCache.size();
+    unsigned int size = 0;
+    for (unsigned int i=0; i<sNumShards; ++i)
+    {
+        const Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        size += shard.mObjectCache.size();
+    }
+    return size;
+}
+
+ObjectCache::Stats ObjectCache::getStats() const
+{
+    Stats stats;
+    stats.mSize = 0;
+    stats.mHits = 0;
+    stats.mMisses = 0;
+    stats.mEvictions = 0;
+    for (unsigned int i=0; i<sNumShards; ++i)
+    {
+        const Shard& shard = _shards[i];
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+        stats.mSize += shard.mStats.mSize;
+        stats.mHits += shard.mStats.mHits;
+        stats.mMisses += shard.mStats.mMisses;
+        stats.mEvictions += shard.mStats.mEvictions;
+    }
+    return stats;
 }
 
 }
@@ -1,5 +1,8 @@
 // Resource ObjectCache for OpenMW, forked from osgDB ObjectCache by Robert Osfield, see copyright notice below.
 // The main change from the upstream version is that removeExpiredObjectsInCache no longer keeps a lock while the unref happens.
+// It also tracks an estimated size of the objects, so that a memory budget can be enforced in least recently used order.
+// The cache is split into shards with their own lock, and expiry and eviction are done incrementally, so that the main thread is not held up
+// by the background threads filling the cache or by the periodic expiry sweep.
 
 /* -*-c++-*- OpenSceneGraph - Copyright (C) 1998-2006 Robert Osfield
  *
@@ -21,7 +24,8 @@
 #include <osg/ref_ptr>
 
 #include <string>
-#include <map>
+#include <unordered_map>
+#include <list>
 
 namespace osg
 {
@@ -38,30 +42,44 @@ class ObjectCache : public osg::Referenced
 
         ObjectCache();
 
-        /** For each object in the cache which has an reference count greater than 1
-          * (and therefore referenced by elsewhere in the application) set the time stamp
-          * for that object in the cache to specified time.
-          * This would typically be called once per frame by applications which are doing database paging,
+        /** Counters of the usage of the cache, for reporting stats. */
+        struct Stats
+        {
+            size_t mSize; ///< Estimated size of the cached objects in bytes
+            unsigned int mHits;
+            unsigned int mMisses;
+            unsigned int mEvictions;
+        };
+
+        /** Visit a bounded number of objects in each shard of the cache, continuing where the previous call stopped.
+          * Objects which have a reference count greater than 1 (and are therefore referenced elsewhere in the application)
+          * get their time stamp set to referenceTime, other objects with a time stamp at or before expiryTime are removed.
+          * Also updates which objects count towards the budget of removeLeastRecentlyUsedObjectsInCache.
+          * This would typically be called periodically by applications which are doing database paging,
           * and need to prune objects that are no longer required.
           * The time used should be taken from the FrameStamp::getReferenceTime().*/
-        void updateTimeStampOfObjectsInCacheWithExternalReferences(double referenceTime);
+        void updateTimeStampsAndRemoveExpiredObjectsInCache(double referenceTime, double expiryTime);
 
-        /** Removed object in the cache which have a time stamp at or before the specified expiry time.
-          * This would typically be called once per frame by applications which are doing database paging,
-          * and need to prune objects that are no longer required, and called after the a called
-          * after the call to updateTimeStampOfObjectsInCacheWithExternalReferences(expirtyTime).*/
-        void removeExpiredObjectsInCache(double expiryTime);
+        /** Remove the least recently used objects without external references until the estimated size of the
+          * objects without external references is within the budget. The budget applies to the whole cache, each shard
+          * removes a part of the excess in proportion to its size, and visits a bounded number of objects per call,
+          * so it may take several calls to get within the budget.
+          * Objects still referenced elsewhere do not count towards the budget, as removing them would not free any memory.
+          * Whether an object is referenced is checked when it is added, by updateTimeStampsAndRemoveExpiredObjectsInCache
+          * and by this function. Objects of unknown size (0) are never removed by this.*/
+        void removeLeastRecentlyUsedObjectsInCache(size_t budget);
 
         /** Remove all objects in the cache regardless of having external references or expiry times.*/
         void clear();
 
-        /** Add a filename,object,timestamp triple to the Registry::ObjectCache.*/
-        void addEntryToObjectCache(const std::string& filename, osg::Object* object, double timestamp = 0.0);
+        /** Add a filename,object,timestamp triple to the Registry::ObjectCache.
+          * @param size Estimated memory used by the object in bytes, 0 if unknown. */
+        void addEntryToObjectCache(const std::string& filename, osg::Object* object, size_t size = 0, double timestamp = 0.0);
 
         /** Remove Object from cache.*/
         void removeFromObjectCache(const std::string& fileName);
 
-        /** Get an ref_ptr<Object> from the object cache*/
+        /** Get an ref_ptr<Object> from the object cache, and mark it as recently used*/
         osg::ref_ptr<osg::Object> getRefFromObjectCache(const std::string& fileName);
 
         /** Check if an object is in the cache, and if it is, update its usage time stamp. */
@@ -77,23 +95,60 @@ class ObjectCache : public osg::Referenced
         template <class Functor>
         void call(Functor& f)
         {
-            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
-            for (ObjectCacheMap::iterator it = _objectCache.begin(); it != _objectCache.end(); ++it)
-                f(it->second.first.get());
+            for (unsigned int i=0; i<sNumShards; ++i)
+            {
+                Shard& shard = _shards[i];
+                OpenThreads::ScopedLock<OpenThreads::Mutex> lock(shard.mMutex);
+                for (ObjectCacheMap::iterator it = shard.mObjectCache.begin(); it != shard.mObjectCache.end(); ++it)
+                    f(it->second.mObject.get());
+            }
         }
 
         /** Get the number of objects in the cache. */
         unsigned int getCacheSize() const;
 
+        Stats getStats() const;
+
     protected:
 
         virtual ~ObjectCache();
 
-        typedef std::pair<osg::ref_ptr<osg::Object>, double >           ObjectTimeStampPair;
-        typedef std::map<std::string, ObjectTimeStampPair >             ObjectCacheMap;
+        typedef std::list<std::string>                                  UsageList;
+
+        struct CacheEntry
+        {
+            osg::ref_ptr<osg::Object> mObject;
+            double mTimeStamp;
+            size_t mSize;
+            bool mReferenced; // referenced elsewhere when last checked
+            UsageList::iterator mUsage;
+        };
+        typedef std::unordered_map<std::string, CacheEntry >            ObjectCacheMap;
+
+        struct Shard
+        {
+            ObjectCacheMap                      mObjectCache;
+            UsageList                           mUsage; // most recently used first
+            Stats                               mStats;
+            size_t                              mReferencedSize; // size of the entries with mReferenced set
+            size_t                              mSweepBucket; // where the next incremental sweep starts
+            mutable OpenThreads::Mutex          mMutex;
+        };
+
+        static const unsigned int sNumShards = 16;
+
+        Shard& getShard(const std::string& fileName);
+
+        /** Move the entry to the front of the usage list. */
+        static void markUsed(Shard& shard, CacheEntry& entry);
+
+        /** Update whether the entry is referenced elsewhere, and the size of the referenced entries. */
+        static void setReferenced(Shard& shard, CacheEntry& entry, bool referenced);
+
+        /** Erase the entry, returning its object so that it can be unreferenced outside of the lock. */
+        static osg::ref_ptr<osg::Object> eraseEntry(Shard& shard, ObjectCacheMap::iterator itr);
 
-        ObjectCacheMap                          _objectCache;
-        mutable OpenThreads::Mutex              _objectCacheMutex;
+        Shard                                   _shards[sNumShards];
 
 };
 
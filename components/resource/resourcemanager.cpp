@@ -1,5 +1,7 @@
 #include "resourcemanager.hpp"
 
+#include <osg/Stats>
+
 #include "objectcache.hpp"
 
 namespace Resource
@@ -9,6 +11,7 @@ namespace Resource
         : mVFS(vfs)
         , mCache(new Resource::ObjectCache)
         , mExpiryDelay(0.0)
+        , mCacheBudget(0)
     {
 
     }
@@ -19,8 +22,9 @@ namespace Resource
 
     void ResourceManager::updateCache(double referenceTime)
     {
-        mCache->updateTimeStampOfObjectsInCacheWithExternalReferences(referenceTime);
-        mCache->removeExpiredObjectsInCache(referenceTime - mExpiryDelay);
+        mCache->updateTimeStampsAndRemoveExpiredObjectsInCache(referenceTime, referenceTime - mExpiryDelay);
+        if (mCacheBudget > 0)
+            mCache->removeLeastRecentlyUsedObjectsInCache(mCacheBudget);
     }
 
     void ResourceManager::clearCache()
@@ -33,6 +37,20 @@ namespace Resource
         mExpiryDelay = expiryDelay;
     }
 
+    void ResourceManager::setCacheBudget(size_t budget)
+    {
+        mCacheBudget = budget;
+    }
+
+    void ResourceManager::reportCacheStats(unsigned int frameNumber, osg::Stats *stats, const std::string &name) const
+    {
+        ObjectCache::Stats cacheStats = mCache->getStats();
+        stats->setAttribute(frameNumber, name + " KB", cacheStats.mSize / 1024);
+        stats->setAttribute(frameNumber, name + " Hit", cacheStats.mHits);
+        stats->setAttribute(frameNumber, name + " Miss", cacheStats.mMisses);
+        stats->setAttribute(frameNumber, name + " Evict", cacheStats.mEvictions);
+    }
+
     const VFS::Manager* ResourceManager::getVFS() const
     {
         return mVFS;
@@ -3,6 +3,8 @@
 
 #include <osg/ref_ptr>
 
+#include <string>
+
 namespace VFS
 {
     class Manager;
@@ -26,7 +28,8 @@ namespace Resource
         ResourceManager(const VFS::Manager* vfs);
         virtual ~ResourceManager();
 
-        /// Clear cache entries that have not been referenced for longer than expiryDelay.
+        /// Clear cache entries that have not been referenced for longer than expiryDelay, then clear the least
+        /// recently used entries that are not referenced until the cache is within its budget.
         virtual void updateCache(double referenceTime);
 
         /// Clear all cache entries.
@@ -35,6 +38,9 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay (double expiryDelay);
 
+        /// Estimated memory, in bytes, that cached objects without external references may use. 0 for no limit.
+        void setCacheBudget (size_t budget);
+
         const VFS::Manager* getVFS() const;
 
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const {}
@@ -42,9 +48,13 @@ namespace Resource
         virtual void releaseGLObjects(osg::State* state);
 
     protected:
+        /// Report the memory use and hit, miss and eviction counts of mCache as "<name> KB", "<name> Hit", ...
+        void reportCacheStats(unsigned int frameNumber, osg::Stats* stats, const std::string& name) const;
+
         const VFS::Manager* mVFS;
         osg::ref_ptr<Resource::ObjectCache> mCache;
         double mExpiryDelay;
+        size_t mCacheBudget;
     };
 
 }
@@ -1,9 +1,12 @@
 #include "scenemanager.hpp"
 
 #include <iostream>
+#include <sstream>
 #include <cstdlib>
 
 #include <osg/Node>
+#include <osg/Geometry>
+#include <osg/Program>
 #include <osg/UserDataContainer>
 
 #include <osgParticle/ParticleSystem>
@@ -24,6 +27,8 @@
 #include <components/sceneutil/util.hpp>
 #include <components/sceneutil/controller.hpp>
 #include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/riggeometry.hpp>
+#include <components/sceneutil/morphgeometry.hpp>
 
 #include <components/shader/shadervisitor.hpp>
 #include <components/shader/shadermanager.hpp>
@@ -32,6 +37,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "templatecache.hpp"
 
 namespace
 {
@@ -105,6 +111,52 @@ namespace
     private:
         unsigned int mMask;
     };
+
+    /// Estimates the memory used by the vertex and index data of a scene graph, for the cache budget.
+    /// Textures are not included, they are cached by the ImageManager.
+    class EstimateSizeVisitor : public osg::NodeVisitor
+    {
+    public:
+        EstimateSizeVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mSize(0)
+        {
+        }
+
+        void apply(osg::Node& node)
+        {
+            mSize += sizeof(osg::Node);
+            traverse(node);
+        }
+
+        void apply(osg::Drawable& drw)
+        {
+            mSize += sizeof(osg::Drawable);
+            if (SceneUtil::RigGeometry* rig = dynamic_cast<SceneUtil::RigGeometry*>(&drw))
+                addGeometry(rig->getSourceGeometry());
+            else if (SceneUtil::MorphGeometry* morph = dynamic_cast<SceneUtil::MorphGeometry*>(&drw))
+                addGeometry(morph->getSourceGeometry());
+            else
+                addGeometry(drw.asGeometry());
+        }
+
+        void addGeometry(const osg::Geometry* geom)
+        {
+            if (!geom)
+                return;
+
+            osg::Geometry::ArrayList arrays;
+            geom->getArrayList(arrays);
+            for (osg::Geometry::ArrayList::const_iterator it = arrays.begin(); it != arrays.end(); ++it)
+                mSize += (*it)->getTotalDataSize();
+
+            const osg::Geometry::PrimitiveSetList& primitives = geom->getPrimitiveSetList();
+            for (osg::Geometry::PrimitiveSetList::const_iterator it = primitives.begin(); it != primitives.end(); ++it)
+                mSize += (*it)->getTotalDataSize();
+        }
+
+        size_t mSize;
+    };
 }
 
 namespace Resource
@@ -212,6 +264,36 @@ namespace Resource
 
 
 
+    /// Replace the programs in StateSets, e.g. those read from a file, with the ones shared by the shader manager.
+    class ShareProgramsVisitor : public osg::NodeVisitor
+    {
+    public:
+        ShareProgramsVisitor(Shader::ShaderManager& shaderManager)
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mShaderManager(shaderManager)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            osg::StateSet* stateset = node.getStateSet();
+            if (stateset)
+            {
+                const osg::StateSet::RefAttributePair* attr = stateset->getAttributePair(osg::StateAttribute::PROGRAM);
+                if (attr)
+                {
+                    osg::ref_ptr<osg::Program> program = mShaderManager.getProgram(static_cast<osg::Program*>(attr->first.get()));
+                    stateset->setAttribute(program, attr->second);
+                }
+            }
+
+            traverse(node);
+        }
+
+    private:
+        Shader::ShaderManager& mShaderManager;
+    };
+
     SceneManager::SceneManager(const VFS::Manager *vfs, Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager)
         : ResourceManager(vfs)
         , mShaderManager(new Shader::ShaderManager)
@@ -382,6 +464,14 @@ namespace Resource
         }
     }
 
+    void SceneManager::setTemplateCache(const std::string &directory, const std::string &engineVersion, bool rebuild)
+    {
+        // cached scene graphs refer to images by name, load them through the image manager like the NIF loader does
+        osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+        options->setReadFileCallback(new ImageReadCallback(mImageManager));
+        mTemplateCache.reset(new TemplateCache(directory, engineVersion, mVFS, options, rebuild));
+    }
+
     class CanOptimizeCallback : public SceneUtil::Optimizer::IsOperationPermissibleForObjectCallback
     {
     public:
@@ -475,6 +565,17 @@ namespace Resource
         return options;
     }
 
+    std::string SceneManager::getTemplateCacheSettings() const
+    {
+        static const unsigned int optimizationOptions = getOptimizationOptions();
+
+        std::ostringstream settings;
+        settings << mMinFilter << " " << mMagFilter << " " << mMaxAnisotropy << " " << optimizationOptions << " "
+                 << mForceShaders << mClampLighting << mForcePerPixelLighting << mAutoUseNormalMaps << mAutoUseSpecularMaps << " "
+                 << mNormalMapPattern << " " << mNormalHeightMapPattern << " " << mSpecularMapPattern;
+        return settings.str();
+    }
+
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name)
     {
         std::string normalized = name;
@@ -486,16 +587,33 @@ namespace Resource
         else
         {
             osg::ref_ptr<osg::Node> loaded;
+            bool fromTemplateCache = false;
+            std::string stamp;
+            std::string settings;
             try
             {
-                Files::IStreamPtr file = mVFS->get(normalized);
+                if (mTemplateCache && getFileExtension(normalized) == "nif")
+                {
+                    stamp = mVFS->getStamp(normalized);
+                    settings = getTemplateCacheSettings();
+                    loaded = mTemplateCache->read(normalized, stamp, settings);
+                    fromTemplateCache = loaded.valid();
+                }
 
-                loaded = load(file, normalized, mImageManager, mNifFileManager);
+                if (!loaded)
+                {
+                    Files::IStreamPtr file = mVFS->get(normalized);
+
+                    loaded = load(file, normalized, mImageManager, mNifFileManager);
+                }
             }
             catch (std::exception& e)
             {
                 static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
 
+                // the marker must not be stored in the template cache under the name of the broken file
+                stamp.clear();
+
                 for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
                 {
                     normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
@@ -512,36 +630,57 @@ namespace Resource
                     throw;
             }
 
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
+            if (fromTemplateCache)
+            {
+                // the cached scene graph has been filtered, run through the shader visitor and optimized already,
+                // only its programs need to be shared with the other scene graphs
+                ShareProgramsVisitor shareProgramsVisitor(*mShaderManager);
+                loaded->accept(shareProgramsVisitor);
+            }
+            else
+            {
+                // set filtering settings
+                SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+                loaded->accept(setFilterSettingsVisitor);
+                SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+                loaded->accept(setFilterSettingsControllerVisitor);
+
+                osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
+                loaded->accept(*shaderVisitor);
+
+                // share state within the scene graph
+                // do this before optimizing so the optimizer will be able to combine nodes more aggressively
+                // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
+                // state is only shared with other scene graphs afterwards, so the template cache stores this scene graph on its own
+                osg::ref_ptr<osgDB::SharedStateManager> localSharedStateManager (new osgDB::SharedStateManager);
+                localSharedStateManager->share(loaded.get());
+
+                if (canOptimize(normalized))
+                {
+                    SceneUtil::Optimizer optimizer;
+                    optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
 
-            osg::ref_ptr<Shader::ShaderVisitor> shaderVisitor (createShaderVisitor());
-            loaded->accept(*shaderVisitor);
+                    static const unsigned int options = getOptimizationOptions();
+
+                    optimizer.optimize(loaded, options);
+                }
 
-            // share state
-            // do this before optimizing so the optimizer will be able to combine nodes more aggressively
-            // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
+                if (mTemplateCache && !stamp.empty())
+                    mTemplateCache->write(normalized, stamp, settings, shaderVisitor->getAutoMapFiles(), loaded);
+            }
+
+            // share state with other scene graphs
             mSharedStateMutex.lock();
             mSharedStateManager->share(loaded.get());
             mSharedStateMutex.unlock();
 
-            if (canOptimize(normalized))
-            {
-                SceneUtil::Optimizer optimizer;
-                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
-
-                static const unsigned int options = getOptimizationOptions();
-
-                optimizer.optimize(loaded, options);
-            }
-
             if (mIncrementalCompileOperation)
                 mIncrementalCompileOperation->add(loaded);
 
-            mCache->addEntryToObjectCache(normalized, loaded);
+            EstimateSizeVisitor estimateSizeVisitor;
+            loaded->accept(estimateSizeVisitor);
+
+            mCache->addEntryToObjectCache(normalized, loaded, estimateSizeVisitor.mSize);
             return loaded;
         }
     }
@@ -740,6 +879,7 @@ namespace Resource
 
         stats->setAttribute(frameNumber, "Node", mCache->getCacheSize());
         stats->setAttribute(frameNumber, "Node Instance", mInstanceCache->getCacheSize());
+        reportCacheStats(frameNumber, stats, "Node");
     }
 
     Shader::ShaderVisitor *SceneManager::createShaderVisitor()
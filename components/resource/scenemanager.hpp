@@ -38,6 +38,7 @@ namespace Resource
 {
 
     class MultiObjectCache;
+    class TemplateCache;
 
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
@@ -79,6 +80,11 @@ namespace Resource
 
         void setShaderPath(const std::string& path);
 
+        /// Keep converted NIF files in the given directory, to skip converting them again on the next start.
+        /// @param rebuild Ignore the files written in previous runs, and replace them.
+        /// @see TemplateCache
+        void setTemplateCache(const std::string& directory, const std::string& engineVersion, bool rebuild);
+
         /// Check if a given scene is loaded and if so, update its usage timestamp to prevent it from being unloaded
         bool checkLoaded(const std::string& name, double referenceTime);
 
@@ -152,6 +158,9 @@ namespace Resource
 
         Shader::ShaderVisitor* createShaderVisitor();
 
+        /// Identifies the settings getTemplate() processes scene graphs with, see TemplateCache.
+        std::string getTemplateCacheSettings() const;
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -164,6 +173,8 @@ namespace Resource
 
         osg::ref_ptr<MultiObjectCache> mInstanceCache;
 
+        std::unique_ptr<TemplateCache> mTemplateCache;
+
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable OpenThreads::Mutex mSharedStateMutex;
 
@@ -13,6 +13,9 @@
 namespace Resource
 {
 
+static const float sBackgroundMargin = 5;
+static const float sBackgroundSpacing = 3;
+
 StatsHandler::StatsHandler():
     _key(osgGA::GUIEventAdapter::KEY_F4),
     _initialized(false),
@@ -246,11 +249,6 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
 #endif
 
     osg::Vec3 pos(_statsWidth-300.f, _statsHeight-500.0f,0.0f);
-    osg::Vec4 backgroundColor(0.0, 0.0, 0.0f, 0.3);
-    osg::Vec4 staticTextColor(1.0, 1.0, 0.0f, 1.0);
-    osg::Vec4 dynamicTextColor(1.0, 1.0, 1.0f, 1.0);
-    float backgroundMargin = 5;
-    float backgroundSpacing = 3;
 
     // resource stats
     {
@@ -259,50 +257,75 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
         _resourceStatsChildNum = _switch->getNumChildren();
         _switch->addChild(group, false);
 
-        const char* statNames[] = {"Compiling", "WorkQueue", "WorkThread", "", "Texture", "StateSet", "Node", "Node Instance", "Shape", "Shape Instance", "Image", "Nif", "Keyframe", "", "Terrain Chunk", "Terrain Texture", "Land", "Composite", "", "UnrefQueue"};
-
-        int numLines = sizeof(statNames) / sizeof(statNames[0]);
-
-        group->addChild(createBackgroundRectangle(pos + osg::Vec3(-backgroundMargin, _characterSize + backgroundMargin, 0),
-                                                        10 * _characterSize + 2 * backgroundMargin,
-                                                        numLines * _characterSize + 2 * backgroundMargin,
-                                                        backgroundColor));
+        const char* statNames[] = {"Compiling", "WorkQueue", "WorkThread", "Queue High", "Queue Normal", "Queue Preload", "Wait High", "Wait Normal", "Wait Preload", "", "Texture", "StateSet", "Node", "Node Instance", "Shape", "Shape Instance", "Image", "Nif", "Keyframe", "", "Terrain Chunk", "Terrain Texture", "Land", "Composite", "", "UnrefQueue"};
 
-        osg::ref_ptr<osgText::Text> staticText = new osgText::Text;
-        group->addChild( staticText.get() );
-        staticText->setColor(staticTextColor);
-        staticText->setFont(_font);
-        staticText->setCharacterSize(_characterSize);
-        staticText->setPosition(pos);
+        setUpStatsPanel(group, pos, std::vector<std::string>(statNames, statNames + sizeof(statNames) / sizeof(statNames[0])), viewer);
 
-        std::ostringstream viewStr;
-        viewStr.clear();
-        viewStr.setf(std::ios::left, std::ios::adjustfield);
-        viewStr.width(14);
-        for (size_t i = 0; i<sizeof(statNames)/sizeof(statNames[0]); ++i)
+        // memory use and efficiency of the resource caches, to the left of the counts
+        std::vector<std::string> cacheStatNames;
+        const char* cacheNames[] = {"Node", "Image", "Shape", "Nif", "Keyframe"};
+        for (size_t i = 0; i<sizeof(cacheNames)/sizeof(cacheNames[0]); ++i)
         {
-            viewStr << statNames[i] << std::endl;
+            if (i > 0)
+                cacheStatNames.push_back("");
+            cacheStatNames.push_back(std::string(cacheNames[i]) + " KB");
+            cacheStatNames.push_back(std::string(cacheNames[i]) + " Hit");
+            cacheStatNames.push_back(std::string(cacheNames[i]) + " Miss");
+            cacheStatNames.push_back(std::string(cacheNames[i]) + " Evict");
         }
 
-        staticText->setText(viewStr.str());
+        osg::Vec3 cachePos = pos - osg::Vec3(15 * _characterSize + 6 * sBackgroundMargin + 2 * sBackgroundSpacing, 0, 0);
+        setUpStatsPanel(group, cachePos, cacheStatNames, viewer);
+    }
+}
 
-        pos.x() += 10 * _characterSize + 2 * backgroundMargin + backgroundSpacing;
+void StatsHandler::setUpStatsPanel(osg::Group* group, osg::Vec3 pos, const std::vector<std::string>& statNames, osgViewer::ViewerBase* viewer)
+{
+    osg::Vec4 backgroundColor(0.0, 0.0, 0.0f, 0.3);
+    osg::Vec4 staticTextColor(1.0, 1.0, 0.0f, 1.0);
+    osg::Vec4 dynamicTextColor(1.0, 1.0, 1.0f, 1.0);
+
+    int numLines = statNames.size();
+
+    group->addChild(createBackgroundRectangle(pos + osg::Vec3(-sBackgroundMargin, _characterSize + sBackgroundMargin, 0),
+                                                    10 * _characterSize + 2 * sBackgroundMargin,
+                                                    numLines * _characterSize + 2 * sBackgroundMargin,
+                                                    backgroundColor));
+
+    osg::ref_ptr<osgText::Text> staticText = new osgText::Text;
+    group->addChild( staticText.get() );
+    staticText->setColor(staticTextColor);
+    staticText->setFont(_font);
+    staticText->setCharacterSize(_characterSize);
+    staticText->setPosition(pos);
+
+    std::ostringstream viewStr;
+    viewStr.clear();
+    viewStr.setf(std::ios::left, std::ios::adjustfield);
+    viewStr.width(14);
+    for (size_t i = 0; i<statNames.size(); ++i)
+    {
+        viewStr << statNames[i] << std::endl;
+    }
 
-        group->addChild(createBackgroundRectangle(pos + osg::Vec3(-backgroundMargin, _characterSize + backgroundMargin, 0),
-                                                        5 * _characterSize + 2 * backgroundMargin,
-                                                        numLines * _characterSize + 2 * backgroundMargin,
-                                                        backgroundColor));
+    staticText->setText(viewStr.str());
 
-        osg::ref_ptr<osgText::Text> statsText = new osgText::Text;
-        group->addChild( statsText.get() );
+    pos.x() += 10 * _characterSize + 2 * sBackgroundMargin + sBackgroundSpacing;
 
-        statsText->setColor(dynamicTextColor);
-        statsText->setFont(_font);
-        statsText->setCharacterSize(_characterSize);
-        statsText->setPosition(pos);
-        statsText->setText("");
-        statsText->setDrawCallback(new ResourceStatsTextDrawCallback(viewer->getViewerStats(), std::vector<std::string>(statNames, statNames + numLines)));
-    }
+    group->addChild(createBackgroundRectangle(pos + osg::Vec3(-sBackgroundMargin, _characterSize + sBackgroundMargin, 0),
+                                                    5 * _characterSize + 2 * sBackgroundMargin,
+                                                    numLines * _characterSize + 2 * sBackgroundMargin,
+                                                    backgroundColor));
+
+    osg::ref_ptr<osgText::Text> statsText = new osgText::Text;
+    group->addChild( statsText.get() );
+
+    statsText->setColor(dynamicTextColor);
+    statsText->setFont(_font);
+    statsText->setCharacterSize(_characterSize);
+    statsText->setPosition(pos);
+    statsText->setText("");
+    statsText->setDrawCallback(new ResourceStatsTextDrawCallback(viewer->getViewerStats(), statNames));
 }
 
 
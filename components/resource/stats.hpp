@@ -1,8 +1,12 @@
 #ifndef OPENMW_COMPONENTS_RESOURCE_STATS_H
 #define OPENMW_COMPONENTS_RESOURCE_STATS_H
 
+#include <osg/Vec3>
 #include <osgGA/GUIEventHandler>
 
+#include <string>
+#include <vector>
+
 namespace osgViewer
 {
     class ViewerBase;
@@ -11,6 +15,7 @@ namespace osgViewer
 namespace osg
 {
     class Switch;
+    class Group;
 }
 
 namespace Resource
@@ -37,6 +42,9 @@ namespace Resource
         virtual void getUsage(osg::ApplicationUsage& usage) const;
 
     private:
+        /// Add a column of stat names and a column of their values, starting at \a pos.
+        void setUpStatsPanel(osg::Group* group, osg::Vec3 pos, const std::vector<std::string>& statNames, osgViewer::ViewerBase* viewer);
+
         osg::ref_ptr<osg::Switch> _switch;
         int _key;
         osg::ref_ptr<osg::Camera>  _camera;
@@ -0,0 +1,307 @@
+#include "templatecache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include <stdint.h>
+
+#include <osg/Group>
+#include <osg/NodeVisitor>
+#include <osg/Drawable>
+#include <osg/StateSet>
+#include <osg/Texture>
+#include <osg/Image>
+#include <osg/UserDataContainer>
+#include <osg/ValueObject>
+
+#include <osgDB/Registry>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/nifosg/nifloader.hpp>
+#include <components/nifosg/userdata.hpp>
+
+#include <components/sceneutil/serialize.hpp>
+
+#include <components/vfs/manager.hpp>
+
+namespace
+{
+
+    bool isStandardClass(const osg::Object* object)
+    {
+        return object->libraryName() == std::string("osg");
+    }
+
+    /// Finds anything in a scene graph that a binary OSG file can not hold: custom classes and callbacks,
+    /// and images that are not loaded from a file.
+    class CanStoreVisitor : public osg::NodeVisitor
+    {
+    public:
+        CanStoreVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mCanStore(true)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            if (!checkNode(node))
+                return;
+            traverse(node);
+        }
+
+        virtual void apply(osg::Drawable& drawable)
+        {
+            // derived classes like RigGeometry or ParticleSystem have no complete serializer
+            if (drawable.className() != std::string("Geometry") || drawable.getDrawCallback() || drawable.getComputeBoundingBoxCallback())
+                mCanStore = false;
+            else
+                checkNode(drawable);
+        }
+
+        bool checkNode(osg::Node& node)
+        {
+            if (!mCanStore)
+                return false;
+
+            if (!isStandardClass(&node) || node.getUpdateCallback() || node.getEventCallback() || node.getCullCallback()
+                    || node.getComputeBoundingSphereCallback() || !checkUserData(node) || !checkStateSet(node.getStateSet()))
+            {
+                mCanStore = false;
+                return false;
+            }
+            return true;
+        }
+
+        bool checkUserData(osg::Object& object)
+        {
+            const osg::UserDataContainer* container = object.getUserDataContainer();
+            if (!container)
+                return true;
+            if (container->getUserData())
+                return false;
+            for (unsigned int i=0; i<container->getNumUserObjects(); ++i)
+            {
+                // standard user objects include the values set with setUserValue()
+                const osg::Object* object = container->getUserObject(i);
+                if (!isStandardClass(object) && !dynamic_cast<const NifOsg::NodeUserData*>(object))
+                    return false;
+            }
+            return true;
+        }
+
+        bool checkStateSet(const osg::StateSet* stateset)
+        {
+            if (!stateset)
+                return true;
+            if (stateset->getUpdateCallback() || stateset->getEventCallback())
+                return false;
+
+            if (!checkAttributes(stateset->getAttributeList()))
+                return false;
+            for (unsigned int unit=0; unit<stateset->getTextureAttributeList().size(); ++unit)
+            {
+                if (!checkAttributes(stateset->getTextureAttributeList()[unit]))
+                    return false;
+            }
+
+            const osg::StateSet::UniformList& uniforms = stateset->getUniformList();
+            for (osg::StateSet::UniformList::const_iterator it = uniforms.begin(); it != uniforms.end(); ++it)
+            {
+                if (!isStandardClass(it->second.first.get()) || it->second.first->getUpdateCallback() || it->second.first->getEventCallback())
+                    return false;
+            }
+            return true;
+        }
+
+        bool checkAttributes(const osg::StateSet::AttributeList& attributes)
+        {
+            for (osg::StateSet::AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+            {
+                const osg::StateAttribute* attribute = it->second.first.get();
+                if (!isStandardClass(attribute) || attribute->getUpdateCallback() || attribute->getEventCallback())
+                    return false;
+
+                // images are written by name, and read back through the image manager
+                if (const osg::Texture* texture = attribute->asTexture())
+                {
+                    for (unsigned int i=0; i<texture->getNumImages(); ++i)
+                    {
+                        const osg::Image* image = texture->getImage(i);
+                        if (!image || image->getFileName().empty())
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool mCanStore;
+    };
+
+    uint64_t hash(const std::string& str)
+    {
+        // FNV-1a
+        uint64_t value = 14695981039346656037ull;
+
+        for (std::string::const_iterator iter (str.begin()); iter!=str.end(); ++iter)
+        {
+            value ^= static_cast<unsigned char> (*iter);
+            value *= 1099511628211ull;
+        }
+
+        return value;
+    }
+
+}
+
+namespace Resource
+{
+
+    TemplateCache::TemplateCache(const boost::filesystem::path& directory, const std::string& engineVersion, const VFS::Manager* vfs,
+                                 osgDB::Options* readOptions, bool rebuild)
+        : mDirectory(directory)
+        , mEngineVersion(engineVersion)
+        , mVFS(vfs)
+        , mReadOptions(readOptions)
+        , mWriteOptions(new osgDB::Options("WriteImageHint=UseExternal"))
+        , mRebuild(rebuild)
+    {
+        // NifOsg::NodeUserData needs a serializer
+        SceneUtil::registerSerializers();
+
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(mDirectory, ec);
+        if (ec)
+            std::cerr << "Failed to create the mesh cache directory " << mDirectory << ": " << ec.message() << std::endl;
+    }
+
+    TemplateCache::~TemplateCache()
+    {
+    }
+
+    std::string TemplateCache::getKey(const std::string &normalizedName, const std::string &stamp, const std::string &settings) const
+    {
+        // the conversion depends on this setting
+        std::ostringstream key;
+        key << mEngineVersion << "|" << normalizedName << "|" << stamp << "|" << NifOsg::Loader::getShowMarkers() << "|" << settings;
+        return key.str();
+    }
+
+    std::string TemplateCache::getDependencyStamps(const std::set<std::string> &dependencies) const
+    {
+        std::string stamps;
+        for (std::set<std::string>::const_iterator it = dependencies.begin(); it != dependencies.end(); ++it)
+        {
+            std::string normalized = *it;
+            mVFS->normalizeFilename(normalized);
+            stamps += *it + '\n' + mVFS->getStamp(normalized) + '\n';
+        }
+        return stamps;
+    }
+
+    boost::filesystem::path TemplateCache::getPath(const std::string &normalizedName) const
+    {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << hash(normalizedName) << ".osgb";
+        return mDirectory / name.str();
+    }
+
+    osg::ref_ptr<osg::Node> TemplateCache::read(const std::string &normalizedName, const std::string &stamp, const std::string &settings) const
+    {
+        if (mRebuild || stamp.empty())
+            return NULL;
+
+        boost::filesystem::path path = getPath(normalizedName);
+        boost::system::error_code ec;
+        if (!boost::filesystem::exists(path, ec))
+            return NULL;
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return NULL;
+
+        boost::filesystem::ifstream stream(path, std::ios::binary);
+        osgDB::ReaderWriter::ReadResult result = rw->readNode(stream, mReadOptions);
+        if (!result.success())
+        {
+            std::cerr << "Failed to read the cached mesh " << path << " for " << normalizedName << ": " << result.message() << std::endl;
+            return NULL;
+        }
+
+        // the file is replaced on the next write if the source changed, or if the name collided with another file's
+        osg::ref_ptr<osg::Group> holder = dynamic_cast<osg::Group*>(result.getNode());
+        if (!holder || holder->getName() != getKey(normalizedName, stamp, settings) || holder->getNumChildren() != 1)
+            return NULL;
+
+        // the dependencies are stored as pairs of lines with the name and the stamp of each file
+        std::string dependencyStamps;
+        holder->getUserValue("dependencies", dependencyStamps);
+        std::set<std::string> dependencies;
+        std::istringstream lines(dependencyStamps);
+        std::string dependency, dependencyStamp;
+        while (std::getline(lines, dependency) && std::getline(lines, dependencyStamp))
+            dependencies.insert(dependency);
+        if (getDependencyStamps(dependencies) != dependencyStamps)
+            return NULL;
+
+        osg::ref_ptr<osg::Node> node = holder->getChild(0);
+        holder->removeChildren(0, 1);
+        return node;
+    }
+
+    void TemplateCache::write(const std::string &normalizedName, const std::string &stamp, const std::string &settings,
+                              const std::set<std::string> &dependencies, osg::Node *node) const
+    {
+        if (stamp.empty() || !canStore(node))
+            return;
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return;
+
+        // the key is stored as the name of a group holding the scene graph
+        osg::ref_ptr<osg::Group> holder = new osg::Group;
+        holder->setName(getKey(normalizedName, stamp, settings));
+        holder->setUserValue("dependencies", getDependencyStamps(dependencies));
+        holder->addChild(node);
+
+        // write to a file of its own first, so that other threads or processes never see a partially written file
+        boost::filesystem::path path = getPath(normalizedName);
+        boost::filesystem::path tempPath = path;
+        tempPath += boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp");
+
+        osgDB::ReaderWriter::WriteResult result;
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+            result = rw->writeNode(*holder, stream, mWriteOptions);
+        }
+        holder->removeChildren(0, 1);
+
+        boost::system::error_code ec;
+        if (!result.success())
+        {
+            std::cerr << "Failed to write " << normalizedName << " to the mesh cache: " << result.message() << std::endl;
+            boost::filesystem::remove(tempPath, ec);
+            return;
+        }
+
+        boost::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            std::cerr << "Failed to write " << normalizedName << " to the mesh cache: " << ec.message() << std::endl;
+            boost::filesystem::remove(tempPath, ec);
+        }
+    }
+
+    bool TemplateCache::canStore(osg::Node *node)
+    {
+        CanStoreVisitor visitor;
+        node->accept(visitor);
+        return visitor.mCanStore;
+    }
+
+}
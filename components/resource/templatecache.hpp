@@ -0,0 +1,79 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_TEMPLATECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_TEMPLATECACHE_H
+
+#include <set>
+#include <string>
+
+#include <osg/ref_ptr>
+
+#include <boost/filesystem/path.hpp>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace osgDB
+{
+    class Options;
+}
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace Resource
+{
+
+    /// @brief Scene graphs converted from NIF files in previous runs, stored as binary OSG files, to skip the conversion on the next start.
+    /// @par The scene graphs are stored after the texture filtering, shader and optimizer passes of the SceneManager.
+    /// A scene graph is only taken from the cache if it was written by the same engine version from the same source file,
+    /// with the same size and modification time, see VFS::File::getStamp(), and processed with the same settings. The other files the
+    /// processing depends on, like automatically used normal maps, must not have been added, removed or changed either. Only scene graphs
+    /// made entirely of standard OSG classes are stored, as the custom classes used for animation, skinning and particles can not be read back.
+    /// @note Thread safe.
+    class TemplateCache
+    {
+    public:
+        /// @param directory Where to store the files, created if it does not exist.
+        /// @param readOptions Used for reading the scene graphs, should make images referenced by name load through the image manager.
+        /// @param rebuild Ignore the files written in previous runs, and replace them.
+        /// @param vfs Used to check the files the scene graphs depend on.
+        TemplateCache(const boost::filesystem::path& directory, const std::string& engineVersion, const VFS::Manager* vfs,
+                      osgDB::Options* readOptions, bool rebuild);
+        ~TemplateCache();
+
+        /// @param stamp Identifies the contents of the source file, see VFS::File::getStamp().
+        /// @param settings Identifies the settings the scene graph was processed with after the conversion.
+        /// @return The scene graph, or NULL if it is not in the cache or out of date. Errors are logged, but not fatal.
+        osg::ref_ptr<osg::Node> read(const std::string& normalizedName, const std::string& stamp, const std::string& settings) const;
+
+        /// Store a freshly converted and processed scene graph, unless it uses classes that can not be stored. Errors are logged, but not fatal.
+        /// @param dependencies Names of other files that the processing looked up in the VFS, whether they exist or not.
+        /// @note The scene graph must not be in use by other threads, and must not share state with other scene graphs.
+        void write(const std::string& normalizedName, const std::string& stamp, const std::string& settings,
+                   const std::set<std::string>& dependencies, osg::Node* node) const;
+
+        /// Can the scene graph be written and read back without losing anything?
+        static bool canStore(osg::Node* node);
+
+    private:
+        std::string getKey(const std::string& normalizedName, const std::string& stamp, const std::string& settings) const;
+
+        boost::filesystem::path getPath(const std::string& normalizedName) const;
+
+        /// @return The dependencies with their stamps, empty for files that do not exist.
+        std::string getDependencyStamps(const std::set<std::string>& dependencies) const;
+
+        boost::filesystem::path mDirectory;
+        std::string mEngineVersion;
+        const VFS::Manager* mVFS;
+        osg::ref_ptr<osgDB::Options> mReadOptions;
+        osg::ref_ptr<osgDB::Options> mWriteOptions;
+        bool mRebuild;
+    };
+
+}
+
+#endif
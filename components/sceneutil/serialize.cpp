@@ -8,6 +8,8 @@
 #include <components/sceneutil/riggeometry.hpp>
 #include <components/sceneutil/morphgeometry.hpp>
 
+#include <components/nifosg/userdata.hpp>
+
 namespace SceneUtil
 {
 
@@ -79,12 +81,38 @@ osgDB::ObjectWrapper* makeDummySerializer(const std::string& classname)
     return new osgDB::ObjectWrapper(createInstanceFunc<osg::DummyObject>, classname, "osg::Object");
 }
 
-class GeometrySerializer : public osgDB::ObjectWrapper
+static bool checkNodeUserData(const NifOsg::NodeUserData& data)
+{
+    return true;
+}
+
+static bool readNodeUserData(osgDB::InputStream& is, NifOsg::NodeUserData& data)
+{
+    is >> data.mIndex >> data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            is >> data.mRotationScale.mValues[i][j];
+    return true;
+}
+
+static bool writeNodeUserData(osgDB::OutputStream& os, const NifOsg::NodeUserData& data)
+{
+    os << data.mIndex << data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            os << data.mRotationScale.mValues[i][j];
+    os << std::endl;
+    return true;
+}
+
+class NodeUserDataSerializer : public osgDB::ObjectWrapper
 {
 public:
-    GeometrySerializer()
-        : osgDB::ObjectWrapper(createInstanceFunc<osg::Drawable>, "osg::Geometry", "osg::Object osg::Drawable osg::Geometry")
+    NodeUserDataSerializer()
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::NodeUserData>, "NifOsg::NodeUserData", "osg::Object NifOsg::NodeUserData")
     {
+        addSerializer( new osgDB::UserSerializer<NifOsg::NodeUserData>(
+            "Data", &checkNodeUserData, &readNodeUserData, &writeNodeUserData), osgDB::BaseSerializer::RW_USER );
     }
 };
 
@@ -100,10 +128,8 @@ void registerSerializers()
         mgr->addWrapper(new MorphGeometrySerializer);
         mgr->addWrapper(new LightManagerSerializer);
         mgr->addWrapper(new CameraRelativeTransformSerializer);
-
-        // Don't serialize Geometry data as we are more interested in the overall structure rather than tons of vertex data that would make the file large and hard to read.
-        mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
-        mgr->addWrapper(new GeometrySerializer);
+        // complete, so that scene graphs can be read back, see Resource::TemplateCache
+        mgr->addWrapper(new NodeUserDataSerializer);
 
         // ignore the below for now to avoid warning spam
         const char* ignore[] = {
@@ -115,7 +141,6 @@ void registerSerializers()
             "SceneUtil::UpdateRigGeometry",
             "SceneUtil::LightSource",
             "SceneUtil::StateSetUpdater",
-            "NifOsg::NodeUserData",
             "NifOsg::FlipController",
             "NifOsg::KeyframeController",
             "NifOsg::TextKeyMapHolder",
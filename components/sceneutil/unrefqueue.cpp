@@ -39,7 +39,7 @@ namespace SceneUtil
         if (mWorkItem->mObjects.empty())
             return;
 
-        workQueue->addWorkItem(mWorkItem, true);
+        workQueue->addWorkItem(mWorkItem, SceneUtil::WorkQueue::Priority_High);
 
         mWorkItem = new UnrefWorkItem;
     }
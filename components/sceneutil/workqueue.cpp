@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include <osg/Stats>
+
 namespace SceneUtil
 {
 
@@ -39,12 +41,26 @@ bool WorkItem::isDone() const
     return (mDone > 0);
 }
 
+void WorkItem::cancel()
+{
+    mCancelled.exchange(1);
+    abort();
+}
+
+bool WorkItem::isCancelled() const
+{
+    return (mCancelled > 0);
+}
+
 WorkQueue::WorkQueue(int workerThreads)
     : mIsReleased(false)
 {
+    for (int i=0; i<workerThreads; ++i)
+        mQueues.push_back(new ThreadQueue);
+
     for (int i=0; i<workerThreads; ++i)
     {
-        WorkThread* thread = new WorkThread(this);
+        WorkThread* thread = new WorkThread(this, i);
         mThreads.push_back(thread);
         thread->startThread();
     }
@@ -54,8 +70,12 @@ WorkQueue::~WorkQueue()
 {
     {
         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
-        while (!mQueue.empty())
-            mQueue.pop_back();
+        for (unsigned int i=0; i<mQueues.size(); ++i)
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> queueLock(mQueues[i]->mMutex);
+            for (int priority=0; priority<Priority_Count; ++priority)
+                mQueues[i]->mItems[priority].clear();
+        }
         mIsReleased = true;
         mCondition.broadcast();
     }
@@ -65,9 +85,12 @@ WorkQueue::~WorkQueue()
         mThreads[i]->join();
         delete mThreads[i];
     }
+
+    for (unsigned int i=0; i<mQueues.size(); ++i)
+        delete mQueues[i];
 }
 
-void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
+void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, Priority priority)
 {
     if (item->isDone())
     {
@@ -75,35 +98,103 @@ void WorkQueue::addWorkItem(osg::ref_ptr<WorkItem> item, bool front)
         return;
     }
 
+    if (mQueues.empty())
+    {
+        std::cerr << "Error: trying to add a work item to a work queue without threads" << std::endl;
+        return;
+    }
+
+    ThreadQueue* queue = mQueues[(++mNextQueue) % mQueues.size()];
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> queueLock(queue->mMutex);
+        queue->mItems[priority].push_back(QueuedItem(item, osg::Timer::instance()->tick()));
+        ++mNumItemsPerPriority[priority];
+        ++mNumItems;
+    }
+
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
-    if (front)
-        mQueue.push_front(item);
-    else
-        mQueue.push_back(item);
     mCondition.signal();
 }
 
-osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem()
+osg::ref_ptr<WorkItem> WorkQueue::removeWorkItem(unsigned int threadIndex)
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
-    while (mQueue.empty() && !mIsReleased)
+    while (true)
     {
-        mCondition.wait(&mMutex);
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            while (mNumItems == 0 && !mIsReleased)
+            {
+                mCondition.wait(&mMutex);
+            }
+            if (mIsReleased)
+                return NULL;
+        }
+
+        // Another thread may have taken the item in the meantime, in which case we go back to sleep.
+        osg::ref_ptr<WorkItem> item;
+        if (!tryPopWorkItem(threadIndex, item))
+            continue;
+
+        if (item->isCancelled())
+        {
+            item->signalDone();
+            continue;
+        }
+
+        return item;
     }
-    if (!mQueue.empty())
+}
+
+bool WorkQueue::tryPopWorkItem(unsigned int threadIndex, osg::ref_ptr<WorkItem>& item)
+{
+    unsigned int numQueues = mQueues.size();
+    for (int priority=0; priority<Priority_Count; ++priority)
     {
-        osg::ref_ptr<WorkItem> item = mQueue.front();
-        mQueue.pop_front();
-        return item;
+        // Our own queue first, then steal from the others. Stolen items are taken from the front as well,
+        // so the oldest item in a priority class is always the next one to be started.
+        for (unsigned int i=0; i<numQueues; ++i)
+        {
+            ThreadQueue* queue = mQueues[(threadIndex + i) % numQueues];
+            osg::Timer_t queuedTick;
+            {
+                OpenThreads::ScopedLock<OpenThreads::Mutex> queueLock(queue->mMutex);
+                std::deque<QueuedItem>& items = queue->mItems[priority];
+                if (items.empty())
+                    continue;
+
+                item = items.front().mItem;
+                queuedTick = items.front().mQueuedTick;
+                items.pop_front();
+                --mNumItemsPerPriority[priority];
+                --mNumItems;
+            }
+
+            if (!item->isCancelled())
+                recordLatency(priority, queuedTick);
+            return true;
+        }
     }
-    else
-        return NULL;
+    return false;
+}
+
+void WorkQueue::recordLatency(int priority, osg::Timer_t queuedTick)
+{
+    double latency = osg::Timer::instance()->delta_m(queuedTick, osg::Timer::instance()->tick());
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+    PriorityStats& stats = mStats[priority];
+    ++stats.mNumRemoved;
+    stats.mTotalLatency += latency;
 }
 
 unsigned int WorkQueue::getNumItems() const
 {
-    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
-    return mQueue.size();
+    return mNumItems;
+}
+
+unsigned int WorkQueue::getNumItems(Priority priority) const
+{
+    return mNumItemsPerPriority[priority];
 }
 
 unsigned int WorkQueue::getNumActiveThreads() const
@@ -117,8 +208,37 @@ unsigned int WorkQueue::getNumActiveThreads() const
     return count;
 }
 
-WorkThread::WorkThread(WorkQueue *workQueue)
+void WorkQueue::reportStats(unsigned int frameNumber, osg::Stats *stats)
+{
+    static const char* priorityNames[Priority_Count] = { "High", "Normal", "Preload" };
+
+    stats->setAttribute(frameNumber, "WorkQueue", getNumItems());
+    stats->setAttribute(frameNumber, "WorkThread", getNumActiveThreads());
+
+    PriorityStats frameStats[Priority_Count];
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mStatsMutex);
+        for (int priority=0; priority<Priority_Count; ++priority)
+        {
+            frameStats[priority] = mStats[priority];
+            mStats[priority] = PriorityStats();
+        }
+    }
+
+    for (int priority=0; priority<Priority_Count; ++priority)
+    {
+        const std::string name = priorityNames[priority];
+        const PriorityStats& priorityStats = frameStats[priority];
+        double averageLatency = priorityStats.mNumRemoved ? priorityStats.mTotalLatency / priorityStats.mNumRemoved : 0.0;
+
+        stats->setAttribute(frameNumber, "Queue " + name, getNumItems(static_cast<Priority>(priority)));
+        stats->setAttribute(frameNumber, "Wait " + name, averageLatency);
+    }
+}
+
+WorkThread::WorkThread(WorkQueue *workQueue, unsigned int threadIndex)
     : mWorkQueue(workQueue)
+    , mThreadIndex(threadIndex)
     , mActive(false)
 {
 }
@@ -127,7 +247,7 @@ void WorkThread::run()
 {
     while (true)
     {
-        osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
+        osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem(mThreadIndex);
         if (!item)
             return;
         mActive = true;
@@ -8,8 +8,15 @@
 
 #include <osg/Referenced>
 #include <osg/ref_ptr>
+#include <osg/Timer>
 
-#include <queue>
+#include <deque>
+#include <vector>
+
+namespace osg
+{
+    class Stats;
+}
 
 namespace SceneUtil
 {
@@ -34,8 +41,15 @@ namespace SceneUtil
         /// Set abort flag in order to return from doWork() as soon as possible. May not be respected by all WorkItems.
         virtual void abort() {}
 
+        /// Mark the item as no longer needed. If it is still waiting in a WorkQueue, it will be dropped without
+        /// calling doWork() (but will still be signalled as done). If it is already running, abort() is called.
+        void cancel();
+
+        bool isCancelled() const;
+
     protected:
         OpenThreads::Atomic mDone;
+        OpenThreads::Atomic mCancelled;
         OpenThreads::Mutex mMutex;
         OpenThreads::Condition mCondition;
     };
@@ -43,35 +57,96 @@ namespace SceneUtil
     class WorkThread;
 
     /// @brief A work queue that users can push work items onto, to be completed by one or more background threads.
-    /// @note Work items will be processed in the order that they were given in, however
+    /// @par Each worker thread owns its own set of queues, one per priority class, each guarded by its own lock.
+    /// New items are distributed over the threads in a round-robin fashion, and a thread that runs out of work steals
+    /// from the queues of the other threads. Items of a higher priority class are always taken before items of a lower one.
+    /// @note Within a priority class, work items will be started roughly in the order that they were given in, however
     /// if multiple work threads are involved then it is possible for a later item to complete before earlier items.
     class WorkQueue : public osg::Referenced
     {
     public:
+        enum Priority
+        {
+            Priority_High = 0,  ///< Work that is needed as soon as possible, e.g. data requested for the current frame.
+            Priority_Normal,
+            Priority_Preload,   ///< Speculative work that may well be cancelled before it is started.
+            Priority_Count
+        };
+
         WorkQueue(int numWorkerThreads=1);
         ~WorkQueue();
 
-        /// Add a new work item to the back of the queue.
+        /// Add a new work item to the back of the queue of the given priority class.
         /// @par The work item's waitTillDone() method may be used by the caller to wait until the work is complete.
-        /// @param front If true, add item to the front of the queue. If false (default), add to the back.
-        void addWorkItem(osg::ref_ptr<WorkItem> item, bool front=false);
+        void addWorkItem(osg::ref_ptr<WorkItem> item, Priority priority=Priority_Normal);
 
-        /// Get the next work item from the front of the queue. If the queue is empty, waits until a new item is added.
+        /// Get the next work item for the given worker thread, stealing from the other threads if its own queues are empty.
+        /// If there is no work, waits until a new item is added. Cancelled items are skipped.
         /// If the workqueue is in the process of being destroyed, may return NULL.
         /// @par Used internally by the WorkThread.
-        osg::ref_ptr<WorkItem> removeWorkItem();
+        osg::ref_ptr<WorkItem> removeWorkItem(unsigned int threadIndex);
 
         unsigned int getNumItems() const;
 
+        unsigned int getNumItems(Priority priority) const;
+
         unsigned int getNumActiveThreads() const;
 
+        /// Report queue depth per priority class and the average time items waited in the queue
+        /// since the last call.
+        void reportStats(unsigned int frameNumber, osg::Stats* stats);
+
     private:
+        struct QueuedItem
+        {
+            QueuedItem(osg::ref_ptr<WorkItem> item, osg::Timer_t queuedTick)
+                : mItem(item)
+                , mQueuedTick(queuedTick)
+            {
+            }
+
+            osg::ref_ptr<WorkItem> mItem;
+            osg::Timer_t mQueuedTick;
+        };
+
+        struct ThreadQueue
+        {
+            OpenThreads::Mutex mMutex;
+            std::deque<QueuedItem> mItems[Priority_Count];
+        };
+
+        struct PriorityStats
+        {
+            PriorityStats()
+                : mNumRemoved(0)
+                , mTotalLatency(0.0)
+            {
+            }
+
+            unsigned int mNumRemoved;
+            double mTotalLatency;
+        };
+
+        /// Pop the oldest item of the highest priority class available, looking at the given thread's queues first.
+        bool tryPopWorkItem(unsigned int threadIndex, osg::ref_ptr<WorkItem>& item);
+
+        void recordLatency(int priority, osg::Timer_t queuedTick);
+
         bool mIsReleased;
-        std::deque<osg::ref_ptr<WorkItem> > mQueue;
 
+        std::vector<ThreadQueue*> mQueues;
+        OpenThreads::Atomic mNextQueue;
+
+        OpenThreads::Atomic mNumItems;
+        OpenThreads::Atomic mNumItemsPerPriority[Priority_Count];
+
+        // Only used to put idle threads to sleep and to wake them up again.
         mutable OpenThreads::Mutex mMutex;
         OpenThreads::Condition mCondition;
 
+        OpenThreads::Mutex mStatsMutex;
+        PriorityStats mStats[Priority_Count];
+
         std::vector<WorkThread*> mThreads;
     };
 
@@ -79,7 +154,7 @@ namespace SceneUtil
     class WorkThread : public OpenThreads::Thread
     {
     public:
-        WorkThread(WorkQueue* workQueue);
+        WorkThread(WorkQueue* workQueue, unsigned int threadIndex);
 
         virtual void run();
 
@@ -87,6 +162,7 @@ namespace SceneUtil
 
     private:
         WorkQueue* mWorkQueue;
+        unsigned int mThreadIndex;
         volatile bool mActive;
     };
 
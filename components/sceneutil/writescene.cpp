@@ -2,12 +2,55 @@
 
 #include <stdexcept>
 
+#include <osg/Geometry>
+
 #include <osgDB/Registry>
 
 #include <boost/filesystem/fstream.hpp>
 
 #include "serialize.hpp"
 
+namespace
+{
+
+    /// Copies the scene graph without the vertex data of geometries, as we are more interested in the overall structure
+    /// rather than tons of vertex data that would make the file large and hard to read.
+    class StripGeometryCopyOp : public osg::CopyOp
+    {
+    public:
+        StripGeometryCopyOp()
+            : osg::CopyOp(osg::CopyOp::DEEP_COPY_NODES)
+        {
+        }
+
+        virtual osg::Node* operator() (const osg::Node* node) const
+        {
+            if (node && node->asDrawable())
+                return operator()(node->asDrawable());
+            return osg::CopyOp::operator()(node);
+        }
+
+        virtual osg::Drawable* operator() (const osg::Drawable* drawable) const
+        {
+            const osg::Geometry* geometry = drawable ? drawable->asGeometry() : NULL;
+            if (!geometry || geometry->className() != std::string("Geometry"))
+                return const_cast<osg::Drawable*>(drawable);
+
+            osg::Geometry* stripped = new osg::Geometry(*geometry, osg::CopyOp::SHALLOW_COPY);
+            stripped->setVertexArray(NULL);
+            stripped->setNormalArray(NULL);
+            stripped->setColorArray(NULL);
+            stripped->setSecondaryColorArray(NULL);
+            stripped->setFogCoordArray(NULL);
+            stripped->setTexCoordArrayList(osg::Geometry::ArrayList());
+            stripped->setVertexAttribArrayList(osg::Geometry::ArrayList());
+            stripped->removePrimitiveSet(0, stripped->getNumPrimitiveSets());
+            return stripped;
+        }
+    };
+
+}
+
 void SceneUtil::writeScene(osg::Node *node, const std::string& filename, const std::string& format)
 {
     registerSerializers();
@@ -22,5 +65,8 @@ void SceneUtil::writeScene(osg::Node *node, const std::string& filename, const s
     osg::ref_ptr<osgDB::Options> options = new osgDB::Options;
     options->setPluginStringData("fileType", format);
 
-    rw->writeNode(*node, stream, options);
+    StripGeometryCopyOp copyOp;
+    osg::ref_ptr<osg::Node> stripped = copyOp(node);
+
+    rw->writeNode(*stripped, stream, options);
 }
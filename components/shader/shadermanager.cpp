@@ -19,6 +19,13 @@ namespace Shader
         mPath = path;
     }
 
+    void setUniqueName(osg::Shader& shader)
+    {
+        // Assign a unique name to allow the SharedStateManager to compare shaders efficiently
+        static unsigned int counter = 0;
+        shader.setName(std::to_string(counter++));
+    }
+
     bool parseIncludes(boost::filesystem::path shaderPath, std::string& source)
     {
         boost::replace_all(source, "\r\n", "\n");
@@ -137,11 +144,13 @@ namespace Shader
                 return NULL;
             }
 
-            osg::ref_ptr<osg::Shader> shader (new osg::Shader(shaderType));
-            shader->setShaderSource(shaderSource);
-            // Assign a unique name to allow the SharedStateManager to compare shaders efficiently
-            static unsigned int counter = 0;
-            shader->setName(std::to_string(counter++));
+            osg::ref_ptr<osg::Shader>& shader = mShadersBySource[std::make_pair(shaderType, shaderSource)];
+            if (!shader)
+            {
+                shader = new osg::Shader(shaderType);
+                shader->setShaderSource(shaderSource);
+                setUniqueName(*shader);
+            }
 
             shaderIt = mShaders.insert(std::make_pair(std::make_pair(shaderTemplate, defines), shader)).first;
         }
@@ -162,6 +171,38 @@ namespace Shader
         return found->second;
     }
 
+    osg::ref_ptr<osg::Program> ShaderManager::getProgram(osg::Program *program)
+    {
+        if (program->getNumShaders() != 2)
+            return program;
+
+        osg::ref_ptr<osg::Shader> vertexShader;
+        osg::ref_ptr<osg::Shader> fragmentShader;
+        {
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+            for (unsigned int i=0; i<program->getNumShaders(); ++i)
+            {
+                osg::Shader* shader = program->getShader(i);
+                osg::ref_ptr<osg::Shader>& shared = mShadersBySource[std::make_pair(shader->getType(), shader->getShaderSource())];
+                if (!shared)
+                {
+                    // the name may have been assigned by a previous run
+                    setUniqueName(*shader);
+                    shared = shader;
+                }
+
+                if (shader->getType() == osg::Shader::VERTEX)
+                    vertexShader = shared;
+                else if (shader->getType() == osg::Shader::FRAGMENT)
+                    fragmentShader = shared;
+            }
+        }
+
+        if (!vertexShader || !fragmentShader)
+            return program;
+        return getProgram(vertexShader, fragmentShader);
+    }
+
     void ShaderManager::releaseGLObjects(osg::State *state)
     {
         OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
@@ -32,6 +32,12 @@ namespace Shader
 
         osg::ref_ptr<osg::Program> getProgram(osg::ref_ptr<osg::Shader> vertexShader, osg::ref_ptr<osg::Shader> fragmentShader);
 
+        /// Retrieve the program with the same vertex and fragment shader source as \a program, e.g. a program read from a file,
+        /// so that it is shared with the programs created by the shader manager.
+        /// @note Returns \a program itself if it does not consist of one vertex and one fragment shader.
+        /// @note Thread safe.
+        osg::ref_ptr<osg::Program> getProgram(osg::Program* program);
+
         void releaseGLObjects(osg::State* state);
 
     private:
@@ -45,6 +51,10 @@ namespace Shader
         typedef std::map<MapKey, osg::ref_ptr<osg::Shader> > ShaderMap;
         ShaderMap mShaders;
 
+        // <<type, code>, shader>, each distinct shader source is only compiled once
+        typedef std::map<std::pair<osg::Shader::Type, std::string>, osg::ref_ptr<osg::Shader> > SourceMap;
+        SourceMap mShadersBySource;
+
         typedef std::map<std::pair<osg::ref_ptr<osg::Shader>, osg::ref_ptr<osg::Shader> >, osg::ref_ptr<osg::Program> > ProgramMap;
         ProgramMap mPrograms;
 
@@ -160,7 +160,7 @@ namespace Shader
                 bool normalHeight = false;
                 std::string normalHeightMap = normalMapFileName;
                 boost::replace_last(normalHeightMap, ".", mNormalHeightMapPattern + ".");
-                if (mImageManager.getVFS()->exists(normalHeightMap))
+                if (autoMapExists(normalHeightMap))
                 {
                     image = mImageManager.getImage(normalHeightMap);
                     normalHeight = true;
@@ -168,7 +168,7 @@ namespace Shader
                 else
                 {
                     boost::replace_last(normalMapFileName, ".", mNormalMapPattern + ".");
-                    if (mImageManager.getVFS()->exists(normalMapFileName))
+                    if (autoMapExists(normalMapFileName))
                     {
                         image = mImageManager.getImage(normalMapFileName);
                     }
@@ -198,7 +198,7 @@ namespace Shader
             {
                 std::string specularMapFileName = diffuseMap->getImage(0)->getFileName();
                 boost::replace_last(specularMapFileName, ".", mSpecularMapPattern + ".");
-                if (mImageManager.getVFS()->exists(specularMapFileName))
+                if (autoMapExists(specularMapFileName))
                 {
                     osg::ref_ptr<osg::Texture2D> specularMapTex (new osg::Texture2D(mImageManager.getImage(specularMapFileName)));
                     specularMapTex->setWrap(osg::Texture::WRAP_S, diffuseMap->getWrap(osg::Texture::WRAP_S));
@@ -425,4 +425,15 @@ namespace Shader
         mSpecularMapPattern = pattern;
     }
 
+    const std::set<std::string>& ShaderVisitor::getAutoMapFiles() const
+    {
+        return mAutoMapFiles;
+    }
+
+    bool ShaderVisitor::autoMapExists(const std::string &fileName)
+    {
+        mAutoMapFiles.insert(fileName);
+        return mImageManager.getVFS()->exists(fileName);
+    }
+
 }
@@ -1,6 +1,8 @@
 #ifndef OPENMW_COMPONENTS_SHADERVISITOR_H
 #define OPENMW_COMPONENTS_SHADERVISITOR_H
 
+#include <set>
+
 #include <osg/NodeVisitor>
 
 namespace Resource
@@ -45,6 +47,10 @@ namespace Shader
 
         void setSpecularMapPattern(const std::string& pattern);
 
+        /// Names of the files looked up for automatic normal and specular maps so far, whether they exist or not.
+        /// The adjusted subgraph depends on which of them exist.
+        const std::set<std::string>& getAutoMapFiles() const;
+
         virtual void apply(osg::Node& node);
 
         virtual void apply(osg::Drawable& drawable);
@@ -68,6 +74,8 @@ namespace Shader
         bool mAutoUseSpecularMaps;
         std::string mSpecularMapPattern;
 
+        std::set<std::string> mAutoMapFiles;
+
         ShaderManager& mShaderManager;
         Resource::ImageManager& mImageManager;
 
@@ -98,6 +106,8 @@ namespace Shader
         std::string mDefaultVsTemplate;
         std::string mDefaultFsTemplate;
 
+        bool autoMapExists(const std::string& fileName);
+
         void createProgram(const ShaderRequirements& reqs);
         bool adjustGeometry(osg::Geometry& sourceGeometry, const ShaderRequirements& reqs);
     };
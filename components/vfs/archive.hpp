@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_RESOURCE_ARCHIVE_H
 
 #include <map>
+#include <string>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -14,6 +15,11 @@ namespace VFS
         virtual ~File() {}
 
         virtual Files::IStreamPtr open() = 0;
+
+        /// Get a string that changes whenever the contents of the file may have changed, made of where the file
+        /// is stored, its size and its modification time. Used to detect stale data in caches derived from the file.
+        /// @return Empty if not known.
+        virtual std::string getStamp() const { return std::string(); }
     };
 
     class Archive
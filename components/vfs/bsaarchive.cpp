@@ -1,12 +1,16 @@
 #include "bsaarchive.hpp"
 
+#include <sstream>
+
+#include <boost/filesystem/operations.hpp>
+
 namespace VFS
 {
 
 
-BsaArchive::BsaArchive(const std::string &filename)
+BsaArchive::BsaArchive(const std::string &filename, bool memoryMapped)
 {
-    mFile.open(filename);
+    mFile.open(filename, memoryMapped);
 
     const Bsa::BSAFile::FileList &filelist = mFile.getList();
     for(Bsa::BSAFile::FileList::const_iterator it = filelist.begin();it != filelist.end();++it)
@@ -40,4 +44,17 @@ Files::IStreamPtr BsaArchiveFile::open()
     return mFile->getFile(mInfo);
 }
 
+std::string BsaArchiveFile::getStamp() const
+{
+    // the archive has to change for any of its files to change
+    boost::system::error_code ec;
+    std::time_t time = boost::filesystem::last_write_time(mFile->getFilename(), ec);
+    if (ec)
+        return std::string();
+
+    std::ostringstream stream;
+    stream << mFile->getFilename() << ":" << mInfo->offset << ":" << mInfo->fileSize << ":" << time;
+    return stream.str();
+}
+
 }
@@ -15,6 +15,8 @@ namespace VFS
 
         virtual Files::IStreamPtr open();
 
+        virtual std::string getStamp() const;
+
         const Bsa::BSAFile::FileStruct* mInfo;
         Bsa::BSAFile* mFile;
     };
@@ -22,7 +24,8 @@ namespace VFS
     class BsaArchive : public Archive
     {
     public:
-        BsaArchive(const std::string& filename);
+        /// @param memoryMapped Map the archive into memory, see Bsa::BSAFile::open().
+        BsaArchive(const std::string& filename, bool memoryMapped=false);
 
         virtual void listResources(std::map<std::string, File*>& out, char (*normalize_function) (char));
 
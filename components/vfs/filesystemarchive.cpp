@@ -1,6 +1,7 @@
 #include "filesystemarchive.hpp"
 
 #include <iostream>
+#include <sstream>
 
 #include <boost/filesystem.hpp>
 
@@ -65,4 +66,19 @@ namespace VFS
         return Files::openConstrainedFileStream(mPath.c_str());
     }
 
+    std::string FileSystemArchiveFile::getStamp() const
+    {
+        boost::system::error_code ec;
+        boost::uintmax_t size = boost::filesystem::file_size(mPath, ec);
+        if (ec)
+            return std::string();
+        std::time_t time = boost::filesystem::last_write_time(mPath, ec);
+        if (ec)
+            return std::string();
+
+        std::ostringstream stream;
+        stream << mPath << ":" << size << ":" << time;
+        return stream.str();
+    }
+
 }
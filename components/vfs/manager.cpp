@@ -26,6 +26,37 @@ namespace
         std::transform(path.begin(), path.end(), path.begin(), normalize_char);
     }
 
+    char identity_char(char ch)
+    {
+        return ch;
+    }
+
+    // FNV-1a over the normalized characters, so that hashing an unnormalized name does not need a temporary copy
+    template <char (*normalize_char)(char)>
+    std::size_t hash_path(const char* path, std::size_t length)
+    {
+        std::size_t hash = static_cast<std::size_t>(2166136261u);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<unsigned char>(normalize_char(path[i]));
+            hash *= static_cast<std::size_t>(16777619u);
+        }
+        return hash;
+    }
+
+    template <char (*normalize_char)(char)>
+    bool equal_path(const char* path, std::size_t length, const std::string& normalized)
+    {
+        if (normalized.size() != length)
+            return false;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            if (normalize_char(path[i]) != normalized[i])
+                return false;
+        }
+        return true;
+    }
+
 }
 
 namespace VFS
@@ -33,6 +64,7 @@ namespace VFS
 
     Manager::Manager(bool strict)
         : mStrict(strict)
+        , mHashMask(0)
     {
 
     }
@@ -45,6 +77,8 @@ namespace VFS
     void Manager::reset()
     {
         mIndex.clear();
+        mHashIndex.clear();
+        mHashMask = 0;
         for (std::vector<Archive*>::iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             delete *it;
         mArchives.clear();
@@ -61,30 +95,100 @@ namespace VFS
 
         for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+
+        buildHashIndex();
+    }
+
+    void Manager::buildHashIndex()
+    {
+        std::size_t size = 16;
+        while (size < mIndex.size() + mIndex.size() / 2)
+            size *= 2;
+
+        mHashIndex.assign(size, HashEntry());
+        mHashMask = size - 1;
+
+        for (std::map<std::string, File*>::const_iterator it = mIndex.begin(); it != mIndex.end(); ++it)
+        {
+            std::size_t hash = hash_path<identity_char>(it->first.c_str(), it->first.size());
+            std::size_t slot = hash & mHashMask;
+            while (mHashIndex[slot].mName)
+                slot = (slot + 1) & mHashMask;
+
+            HashEntry& entry = mHashIndex[slot];
+            entry.mHash = hash;
+            entry.mName = &it->first;
+            entry.mFile = it->second;
+        }
+    }
+
+    File* Manager::lookup(const char *name, std::size_t length, bool normalized) const
+    {
+        if (mHashIndex.empty())
+            return NULL;
+
+        if (normalized)
+            return lookup<identity_char>(name, length);
+        else if (mStrict)
+            return lookup<strict_normalize_char>(name, length);
+        else
+            return lookup<nonstrict_normalize_char>(name, length);
+    }
+
+    template <char (*normalize_char)(char)>
+    File* Manager::lookup(const char *name, std::size_t length) const
+    {
+        std::size_t hash = hash_path<normalize_char>(name, length);
+        for (std::size_t slot = hash & mHashMask; mHashIndex[slot].mName; slot = (slot + 1) & mHashMask)
+        {
+            const HashEntry& entry = mHashIndex[slot];
+            if (entry.mHash == hash && equal_path<normalize_char>(name, length, *entry.mName))
+                return entry.mFile;
+        }
+        return NULL;
     }
 
     Files::IStreamPtr Manager::get(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        return get(name.c_str(), name.size());
+    }
 
-        return getNormalized(normalized);
+    Files::IStreamPtr Manager::get(const char *name, std::size_t length) const
+    {
+        File* file = lookup(name, length, false);
+        if (!file)
+        {
+            std::string normalized (name, length);
+            normalize_path(normalized, mStrict);
+            throw std::runtime_error("Resource '" + normalized + "' not found");
+        }
+        return file->open();
     }
 
     Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
+        File* file = lookup(normalizedName.c_str(), normalizedName.size(), true);
+        if (!file)
             throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return file->open();
     }
 
     bool Manager::exists(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
+        return lookup(name.c_str(), name.size(), false) != NULL;
+    }
+
+    bool Manager::exists(const char *name, std::size_t length) const
+    {
+        return lookup(name, length, false) != NULL;
+    }
 
-        return mIndex.find(normalized) != mIndex.end();
+    std::string Manager::getStamp(const std::string &normalizedName) const
+    {
+        File* file = lookup(normalizedName.c_str(), normalizedName.size(), true);
+        if (!file)
+            return std::string();
+        return file->getStamp();
     }
 
     const std::map<std::string, File*>& Manager::getIndex() const
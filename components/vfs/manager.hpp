@@ -3,6 +3,7 @@
 
 #include <components/files/constrainedfilestream.hpp>
 
+#include <cstddef>
 #include <vector>
 #include <map>
 
@@ -40,6 +41,11 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         bool exists(const std::string& name) const;
 
+        /// Does a file with this name exist? The name does not need to be normalized or null-terminated.
+        /// @note Does not allocate memory.
+        /// @note May be called from any thread once the index has been built.
+        bool exists(const char* name, std::size_t length) const;
+
         /// Get a complete list of files from all archives
         /// @note May be called from any thread once the index has been built.
         const std::map<std::string, File*>& getIndex() const;
@@ -53,17 +59,56 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         Files::IStreamPtr get(const std::string& name) const;
 
+        /// Retrieve a file by name. The name does not need to be normalized or null-terminated.
+        /// @note Throws an exception if the file can not be found.
+        /// @note May be called from any thread once the index has been built.
+        Files::IStreamPtr get(const char* name, std::size_t length) const;
+
         /// Retrieve a file by name (name is already normalized).
         /// @note Throws an exception if the file can not be found.
         /// @note May be called from any thread once the index has been built.
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
+        /// Get the stamp of a file (name is already normalized), see File::getStamp().
+        /// @return Empty if the file does not exist or its stamp is not known.
+        /// @note May be called from any thread once the index has been built.
+        std::string getStamp(const std::string& normalizedName) const;
+
     private:
+        /// Look up a file in the hash index, normalizing the name on the fly unless it is already normalized.
+        /// @return NULL if the file does not exist.
+        File* lookup(const char* name, std::size_t length, bool normalized) const;
+
+        template <char (*normalize_char)(char)>
+        File* lookup(const char* name, std::size_t length) const;
+
+        void buildHashIndex();
+
         bool mStrict;
 
         std::vector<Archive*> mArchives;
 
+        /// Sorted index, used for listing files.
         std::map<std::string, File*> mIndex;
+
+        struct HashEntry
+        {
+            HashEntry()
+                : mHash(0)
+                , mName(NULL)
+                , mFile(NULL)
+            {
+            }
+
+            std::size_t mHash;
+            const std::string* mName; ///< Points to the key in mIndex, NULL if the slot is empty.
+            File* mFile;
+        };
+
+        /// Open-addressing hash table with linear probing over the entries of mIndex, used for lookups by name.
+        /// The size is a power of two and at least one and a half times the number of files.
+        std::vector<HashEntry> mHashIndex;
+        std::size_t mHashMask;
     };
 
 }